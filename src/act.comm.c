@@ -584,7 +584,7 @@ void free_hist_messg(struct descriptor_data *d)
     tmp = tmp->next;
     if (ftmp->text)
       free(ftmp->text);
-    free(ftmp);
+    SLAB_FREE(ftmp);
   }
   d->comms = NULL;
 }
@@ -594,13 +594,13 @@ void new_hist_messg(struct descriptor_data *d, const char *msg)
   struct txt_block *tmp = d->comms;
   int l = 0;
   if (!tmp) {
-    CREATE(d->comms, struct txt_block, 1);
+    SLAB_CREATE(d->comms, struct txt_block, SLAB_TXT);
     d->comms->text = strdup(msg);
     return;
   }
   while (tmp->next)
     tmp = tmp->next;
-  CREATE(tmp->next, struct txt_block, 1);
+  SLAB_CREATE(tmp->next, struct txt_block, SLAB_TXT);
   tmp->next->text = strdup(msg);
   
   for (tmp = d->comms; tmp ; tmp= tmp->next)
@@ -611,7 +611,7 @@ void new_hist_messg(struct descriptor_data *d, const char *msg)
     d->comms = tmp->next;
     if (tmp->text)
       free(tmp->text);
-    free(tmp);
+    SLAB_FREE(tmp);
   }
 }
 
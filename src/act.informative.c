@@ -1500,8 +1500,8 @@ void print_object_location(int num, struct obj_data *obj, struct char_data *ch,
   if (obj->proto_script)
     send_to_char(ch, "[TRIG]");
 
-  if (IN_ROOM(obj) != NOWHERE)
-    send_to_char(ch, "[%5d] %s%s\r\n", GET_ROOM_VNUM(IN_ROOM(obj)), world[IN_ROOM(obj)].name, QNRM);
+  if (OBJ_IN_ROOM(obj) != NOWHERE)
+    send_to_char(ch, "[%5d] %s%s\r\n", GET_ROOM_VNUM(OBJ_IN_ROOM(obj)), world[OBJ_IN_ROOM(obj)].name, QNRM);
   else if (obj->carried_by)
     send_to_char(ch, "carried by %s%s\r\n", PERS(obj->carried_by, ch), QNRM);
   else if (obj->worn_by)
@@ -67,7 +67,7 @@ void perform_put(struct char_data *ch, struct obj_data *obj,
 
   if (GET_OBJ_WEIGHT(cont) + GET_OBJ_WEIGHT(obj) > GET_OBJ_VAL(cont, 0))
     act("$p won't fit in $P.", FALSE, ch, obj, cont, TO_CHAR);
-  else if (OBJ_FLAGGED(obj, ITEM_NODROP) && IN_ROOM(cont) != NOWHERE)
+  else if (OBJ_FLAGGED(obj, ITEM_NODROP) && OBJ_IN_ROOM(cont) != NOWHERE)
     act("You can't get $p out of your hand.", FALSE, ch, obj, NULL, TO_CHAR);
   else {
     obj_from_char(obj);
@@ -758,7 +758,7 @@ void weight_change_object(struct obj_data *obj, int weight)
   struct obj_data *tmp_obj;
   struct char_data *tmp_ch;
 
-  if (IN_ROOM(obj) != NOWHERE) {
+  if (OBJ_IN_ROOM(obj) != NOWHERE) {
     GET_OBJ_WEIGHT(obj) += weight;
   } else if ((tmp_ch = obj->carried_by)) {
     obj_from_char(obj);
@@ -356,6 +356,8 @@ void do_doorcmd(struct char_data *ch, struct obj_data *obj, int door, int scmd)
     OPEN_DOOR(IN_ROOM(ch), obj, door);
     if (back)
       OPEN_DOOR(other_room, obj, rev_dir[door]);
+    if (!obj)
+      path_doors_changed();
     send_to_char(ch, "%s", CONFIG_OK);
     break;
 
@@ -363,6 +365,8 @@ void do_doorcmd(struct char_data *ch, struct obj_data *obj, int door, int scmd)
     CLOSE_DOOR(IN_ROOM(ch), obj, door);
     if (back)
       CLOSE_DOOR(other_room, obj, rev_dir[door]);
+    if (!obj)
+      path_doors_changed();
     send_to_char(ch, "%s", CONFIG_OK);
     break;
 
@@ -393,7 +397,7 @@ void do_doorcmd(struct char_data *ch, struct obj_data *obj, int door, int scmd)
   if (len < sizeof(buf))
     snprintf(buf + len, sizeof(buf) - len, "%s%s.",
 	obj ? "" : "the ", obj ? "$p" : EXIT(ch, door)->keyword ? "$F" : "door");
-  if (!obj || IN_ROOM(obj) != NOWHERE)
+  if (!obj || OBJ_IN_ROOM(obj) != NOWHERE)
     act(buf, FALSE, ch, obj, obj ? 0 : EXIT(ch, door)->keyword, TO_ROOM);
 
   /* Notify the other room */
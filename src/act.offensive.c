@@ -131,7 +131,7 @@ ACMD(do_slow){
   char arg[MAX_INPUT_LENGTH];
   struct char_data *vict;
   int percent, prob;
-  struct affected_type *af;
+  struct affected_type af[1];
 
   one_argument(argument, arg);
 
@@ -171,7 +171,7 @@ ACMD(do_slow){
     af->modifier = -1;
     af->location = APPLY_SPEED; 
     af->bitvector = AFF_SLOW;
-    affect_to_char(ch, &af);
+    affect_to_char(ch, af);
   }
 
   WAIT_STATE(ch, 2 * PULSE_VIOLENCE);
@@ -68,8 +68,10 @@ ACMD(do_reload)
 {
   struct affected_type af;
 
-  if (AFF_FLAGGED(ch, AFF_RELOAD))
+  if (AFF_FLAGGED(ch, AFF_RELOAD)) {
     send_to_char(ch, "You are already reloading!\r\n");
+    return;
+  }
 
   send_to_char(ch, "You are reloading...\r\n");
   act("$n begins reloading.", FALSE, ch, 0, 0, TO_ROOM);
@@ -203,6 +205,7 @@ ACMD(do_hide)
     return;
 
   SET_BIT(AFF_FLAGS(ch), AFF_HIDE);
+  room_census_dirty(IN_ROOM(ch));
 }
 
 
@@ -36,6 +36,7 @@ extern int buf_switches, buf_largecount, buf_overflows;
 extern int top_of_p_table;
 extern socket_t mother_desc;
 extern ush_int port;
+extern unsigned long zone_reset_slices;
 
 /* for chars */
 extern const char *pc_class_types[];
@@ -51,6 +52,8 @@ void roll_real_abils(struct char_data *ch);
 int parse_class(char arg);
 void run_autowiz(void);
 int save_all(void);
+void queue_save_all(void);
+void flush_olc_saves(void);
 extern zone_rnum real_zone_by_thing(room_vnum vznum); /* added for zone_checker */
 SPECIAL(shop_keeper);
 void Crash_rentsave(struct char_data * ch, int cost);
@@ -98,6 +101,8 @@ ACMD(do_wiznet);
 ACMD(do_zreset);
 ACMD(do_wizutil);
 size_t print_zone_to_buf(char *bufptr, size_t left, zone_rnum zone, int listall);
+int reset_time_compare(const void *a, const void *b);
+void show_reset_times(struct char_data *ch, char *value);
 ACMD(do_show);
 ACMD(do_set);
 void snoop_check(struct char_data *ch);
@@ -229,8 +234,8 @@ room_rnum find_target_room(struct char_data *ch, char *rawroomstr)
         return (NOWHERE);
       }
     } else if ((target_obj = get_obj_vis(ch, mobobjstr, &num)) != NULL) {
-      if (IN_ROOM(target_obj) != NOWHERE)
-        location = IN_ROOM(target_obj);
+      if (OBJ_IN_ROOM(target_obj) != NOWHERE)
+        location = OBJ_IN_ROOM(target_obj);
       else if (target_obj->carried_by && IN_ROOM(target_obj->carried_by) != NOWHERE)
         location = IN_ROOM(target_obj->carried_by);
       else if (target_obj->worn_by && IN_ROOM(target_obj->worn_by) != NOWHERE)
@@ -589,6 +594,10 @@ void do_stat_room(struct char_data *ch, struct room_data *rm)
     send_to_char(ch, "%s\r\n", CCNRM(ch, C_NRM));
   }
 
+  sprintbit(room_occupants(rm - world), occupant_bits, buf2, sizeof(buf2));
+  send_to_char(ch, "Census: %d PCs, %d NPCs (%d hidden), %d objects, Occupants: %s\r\n",
+	rm->census.pcs, rm->census.npcs, rm->census.hidden, rm->census.objs, buf2);
+
   send_to_char(ch, "Chars present:%s", CCYEL(ch, C_NRM));
   column = 14;	/* ^^^ strlen ^^^ */
   for (found = FALSE, k = rm->people; k; k = k->next_in_room) {
@@ -696,8 +705,8 @@ void do_stat_object(struct char_data *ch, struct obj_data *j)
   send_to_char(ch, "Weight: %d, Value: %d, Cost/day: %d, Timer: %d, Min level: %d\r\n",
      GET_OBJ_WEIGHT(j), GET_OBJ_COST(j), GET_OBJ_RENT(j), GET_OBJ_TIMER(j), GET_OBJ_LEVEL(j));
 
-  send_to_char(ch, "In room: %d (%s), ", GET_ROOM_VNUM(IN_ROOM(j)),
-	IN_ROOM(j) == NOWHERE ? "Nowhere" : world[IN_ROOM(j)].name);
+  send_to_char(ch, "In room: %d (%s), ", GET_ROOM_VNUM(OBJ_IN_ROOM(j)),
+	OBJ_IN_ROOM(j) == NOWHERE ? "Nowhere" : world[OBJ_IN_ROOM(j)].name);
 
   /*
    * NOTE: In order to make it this far, we must already be able to see the
@@ -945,7 +954,7 @@ void do_stat_character(struct char_data *ch, struct char_data *k)
   /* Routine to show what spells a char is affected by */
   if (k->affected) {
     for (aff = k->affected; aff; aff = aff->next) {
-      send_to_char(ch, "SPL: (%3dhr) %s%-21s%s ", aff->duration + 1, CCCYN(ch, C_NRM), skill_name(aff->type), CCNRM(ch, C_NRM));
+      send_to_char(ch, "SPL: (%3dhr) %s%-21s%s ", affect_duration(aff) + 1, CCCYN(ch, C_NRM), skill_name(aff->type), CCNRM(ch, C_NRM));
 
       if (aff->modifier)
 	send_to_char(ch, "%+d to %s", aff->modifier, apply_types[(int) aff->location]);
@@ -1063,7 +1072,7 @@ ACMD(do_stat)
     else if ((victim = get_player_vis(ch, buf2, NULL, FIND_CHAR_WORLD)) != NULL)
 	do_stat_character(ch, victim);
     else {
-      CREATE(victim, struct char_data, 1);
+      SLAB_CREATE(victim, struct char_data, SLAB_CHAR);
       clear_char(victim);
       CREATE(victim->player_specials, struct player_special_data, 1);
       if (load_char(buf2, victim) >= 0) {
@@ -1273,6 +1282,7 @@ ACMD(do_switch)
 
     victim->desc = ch->desc;
     ch->desc = NULL;
+    room_census_dirty(IN_ROOM(victim));
   }
 }
 
@@ -1610,6 +1620,7 @@ ACMD(do_restore)
   else {
     GET_HIT(vict) = GET_MAX_HIT(vict);
     GET_MANA(vict) = GET_MAX_MANA(vict);
+    gmcp_hit_changed(vict);
 
     if (!IS_NPC(vict) && GET_LEVEL(ch) >= LVL_GRGOD) {
       if (GET_LEVEL(vict) >= LVL_IMMORT)
@@ -2086,7 +2097,7 @@ ACMD(do_last)
   }
 
   if (*name && !num) {
-    CREATE(vict, struct char_data, 1);
+    SLAB_CREATE(vict, struct char_data, SLAB_CHAR);
     clear_char(vict);
     CREATE(vict->player_specials, struct player_special_data, 1);
     if (load_char(name, vict) <  0) {
@@ -2441,31 +2452,16 @@ size_t print_zone_to_buf(char *bufptr, size_t left, zone_rnum zone, int listall)
     tmp = snprintf(bufptr, left,
 	"%3d %-30.30s%s By: %-10.10s%s Age: %3d; Reset: %3d (%1d); Range: %5d-%5d\r\n",
 	zone_table[zone].number, zone_table[zone].name, KNRM, zone_table[zone].builders, KNRM,
-	zone_table[zone].age, zone_table[zone].lifespan,
+	zone_age(zone), zone_table[zone].lifespan,
 	zone_table[zone].reset_mode,
 	zone_table[zone].bot, zone_table[zone].top);
-        i = j = k = l = m = n = 0;
-        
-        for (i = 0; i < top_of_world; i++)
-          if (world[i].number >= zone_table[zone].bot && world[i].number <= zone_table[zone].top)
-            j++;
-
-        for (i = 0; i < top_of_objt; i++)
-          if (obj_index[i].vnum >= zone_table[zone].bot && obj_index[i].vnum <= zone_table[zone].top)
-            k++;
-        
-        for (i = 0; i < top_of_mobt; i++)
-          if (mob_index[i].vnum >= zone_table[zone].bot && mob_index[i].vnum <= zone_table[zone].top)
-            l++;
+        m = 0;
+        count_zone_contents(zone, &j, &l, &k, &n);
 
         for (i = 0; i<= top_shop; i++)
           if (SHOP_NUM(i) >= zone_table[zone].bot && SHOP_NUM(i) <= zone_table[zone].top)
             m++;        
 
-        for (i = 0; i < top_of_trigt; i++)
-          if (trig_index[i]->vnum >= zone_table[zone].bot && trig_index[i]->vnum <= zone_table[zone].top)
-            n++;
-
 	tmp += snprintf(bufptr + tmp, left - tmp,
                         "       Zone stats:\r\n"
                         "       ---------------\r\n"
@@ -2473,8 +2469,11 @@ size_t print_zone_to_buf(char *bufptr, size_t left, zone_rnum zone, int listall)
                         "         Objects:  %2d\r\n"
                         "         Mobiles:  %2d\r\n"
                         "         Shops:    %2d\r\n"
-                        "         Triggers: %2d\r\n", 
-                          j, k, l, m, n);
+                        "         Triggers: %2d\r\n"
+                        "         Status:   %s, %d players, woken %lu times\r\n",
+                          j, k, l, m, n,
+                          zone_table[zone].hibernating ? "hibernating" : "awake",
+                          zone_table[zone].players, zone_table[zone].wakes);
         
     return tmp;
   } 
@@ -2486,6 +2485,66 @@ size_t print_zone_to_buf(char *bufptr, size_t left, zone_rnum zone, int listall)
 }
 
 
+/* zones that have spent the most time resetting first */
+int reset_time_compare(const void *a, const void *b)
+{
+  const struct zone_data *za = &zone_table[*(const zone_rnum *) a];
+  const struct zone_data *zb = &zone_table[*(const zone_rnum *) b];
+
+  if (za->reset_usec != zb->reset_usec)
+    return (za->reset_usec < zb->reset_usec) ? 1 : -1;
+  return (za->number - zb->number);
+}
+
+/* show resets [<count>] - what zone resets have cost so far */
+void show_reset_times(struct char_data *ch, char *value)
+{
+  char buf[MAX_STRING_LENGTH];
+  zone_rnum *order, i;
+  unsigned long total = 0, count = 0;
+  int shown = 25, n;
+  size_t len, nlen;
+
+  if (*value && is_number(value))
+    shown = MAX(1, atoi(value));
+
+  CREATE(order, zone_rnum, top_of_zone_table + 1);
+  for (i = 0; i <= top_of_zone_table; i++) {
+    order[i] = i;
+    total += zone_table[i].reset_usec;
+    count += zone_table[i].resets;
+  }
+  qsort(order, top_of_zone_table + 1, sizeof(zone_rnum), reset_time_compare);
+
+  len = snprintf(buf, sizeof(buf),
+	"%lu resets, %lu.%03lu ms in all; %lu times a reset was continued on a\r\n"
+	"later pulse (budget: %d zone commands a pulse).\r\n"
+	"Zone Name                           Resets   Total ms  Avg usec  Max usec  Lag avg/max\r\n"
+	"---- ------------------------------ ------ ---------- --------- --------- ------------\r\n",
+	count, total / 1000, total % 1000, zone_reset_slices,
+	CONFIG_ZONE_RESET_BUDGET);
+
+  for (n = 0; n <= top_of_zone_table && n < shown; n++) {
+    struct zone_data *zone = &zone_table[order[n]];
+
+    nlen = snprintf(buf + len, sizeof(buf) - len,
+	"%4d %-30.30s %6lu %6lu.%03lu %9lu %9lu %5lu/%-5lu%s\r\n",
+	zone->number, zone->name, zone->resets,
+	zone->reset_usec / 1000, zone->reset_usec % 1000,
+	zone->resets ? zone->reset_usec / zone->resets : 0,
+	zone->reset_max_usec,
+	zone->auto_resets ? zone->reset_lag / zone->auto_resets : 0,
+	zone->reset_max_lag, zone->reset_waiting ? " *" : "");
+    if (len + nlen >= sizeof(buf))
+      break;
+    len += nlen;
+  }
+
+  free(order);
+  page_string(ch->desc, buf, TRUE);
+}
+
+
 ACMD(do_show)
 {
   int i, j, k, l, con;		/* i, j, k to specifics? */
@@ -2514,6 +2573,17 @@ ACMD(do_show)
     { "shops",		LVL_IMMORT },
     { "houses",		LVL_IMMORT },
     { "snoop",		LVL_IMMORT },			/* 10 */
+    { "scripts",	LVL_GRGOD },
+    { "slabs",		LVL_GRGOD },
+    { "memory",		LVL_GRGOD },
+    { "paths",		LVL_GRGOD },
+    { "resets",		LVL_GRGOD },			/* 15 */
+    { "combat",		LVL_GRGOD },
+    { "random",		LVL_GRGOD },
+    { "timers",		LVL_GRGOD },
+    { "vnums",		LVL_GRGOD },
+    { "sweep",		LVL_GRGOD },			/* 20 */
+    { "input",		LVL_IMMORT },
     { "\n", 0 }
   };
 
@@ -2585,7 +2655,7 @@ ACMD(do_show)
       return;
     }
 
-    CREATE(vict, struct char_data, 1);
+    SLAB_CREATE(vict, struct char_data, SLAB_CHAR);
     clear_char(vict);
     CREATE(vict->player_specials, struct player_special_data, 1);
     if (load_char(value, vict) < 0) {
@@ -2733,6 +2803,51 @@ ACMD(do_show)
       send_to_char(ch, "No one is currently snooping.\r\n");
     break;
 
+  /* show scripts */
+  case 11:
+    script_prof_report(ch, value);
+    break;
+
+  case 12:
+    slab_report(ch, value);
+    break;
+
+  case 13:
+    mem_report(ch, value);
+    break;
+
+  case 14:
+    path_report(ch, value, arg);
+    break;
+
+  case 15:
+    show_reset_times(ch, value);
+    break;
+
+  case 16:
+    combat_report(ch, value, arg);
+    break;
+
+  case 17:
+    rng_report(ch, value, arg);
+    break;
+
+  case 18:
+    timer_report(ch, value, arg);
+    break;
+
+  case 19:
+    vnum_report(ch, value, arg);
+    break;
+
+  case 20:
+    sweep_report(ch, value, arg);
+    break;
+
+  case 21:
+    input_report(ch);
+    break;
+
   /* show what? */
   default:
     send_to_char(ch, "Sorry, I don't understand that.\r\n");
@@ -2894,11 +3009,11 @@ int perform_set(struct char_data *ch, struct char_data *vict, int mode,
     affect_total(vict);
     break;
   case 7:
-    vict->points.hit = RANGE(-9, vict->points.max_hit);
+    GET_HIT(vict) = RANGE(-9, vict->points.max_hit);
     affect_total(vict);
     break;
   case 8:
-    vict->points.mana = RANGE(0, vict->points.max_mana);
+    GET_MANA(vict) = RANGE(0, vict->points.max_mana);
     affect_total(vict);
     break;
   case 10:
@@ -3230,7 +3345,7 @@ ACMD(do_set)
     }
   } else if (is_file) {
     /* try to load the player off disk */
-    CREATE(cbuf, struct char_data, 1);
+    SLAB_CREATE(cbuf, struct char_data, SLAB_CHAR);
     clear_char(cbuf);
     CREATE(cbuf->player_specials, struct player_special_data, 1);
     if ((player_i = load_char(name, cbuf)) > -1) {
@@ -3281,9 +3396,9 @@ ACMD(do_saveall)
  if (GET_LEVEL(ch) < LVL_BUILDER)
     send_to_char (ch, "You are not holy enough to use this privelege.\n\r");
  else {
-    save_all();
+    queue_save_all();
     House_save_all();
-    send_to_char(ch, "World and house files saved.\n\r");
+    send_to_char(ch, "House files saved; world files are being written (see 'olc').\n\r");
  }
 }
 
@@ -3292,7 +3407,7 @@ ACMD(do_links)
   zone_rnum zrnum;
   zone_vnum zvnum;
   room_rnum nr, to_room;
-  int first, last, j;
+  int first, last, v, j;
   char arg[MAX_INPUT_LENGTH];
 
 
@@ -3316,8 +3431,8 @@ ACMD(do_links)
   first = zone_table[zrnum].bot;
 
   send_to_char(ch, "Zone %d is linked to the following zones:\r\n", zvnum);
-  for (nr = 0; nr <= top_of_world && (GET_ROOM_VNUM(nr) <= last); nr++) {
-    if (GET_ROOM_VNUM(nr) >= first) {
+  for (v = first; v <= last; v++) {
+    if ((nr = real_room(v)) != NOWHERE) {
       for (j = 0; j < NUM_OF_DIRS; j++) {
         if (world[nr].dir_option[j]) {
           to_room = world[nr].dir_option[j]->to_room;
@@ -4047,7 +4162,7 @@ ACMD(do_copyover)
 {
   FILE *fp;
   struct descriptor_data *d, *d_next;
-  char buf [100], buf2[100];
+  char buf [100], buf2[100], telnet[MAX_INPUT_LENGTH];
 	
   fp = fopen (COPYOVER_FILE, "w");
     if (!fp) {
@@ -4062,12 +4177,19 @@ ACMD(do_copyover)
     */
    sprintf (buf, "\n\r *** COPYOVER by %s - please remain seated!\n\r", GET_NAME(ch));
 
+   /* let the OLC writer finish and write out what is queued, or it is lost */
+   flush_olc_saves();
+
+   /* the players as they are, before the saves below take them apart */
+   write_copyover_snapshot();
+
    /* write boot_time as first line in file */
    fprintf(fp, "%ld\n", boot_time);
    
    /* For each playing descriptor, save its state */
    for (d = descriptor_list; d ; d = d_next) {
-     struct char_data * och = d->character;
+     /* someone switched into a mob is saved and brought back as themselves */
+     struct char_data * och = d->original ? d->original : d->character;
    /* We delete from the list , so need to save this */
      d_next = d->next;
 
@@ -4076,7 +4198,8 @@ ACMD(do_copyover)
      write_to_descriptor (d->descriptor, "\n\rSorry, we are rebooting. Come back in a few minutes.\n\r");
      close_socket (d); /* throw'em out */
    } else {
-      fprintf (fp, "%d %ld %s %s\n", d->descriptor, GET_PREF(och), GET_NAME(och), d->host);
+      telnet_save(d, telnet, sizeof(telnet));
+      fprintf (fp, "%d %ld %s %s %s\n", d->descriptor, GET_PREF(och), GET_NAME(och), d->host, telnet);
       /* save och */
       Crash_rentsave(och,0);
       save_char(och);
@@ -395,7 +395,7 @@ void fry_victim(struct char_data *ch)
 {
   struct char_data *tch;
 
-  if (ch->points.mana < 10)
+  if (GET_MANA(ch) < 10)
     return;
 
   /* Find someone suitable to fry ! */
@@ -429,7 +429,7 @@ void fry_victim(struct char_data *ch)
     break;
   }
 
-  ch->points.mana -= 10;
+  GET_MANA(ch) -= 10;
 
   return;
 }
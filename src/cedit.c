@@ -151,6 +151,15 @@ void cedit_setup(struct descriptor_data *d)
   OLC_CONFIG(d)->operation.use_new_socials    = CONFIG_NEW_SOCIALS;
   OLC_CONFIG(d)->operation.auto_save_olc      = CONFIG_OLC_SAVE;
   OLC_CONFIG(d)->operation.nameserver_is_slow = CONFIG_NS_IS_SLOW;
+  OLC_CONFIG(d)->operation.script_budget      = CONFIG_SCRIPT_BUDGET;
+  OLC_CONFIG(d)->operation.mem_sample_rate    = CONFIG_MEM_SAMPLE_RATE;
+  OLC_CONFIG(d)->operation.zone_reset_budget  = CONFIG_ZONE_RESET_BUDGET;
+  OLC_CONFIG(d)->operation.dormant_mob_pulses = CONFIG_DORMANT_MOB_PULSES;
+  OLC_CONFIG(d)->operation.hibernate_minutes  = CONFIG_HIBERNATE_MINUTES;
+  OLC_CONFIG(d)->operation.input_byte_rate    = CONFIG_INPUT_BYTE_RATE;
+  OLC_CONFIG(d)->operation.input_line_rate    = CONFIG_INPUT_LINE_RATE;
+  OLC_CONFIG(d)->operation.input_queue_lines  = CONFIG_INPUT_QUEUE_LINES;
+  OLC_CONFIG(d)->operation.input_overflow     = CONFIG_INPUT_OVERFLOW;
   
   /****************************************************************************/
   /** Autowiz                                                                **/
@@ -221,6 +230,8 @@ void cedit_save_internally(struct descriptor_data *d)
   CONFIG_IDLE_MAX_LEVEL      = OLC_CONFIG(d)->play.idle_max_level;
   CONFIG_DTS_ARE_DUMPS       = OLC_CONFIG(d)->play.dts_are_dumps;
   CONFIG_LOAD_INVENTORY = OLC_CONFIG(d)->play.load_into_inventory;
+  if (CONFIG_TRACK_T_DOORS != OLC_CONFIG(d)->play.track_through_doors)
+    path_doors_changed();
   CONFIG_TRACK_T_DOORS = OLC_CONFIG(d)->play.track_through_doors;
   CONFIG_IMMORT_LEVEL_OK     = OLC_CONFIG(d)->play.immort_level_ok;
   
@@ -256,6 +267,15 @@ void cedit_save_internally(struct descriptor_data *d)
   CONFIG_NEW_SOCIALS        = OLC_CONFIG(d)->operation.use_new_socials;  
   CONFIG_NS_IS_SLOW = OLC_CONFIG(d)->operation.nameserver_is_slow;
   CONFIG_OLC_SAVE           = OLC_CONFIG(d)->operation.auto_save_olc;
+  CONFIG_SCRIPT_BUDGET      = OLC_CONFIG(d)->operation.script_budget;
+  CONFIG_MEM_SAMPLE_RATE    = OLC_CONFIG(d)->operation.mem_sample_rate;
+  CONFIG_ZONE_RESET_BUDGET  = OLC_CONFIG(d)->operation.zone_reset_budget;
+  CONFIG_DORMANT_MOB_PULSES = OLC_CONFIG(d)->operation.dormant_mob_pulses;
+  CONFIG_HIBERNATE_MINUTES  = OLC_CONFIG(d)->operation.hibernate_minutes;
+  CONFIG_INPUT_BYTE_RATE    = OLC_CONFIG(d)->operation.input_byte_rate;
+  CONFIG_INPUT_LINE_RATE    = OLC_CONFIG(d)->operation.input_line_rate;
+  CONFIG_INPUT_QUEUE_LINES  = OLC_CONFIG(d)->operation.input_queue_lines;
+  CONFIG_INPUT_OVERFLOW     = OLC_CONFIG(d)->operation.input_overflow;
   
   /****************************************************************************/
   /** Autowiz                                                                **/
@@ -527,6 +547,47 @@ int save_config( IDXTYPE nowhere )
               "auto_save_olc = %d\n\n",
               CONFIG_OLC_SAVE);
 
+  fprintf(fl, "* Microseconds of script time per pulse before random and time\n"
+              "* triggers are deferred to later pulses, 0 to never defer.\n"
+              "script_budget = %d\n\n",
+              CONFIG_SCRIPT_BUDGET);
+
+  fprintf(fl, "* Average bytes allocated between allocation tracker samples,\n"
+              "* 0 to only count calls per call site.\n"
+              "mem_sample_rate = %d\n\n",
+              CONFIG_MEM_SAMPLE_RATE);
+
+  fprintf(fl, "* Zone commands a queued zone reset may run each pulse,\n"
+              "* 0 to reset each zone all at once.\n"
+              "zone_reset_budget = %d\n\n",
+              CONFIG_ZONE_RESET_BUDGET);
+
+  fprintf(fl, "* Mobile pulses between turns for mobs in zones without players,\n"
+              "* 1 for every pulse, 0 for never.\n"
+              "dormant_mob_pulses = %d\n\n",
+              CONFIG_DORMANT_MOB_PULSES);
+
+  fprintf(fl, "* Minutes a zone is empty before it hibernates, 0 for never.\n"
+              "hibernate_minutes = %d\n\n",
+              CONFIG_HIBERNATE_MINUTES);
+
+  fprintf(fl, "* Bytes read from a connection per second, 0 for no limit.\n"
+              "input_byte_rate = %d\n\n",
+              CONFIG_INPUT_BYTE_RATE);
+
+  fprintf(fl, "* Lines run from a connection per second, 0 for no limit.\n"
+              "input_line_rate = %d\n\n",
+              CONFIG_INPUT_LINE_RATE);
+
+  fprintf(fl, "* Lines a connection may have waiting to be run.\n"
+              "input_queue_lines = %d\n\n",
+              CONFIG_INPUT_QUEUE_LINES);
+
+  fprintf(fl, "* When that is full: 0 drops the new line, 1 the oldest line,\n"
+              "* 2 closes the connection.\n"
+              "input_overflow = %d\n\n",
+              CONFIG_INPUT_OVERFLOW);
+
   if (CONFIG_MENU) {
     strcpy(buf, CONFIG_MENU);
     strip_cr(buf);
@@ -741,6 +802,15 @@ void cedit_disp_operation_options(struct descriptor_data *d)
   	"%sL%s) Main Menu           : \r\n%s%s\r\n"
   	"%sM%s) Welcome Message     : \r\n%s%s\r\n"
   	"%sN%s) Start Message       : \r\n%s%s\r\n"
+  	"%sO%s) Script usecs per pulse : %s%d\r\n"
+  	"%sP%s) Memory sample rate  : %s%d\r\n"
+  	"%sR%s) Zone cmds per pulse : %s%d\r\n"
+  	"%sS%s) Dormant mob pulses  : %s%d\r\n"
+  	"%sT%s) Hibernate minutes   : %s%d\r\n"
+  	"%sU%s) Input bytes per sec : %s%d\r\n"
+  	"%sV%s) Input lines per sec : %s%d\r\n"
+  	"%sW%s) Input lines queued  : %s%d\r\n"
+  	"%sX%s) Input overflow      : %s%s\r\n"
     "%sQ%s) Exit To The Main Menu\r\n"
     "Enter your choice : ",
     grn, nrm, cyn, OLC_CONFIG(d)->operation.DFLT_PORT,
@@ -757,6 +827,15 @@ void cedit_disp_operation_options(struct descriptor_data *d)
     grn, nrm, cyn, OLC_CONFIG(d)->operation.MENU ? OLC_CONFIG(d)->operation.MENU : "<None>",
     grn, nrm, cyn, OLC_CONFIG(d)->operation.WELC_MESSG ? OLC_CONFIG(d)->operation.WELC_MESSG : "<None>",
     grn, nrm, cyn, OLC_CONFIG(d)->operation.START_MESSG ? OLC_CONFIG(d)->operation.START_MESSG : "<None>",
+    grn, nrm, cyn, OLC_CONFIG(d)->operation.script_budget,
+    grn, nrm, cyn, OLC_CONFIG(d)->operation.mem_sample_rate,
+    grn, nrm, cyn, OLC_CONFIG(d)->operation.zone_reset_budget,
+    grn, nrm, cyn, OLC_CONFIG(d)->operation.dormant_mob_pulses,
+    grn, nrm, cyn, OLC_CONFIG(d)->operation.hibernate_minutes,
+    grn, nrm, cyn, OLC_CONFIG(d)->operation.input_byte_rate,
+    grn, nrm, cyn, OLC_CONFIG(d)->operation.input_line_rate,
+    grn, nrm, cyn, OLC_CONFIG(d)->operation.input_queue_lines,
+    grn, nrm, cyn, input_overflow_types[OLC_CONFIG(d)->operation.input_overflow],
     grn, nrm
     );
   
@@ -1205,7 +1284,62 @@ void cedit_parse(struct descriptor_data *d, char *arg)
            
            string_write(d, &OLC_CONFIG(d)->operation.START_MESSG, MAX_INPUT_LENGTH, 0, oldtext);
            return;
-         
+
+         case 'o':
+         case 'O':
+           write_to_output(d, "Enter the script time allowed per pulse in microseconds (0 for no limit) : ");
+           OLC_MODE(d) = CEDIT_SCRIPT_BUDGET;
+           return;
+
+         case 'p':
+         case 'P':
+           write_to_output(d, "Enter the average bytes between memory samples (0 for none) : ");
+           OLC_MODE(d) = CEDIT_MEM_SAMPLE_RATE;
+           return;
+
+         case 'r':
+         case 'R':
+           write_to_output(d, "Enter the zone commands a zone reset may run per pulse (0 for no limit) : ");
+           OLC_MODE(d) = CEDIT_ZONE_RESET_BUDGET;
+           return;
+
+         case 's':
+         case 'S':
+           write_to_output(d, "Enter how many mobile pulses mobs in empty zones wait between turns (0 for never) : ");
+           OLC_MODE(d) = CEDIT_DORMANT_MOB_PULSES;
+           return;
+
+         case 't':
+         case 'T':
+           write_to_output(d, "Enter the minutes a zone must be empty before it hibernates (0 for never) : ");
+           OLC_MODE(d) = CEDIT_HIBERNATE_MINUTES;
+           return;
+
+         case 'u':
+         case 'U':
+           write_to_output(d, "Enter the bytes read from a connection per second (0 for no limit) : ");
+           OLC_MODE(d) = CEDIT_INPUT_BYTE_RATE;
+           return;
+
+         case 'v':
+         case 'V':
+           write_to_output(d, "Enter the lines run from a connection per second (0 for no limit) : ");
+           OLC_MODE(d) = CEDIT_INPUT_LINE_RATE;
+           return;
+
+         case 'w':
+         case 'W':
+           write_to_output(d, "Enter the lines a connection may have waiting : ");
+           OLC_MODE(d) = CEDIT_INPUT_QUEUE_LINES;
+           return;
+
+         case 'x':
+         case 'X':
+           write_to_output(d, "0) Drop the new line\r\n1) Drop the oldest line\r\n2) Disconnect\r\n"
+                              "What to do when a connection's input is full : ");
+           OLC_MODE(d) = CEDIT_INPUT_OVERFLOW;
+           return;
+
          case 'q':
          case 'Q':
            cedit_disp_menu(d);
@@ -1634,6 +1768,69 @@ void cedit_parse(struct descriptor_data *d, char *arg)
       cedit_disp_operation_options(d);
       break;
 
+/*-------------------------------------------------------------------*/
+
+    case CEDIT_SCRIPT_BUDGET:
+      OLC_CONFIG(d)->operation.script_budget = MAX(0, atoi(arg));
+      cedit_disp_operation_options(d);
+      break;
+
+/*-------------------------------------------------------------------*/
+
+    case CEDIT_MEM_SAMPLE_RATE:
+      OLC_CONFIG(d)->operation.mem_sample_rate = MAX(0, atoi(arg));
+      cedit_disp_operation_options(d);
+      break;
+
+/*-------------------------------------------------------------------*/
+
+    case CEDIT_ZONE_RESET_BUDGET:
+      OLC_CONFIG(d)->operation.zone_reset_budget = MAX(0, atoi(arg));
+      cedit_disp_operation_options(d);
+      break;
+
+/*-------------------------------------------------------------------*/
+
+    case CEDIT_DORMANT_MOB_PULSES:
+      OLC_CONFIG(d)->operation.dormant_mob_pulses = MAX(0, atoi(arg));
+      cedit_disp_operation_options(d);
+      break;
+
+/*-------------------------------------------------------------------*/
+
+    case CEDIT_HIBERNATE_MINUTES:
+      OLC_CONFIG(d)->operation.hibernate_minutes = MAX(0, atoi(arg));
+      cedit_disp_operation_options(d);
+      break;
+
+/*-------------------------------------------------------------------*/
+
+    case CEDIT_INPUT_BYTE_RATE:
+      OLC_CONFIG(d)->operation.input_byte_rate = MAX(0, atoi(arg));
+      cedit_disp_operation_options(d);
+      break;
+
+/*-------------------------------------------------------------------*/
+
+    case CEDIT_INPUT_LINE_RATE:
+      OLC_CONFIG(d)->operation.input_line_rate = MAX(0, atoi(arg));
+      cedit_disp_operation_options(d);
+      break;
+
+/*-------------------------------------------------------------------*/
+
+    case CEDIT_INPUT_QUEUE_LINES:
+      OLC_CONFIG(d)->operation.input_queue_lines = MAX(1, atoi(arg));
+      cedit_disp_operation_options(d);
+      break;
+
+/*-------------------------------------------------------------------*/
+
+    case CEDIT_INPUT_OVERFLOW:
+      OLC_CONFIG(d)->operation.input_overflow = LIMIT(atoi(arg), 0, NUM_INPUT_OVERFLOW - 1);
+      cedit_disp_operation_options(d);
+      break;
+
 /*-------------------------------------------------------------------*/
 
     case CEDIT_MIN_WIZLIST_LEV:
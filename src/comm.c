@@ -85,13 +85,17 @@ extern int circle_restrict;
 extern int mini_mud;
 extern int no_rent_check;
 extern int *cmd_sort_info;
+extern unsigned long timer_hours;
+extern unsigned long script_pulse_usec;	/* In dg_scripts.c */
 
 extern struct time_info_data time_info;		/* In db.c */
+extern const char *input_overflow_types[];	/* In constants.c */
 extern char *help;
 
 /* local globals */
 struct descriptor_data *descriptor_list = NULL;		/* master desc list */
 struct txt_block *bufpool = 0;	/* pool of large output buffers */
+struct txt_block *inpool = NULL;	/* pool of input ring buffers */
 int buf_largecount = 0;		/* # of large buffers which exist */
 int buf_overflows = 0;		/* # of overflows of output */
 int buf_switches = 0;		/* # of switches from small to large buf */
@@ -101,6 +105,7 @@ int no_specials = 0;		/* Suppress ass. of special routines */
 int max_players = 0;		/* max descriptors available */
 int tics_passed = 0;			/* for extern checkpointing */
 int scheck = 0;			/* for syntax checking mode */
+unsigned long boot_seed = 0;	/* -R: replay with this random seed */
 struct timeval null_time;	/* zero-valued time structure */
 byte reread_wizlist;		/* signal: SIGUSR1 */
 byte emergency_unban;		/* signal: SIGUSR2 */
@@ -124,6 +129,8 @@ void echo_off(struct descriptor_data *d);
 void echo_on(struct descriptor_data *d);
 void circle_sleep(struct timeval *timeout);
 int get_from_q(struct txt_q *queue, char *dest, int *aliased);
+static int get_from_input(struct descriptor_data *d, char *dest, int *aliased);
+static void free_input_ring(struct input_ring *r);
 void init_game(ush_int port);
 void signal_setup(void);
 void game_loop(socket_t mother_desc);
@@ -164,6 +171,7 @@ void free_hist_messg(struct descriptor_data *d);
 void reboot_wizlists(void);
 void boot_world(void);
 void affect_update(void);	/* In magic.c */
+void olc_save_pulse(void);	/* In genolc.c */
 void mobile_activity(void);
 void perform_violence(void);
 void show_string(struct descriptor_data *d, char *input);
@@ -316,12 +324,23 @@ int main(int argc, char **argv)
       no_specials = 1;
       puts("Suppressing assignment of special routines.");
       break;
+    case 'R':
+      if (*(argv[pos] + 2))
+	boot_seed = strtoul(argv[pos] + 2, NULL, 10);
+      else if (++pos < argc)
+	boot_seed = strtoul(argv[pos], NULL, 10);
+      if (!boot_seed) {
+	puts("SYSERR: Non-zero random seed expected after option -R.");
+	exit(1);
+      }
+      printf("Seeding random numbers with %lu.\n", boot_seed);
+      break;
     case 'h':
       /* From: Anil Mahajan <amahajan@proxicom.com> */
       /* Do NOT use -C, this is the copyover mode and without
        * the proper copyover.dat file, the game will go nuts!
        * -spl */
-      printf("Usage: %s [-c] [-m] [-q] [-r] [-s] [-d pathname] [port #]\n"
+      printf("Usage: %s [-c] [-m] [-q] [-r] [-s] [-R seed] [-d pathname] [port #]\n"
               "  -c             Enable syntax check mode.\n"
               "  -d <directory> Specify library directory (defaults to 'lib').\n"
               "  -h             Print this command line argument help.\n"
@@ -330,6 +349,7 @@ int main(int argc, char **argv)
 	      "  -o <file>      Write log to <file> instead of stderr.\n"
               "  -q             Quick boot (doesn't scan rent for object limits)\n"
               "  -r             Restrict MUD -- no new players allowed.\n"
+              "  -R <seed>      Seed random numbers with <seed> to replay a run.\n"
               "  -s             Suppress special procedure assignments.\n"
               " Note:		These arguments are 'CaSe SeNsItIvE!!!'\n",
 		 argv[0]
@@ -344,7 +364,7 @@ int main(int argc, char **argv)
 
   if (pos < argc) {
     if (!isdigit(*argv[pos])) {
-      printf("Usage: %s [-c] [-m] [-q] [-r] [-s] [-d pathname] [port #]\n", argv[0]);
+      printf("Usage: %s [-c] [-m] [-q] [-r] [-s] [-R seed] [-d pathname] [port #]\n", argv[0]);
       exit(1);
     } else if ((port = atoi(argv[pos])) <= 1024) {
       printf("SYSERR: Illegal port number %d.\n", port);
@@ -394,6 +414,10 @@ int main(int argc, char **argv)
     free_help_table();		/* db.c */
     Free_Invalid_List();	/* ban.c */
     free_strings(&config_info, OASIS_CFG); /* oasis_delete.c */
+#ifdef MEMORY_DEBUG
+    slab_check();		/* slab.c */
+#endif
+    free_slabs();		/* slab.c */
   }
 
   /* probably should free the entire config here.. */
@@ -402,7 +426,7 @@ int main(int argc, char **argv)
   log("Done.");
 
 #ifdef MEMORY_DEBUG
-  zmalloc_check();
+  mem_check();			/* memtrack.c */
 #endif
 
   return (0);
@@ -411,6 +435,33 @@ int main(int argc, char **argv)
 int enter_player_game(struct descriptor_data *d);
 extern time_t boot_time;
 
+/*
+ * A descriptor for a socket handed over by the old process, or NULL if
+ * the connection has gone meanwhile; the snapshot code uses this too.
+ * Its telnet options are left to telnet_restore().
+ */
+struct descriptor_data *copyover_descriptor(socket_t desc, const char *host)
+{
+  struct descriptor_data *d;
+
+  /* Write something, and check if it goes error-free */    
+  if (write_to_descriptor (desc, "\n\rRestoring from copyover...\n\r") < 0) {
+    close (desc); /* nope */
+    return (NULL);
+  }
+
+  /* create a new descriptor */
+  CREATE (d, struct descriptor_data, 1);
+  memset ((char *) d, 0, sizeof (struct descriptor_data));
+  init_descriptor (d,desc); /* set up various stuff */
+
+  strlcpy(d->host, host, sizeof(d->host));
+  d->next = descriptor_list;
+  descriptor_list = d;
+
+  return (d);
+}
+
 /* Reload players after a copyover */
 void copyover_recover()
 {
@@ -419,8 +470,9 @@ void copyover_recover()
   char host[1024];
   int desc, player_i;
   bool fOld;
-  char name[MAX_INPUT_LENGTH];
+  char name[MAX_INPUT_LENGTH], line[MAX_STRING_LENGTH];
   long pref;
+  int rest;
   
   log ("Copyover recovery initiated");
 
@@ -438,31 +490,28 @@ void copyover_recover()
   /* read boot_time - first line in file */
   fscanf(fp, "%ld\n", &boot_time);
 
+  /* the players as they were, without going through their files */
+  if (read_copyover_snapshot()) {
+    fclose(fp);
+    return;
+  }
+
   for (;;) {
     fOld = TRUE;
-    fscanf (fp, "%d %ld %s %s\n", &desc, &pref, name, host);
-    if (desc == -1)
+    rest = -1;
+    /* the telnet state is the rest of the line; an older file has none */
+    if (!fgets(line, sizeof(line), fp) ||
+	sscanf(line, "%d %ld %s %s %n", &desc, &pref, name, host, &rest) < 1 || desc == -1)
       break;
 
-    /* Write something, and check if it goes error-free */    
-    if (write_to_descriptor (desc, "\n\rRestoring from copyover...\n\r") < 0) {
-      close (desc); /* nope */
+    if ((d = copyover_descriptor(desc, host)) == NULL)
       continue;
-    }
-
-    /* create a new descriptor */
-    CREATE (d, struct descriptor_data, 1);
-    memset ((char *) d, 0, sizeof (struct descriptor_data));
-    init_descriptor (d,desc); /* set up various stuff */
-
-    strcpy(d->host, host);
-    d->next = descriptor_list;
-    descriptor_list = d;
+    telnet_restore(d, rest >= 0 ? line + rest : NULL);
 
     d->connected = CON_CLOSE;
 
     /* Now, find the pfile */
-    CREATE(d->character, struct char_data, 1);
+    SLAB_CREATE(d->character, struct char_data, SLAB_CHAR);
     clear_char(d->character);
     CREATE(d->character->player_specials, struct player_special_data, 1);
     d->character->desc = d;
@@ -497,7 +546,11 @@ void init_game(ush_int port)
   /* We don't want to restart if we crash before we get up. */
   touch(KILLSCRIPT_FILE);
 
-  circle_srandom(time(0));
+  /* logged so that a run can be repeated with -R */
+  if (!boot_seed)
+    boot_seed = (unsigned long) time(0);
+  circle_srandom(boot_seed);
+  log("Random numbers seeded with %lu.", boot_seed);
 
   log("Finding player limit.");
   max_players = get_max_players();
@@ -878,7 +931,8 @@ void game_loop(socket_t mother_desc)
           continue;
       }
 
-      if (!get_from_q(&d->input, comm, &aliased))
+      /* expanded aliases go before anything else typed */
+      if (!get_from_q(&d->input, comm, &aliased) && !get_from_input(d, comm, &aliased))
         continue;
 
       if (d->character) {
@@ -913,6 +967,15 @@ void game_loop(socket_t mother_desc)
     /* Send queued output out to the operating system (ultimately to user). */
     for (d = descriptor_list; d; d = next_d) {
       next_d = d->next;
+      /* what has changed for GMCP, then the text */
+      if ((d->gmcp.dirty || d->gmcp.pending) && FD_ISSET(d->descriptor, &output_set))
+	if (gmcp_update(d) < 0) {
+	  close_socket(d);
+	  continue;
+	}
+      /* text now would land inside the GMCP message the socket took part of */
+      if (GMCP_WAITING(d))
+	continue;
       if (*(d->output) && FD_ISSET(d->descriptor, &output_set)) {
 	/* Output for this player is ready */
 	if (process_output(d) < 0)
@@ -924,7 +987,7 @@ void game_loop(socket_t mother_desc)
 
     /* Print prompts for other descriptors who had no other output */
     for (d = descriptor_list; d; d = d->next) {
-      if (!d->has_prompt) {
+      if (!d->has_prompt && !GMCP_WAITING(d)) {
 	write_to_descriptor(d->descriptor, make_prompt(d));
 	d->has_prompt = TRUE;
       }
@@ -989,13 +1052,20 @@ void heartbeat(int heart_pulse)
 {
   static int mins_since_crashsave = 0;
 
+  script_pulse_usec = 0;
+
   event_process();
+  olc_save_pulse();
 
   if (!(heart_pulse % PULSE_DG_SCRIPT))
     script_trigger_check();
+  else
+    script_sweep_continue();
 
   if (!(heart_pulse % PULSE_ZONE))
-    zone_update();
+    check_waiting_zones();
+  zone_reset_continue();
+  wake_queued_zones();
 
   if (!(heart_pulse % PULSE_IDLEPWD))		/* 15 seconds */
     check_idle_passwords();
@@ -1009,8 +1079,10 @@ void heartbeat(int heart_pulse)
   if (!(heart_pulse % (SECS_PER_MUD_HOUR * PASSES_PER_SEC))) {
     weather_and_time(1);
     check_time_triggers();
+    timer_hours++;		/* before anything runs out on the hour */
     affect_update();
     point_update();
+    hibernate_zones();
   }
 
   if (CONFIG_AUTO_SAVE && !(heart_pulse % PULSE_AUTOSAVE)) {	/* 1 minute */
@@ -1308,7 +1380,7 @@ void write_to_q(const char *txt, struct txt_q *queue, int aliased)
 {
   struct txt_block *newt;
 
-  CREATE(newt, struct txt_block, 1);
+  SLAB_CREATE(newt, struct txt_block, SLAB_TXT);
   newt->text = strdup(txt);
   newt->aliased = aliased;
 
@@ -1341,7 +1413,7 @@ int get_from_q(struct txt_q *queue, char *dest, int *aliased)
   tmp = queue->head;
   queue->head = queue->head->next;
   free(tmp->text);
-  free(tmp);
+  SLAB_FREE(tmp);
 
   return (1);
 }
@@ -1358,8 +1430,9 @@ void flush_queues(struct descriptor_data *d)
     struct txt_block *tmp = d->input.head;
     d->input.head = d->input.head->next;
     free(tmp->text);
-    free(tmp);
+    SLAB_FREE(tmp);
   }
+  free_input_ring(&d->in_ring);
 }
 
 
@@ -1427,7 +1500,7 @@ size_t vwrite_to_output(struct descriptor_data *t, const char *format, va_list a
     t->large_outbuf = bufpool;
     bufpool = bufpool->next;
   } else {			/* else create a new one */
-    CREATE(t->large_outbuf, struct txt_block, 1);
+    SLAB_CREATE(t->large_outbuf, struct txt_block, SLAB_TXT);
     CREATE(t->large_outbuf->text, char, LARGE_BUFSIZE);
     buf_largecount++;
   }
@@ -1453,9 +1526,15 @@ void free_bufpool(void)
     tmp = bufpool->next;
     if (bufpool->text)
       free(bufpool->text);
-    free(bufpool);
+    SLAB_FREE(bufpool);
     bufpool = tmp;
   }
+  while (inpool) {
+    tmp = inpool->next;
+    free(inpool->text);
+    SLAB_FREE(inpool);
+    inpool = tmp;
+  }
 }
 
 
@@ -1638,6 +1717,7 @@ int new_descriptor(socket_t s)
 
   /* initialize descriptor data */
    init_descriptor(newd, desc);
+   telnet_negotiate(newd);
 
   /* prepend to list */
   newd->next = descriptor_list;
@@ -1950,55 +2030,370 @@ ssize_t perform_socket_read(socket_t desc, char *read_point, size_t space_left)
 }
 
 /*
- * ASSUMPTION: There will be no newlines in the raw input buffer when this
- * function is called.  We must maintain that before returning.
+ * Input is put together a line at a time straight into the descriptor's
+ * input ring (see struct input_ring), and the game loop takes whole lines
+ * off the front with get_from_input().  Nothing is queued for a line
+ * until its newline comes, so a line split across reads just carries on
+ * where it stopped.  The ring buffers are pooled like the large output
+ * buffers, and go back to the pool when the descriptor closes.
  *
- * Ever wonder why 'tmp' had '+8' on it?  The crusty old code could write
- * MAX_INPUT_LENGTH+1 bytes to 'tmp' if there was a '$' as the final
- * character in the input buffer.  This would also cause 'space_left' to
- * drop to -1, which wasn't very happy in an unsigned variable.  Argh.
- * So to fix the above, 'tmp' lost the '+8' since it doesn't need it
- * and the code has been changed to reserve space by accepting one less
- * character. (Do you really need 256 characters on a line?)
- * -gg 1/21/2000
+ * How fast a descriptor's input is taken is limited by two token buckets
+ * (see config.c): one for the bytes read from its socket, one for the
+ * lines run from its ring.  The queue of lines is limited too, and when
+ * it or the ring is full CONFIG_INPUT_OVERFLOW says what gives.
+ *
+ * Someone in the string editor or OLC is usually pasting, and a line
+ * dropped there is a hole in what they wrote, so neither the line rate
+ * nor the queue limit applies to them.  Instead no more is read from
+ * their socket than the ring has room for, and the rest waits there.
  */
-int process_input(struct descriptor_data *t)
+#define RING_CHAR(r, i)		((r)->block->text[(i) & (INPUT_RING_SIZE - 1)])
+
+#define INPUT_BURST_SECS	5	/* seconds of input a bucket holds */
+
+/* writing a string or in OLC: its input is never dropped */
+#define INPUT_EDITING(d)	((d)->str || STATE(d) >= CON_OEDIT)
+
+/* fill a token bucket up to this pulse and say how many whole tokens it has */
+static long bucket_fill(struct token_bucket *b, int rate)
 {
-  int buf_length, failed_subst;
-  ssize_t bytes_read;
-  size_t space_left;
-  char *ptr, *read_point, *write_point, *nl_pos = NULL;
+  long most = (long) rate * PASSES_PER_SEC * INPUT_BURST_SECS;
+
+  if (!b->pulse)		/* a new descriptor starts with a full one */
+    b->tokens = most;
+  else if (pulse > b->pulse)
+    b->tokens = MIN(most, b->tokens + (long) (pulse - b->pulse) * rate);
+  b->pulse = MAX(pulse, 1);
+
+  return (b->tokens / PASSES_PER_SEC);
+}
+
+/* copy n bytes out of the ring, starting at from */
+static void ring_copy(struct input_ring *r, unsigned int from, char *dest, size_t n)
+{
+  size_t off = from & (INPUT_RING_SIZE - 1), first = MIN(n, INPUT_RING_SIZE - off);
+
+  memcpy(dest, r->block->text + off, first);
+  memcpy(dest + first, r->block->text, n - first);
+}
+
+/* n more bytes and a NUL fit after the line being typed */
+#define RING_ROOM(r, n)		((r)->pos + (n) + 1 - (r)->head <= INPUT_RING_SIZE)
+
+/* how long the oldest whole line is; the ring must have one */
+static size_t ring_line_length(struct input_ring *r)
+{
+  size_t off = r->head & (INPUT_RING_SIZE - 1), first = INPUT_RING_SIZE - off;
+  const char *nul;
+
+  /* the line may run past the end of the buffer and on at the start */
+  if ((nul = memchr(r->block->text + off, '\0', first)) != NULL)
+    return (nul - (r->block->text + off));
+  return (first + strlen(r->block->text));
+}
+
+/*
+ * A descriptor's input is full, either CONFIG_INPUT_QUEUE_LINES lines or
+ * the whole ring.  Do what CONFIG_INPUT_OVERFLOW says: returns 1 if the
+ * oldest line was dropped to make room, 0 if the line being typed is to
+ * be dropped instead, or -1 if the connection is to be closed.
+ */
+static int input_full(struct descriptor_data *t)
+{
+  struct input_ring *r = &t->in_ring;
+
+  t->in_stats.dropped++;
+  if (!t->in_stats.flooding) {
+    t->in_stats.flooding = TRUE;
+    mudlog(BRF, LVL_IMMORT, TRUE, "Input flood from %s [%s]: %s.",
+	t->character && GET_NAME(t->character) ? GET_NAME(t->character) : "<new>",
+	t->host, input_overflow_types[CONFIG_INPUT_OVERFLOW]);
+    if (CONFIG_INPUT_OVERFLOW != INPUT_DISCONNECT)
+      write_to_output(t, "\r\nYou are typing faster than the game can keep up; some of it is being lost.\r\n");
+  }
+
+  switch (CONFIG_INPUT_OVERFLOW) {
+  case INPUT_DISCONNECT:
+    return (-1);
+  case INPUT_DROP_OLDEST:
+    if (r->lines) {
+      r->head += ring_line_length(r) + 1;
+      r->lines--;
+      return (1);
+    }
+    /* nothing waiting to drop: drop this one */
+  default:
+    return (0);
+  }
+}
+
+/* make room for n more bytes of the line being typed; as input_full() */
+static int ring_make_room(struct descriptor_data *t, size_t n)
+{
+  int kept = 1;
+
+  while (!RING_ROOM(&t->in_ring, n) && (kept = input_full(t)) > 0)
+    ;
+  return (kept);
+}
+
+/*
+ * The line being typed is finished: do the history and ^ substitutions
+ * on it as always and queue it, or throw it away if a ^ failed.
+ */
+static int finish_line(struct descriptor_data *t)
+{
+  struct input_ring *r = &t->in_ring;
   char tmp[MAX_INPUT_LENGTH];
+  int failed_subst = 0, kept;
+  size_t length = r->pos - r->tail;
+
+  if (r->discard) {		/* dropped when the ring filled up */
+    r->discard = r->truncated = FALSE;
+    r->pos = r->tail;
+    return (0);
+  }
+  if (r->lines >= MAX(1, CONFIG_INPUT_QUEUE_LINES) && !INPUT_EDITING(t) &&
+      (kept = input_full(t)) <= 0) {
+    r->truncated = FALSE;
+    r->pos = r->tail;
+    return (kept);
+  }
+
+  ring_copy(r, r->tail, tmp, length);
+  tmp[length] = '\0';
+
+  if (r->truncated) {
+    char buffer[MAX_INPUT_LENGTH + 64];
+
+    r->truncated = FALSE;
+    snprintf(buffer, sizeof(buffer), "Line too long.  Truncated to:\r\n%s\r\n", tmp);
+    write_to_output(t, "%s", buffer);
+  }
+  if (t->snoop_by)
+    write_to_output(t->snoop_by, "%% %s\r\n", tmp);
+
+  if (*tmp == '!' && !(*(tmp + 1)))	/* Redo last command. */
+    strcpy(tmp, t->last_input);	/* strcpy: OK (by mutual MAX_INPUT_LENGTH) */
+  else if (*tmp == '!' && *(tmp + 1)) {
+    char *commandln = (tmp + 1);
+    int starting_pos = t->history_pos,
+	cnt = (t->history_pos == 0 ? HISTORY_SIZE - 1 : t->history_pos - 1);
+
+    skip_spaces(&commandln);
+    for (; cnt != starting_pos; cnt--) {
+      if (t->history[cnt] && is_abbrev(commandln, t->history[cnt])) {
+	strcpy(tmp, t->history[cnt]);	/* strcpy: OK (by mutual MAX_INPUT_LENGTH) */
+	strcpy(t->last_input, tmp);	/* strcpy: OK (by mutual MAX_INPUT_LENGTH) */
+	write_to_output(t, "%s\r\n", tmp);
+	break;
+      }
+      if (cnt == 0)	/* At top, loop to bottom. */
+	cnt = HISTORY_SIZE;
+    }
+  } else if (*tmp == '^') {
+    if (!(failed_subst = perform_subst(t, t->last_input, tmp)))
+      strcpy(t->last_input, tmp);	/* strcpy: OK (by mutual MAX_INPUT_LENGTH) */
+  } else {
+    strcpy(t->last_input, tmp);	/* strcpy: OK (by mutual MAX_INPUT_LENGTH) */
+    if (t->history[t->history_pos])
+      free(t->history[t->history_pos]);	/* Clear the old line. */
+    t->history[t->history_pos] = strdup(tmp);	/* Save the new. */
+    if (++t->history_pos >= HISTORY_SIZE)	/* Wrap to top. */
+      t->history_pos = 0;
+  }
+
+  if (failed_subst) {
+    r->pos = r->tail;
+    return (0);
+  }
+
+  /* a substitution replaces the line as typed */
+  if (RING_CHAR(r, r->tail) == '!' || RING_CHAR(r, r->tail) == '^') {
+    r->pos = r->tail;
+    if ((kept = ring_make_room(t, strlen(tmp))) <= 0)
+      return (kept);
+    for (length = 0; tmp[length]; length++)
+      RING_CHAR(r, r->pos++) = tmp[length];
+  }
+
+  RING_CHAR(r, r->pos++) = '\0';
+  r->tail = r->pos;
+  r->lines++;
+  t->in_stats.lines++;
+  if (++t->in_stats.sec_lines > t->in_stats.peak_lines)
+    t->in_stats.peak_lines = t->in_stats.sec_lines;
+
+  return (0);
+}
+
+/*
+ * Add len bytes of text (telnet commands already taken out) to the line
+ * being typed, queueing each line as its newline comes.  CR, LF, CR LF,
+ * LF CR and CR NUL each end one line.  Returns -1 if the connection is
+ * to be closed for flooding us.
+ */
+static int assemble_input(struct descriptor_data *t, const char *text, size_t len)
+{
+  struct input_ring *r = &t->in_ring;
+  const char *end = text + len;
+  int c, kept;
+
+  if (!r->block) {
+    if (inpool != NULL) {
+      r->block = inpool;
+      inpool = inpool->next;
+    } else {
+      SLAB_CREATE(r->block, struct txt_block, SLAB_TXT);
+      CREATE(r->block->text, char, INPUT_RING_SIZE);
+    }
+    r->head = r->tail = r->pos = 0;
+  }
+
+  for (; text < end; text++) {
+    c = (unsigned char) *text;
+
+    if (r->newline) {		/* the second half of a two-byte newline? */
+      char last = r->newline;
+
+      r->newline = '\0';
+      if ((ISNEWL(c) && c != last) || (!c && last == '\r'))
+	continue;
+    }
+
+    if (ISNEWL(c)) {
+      r->newline = c;
+      if (finish_line(t) < 0)
+	return (-1);
+    } else if (r->discard)
+      continue;
+    else if (c == '\b' || c == 127) {	/* handle backspacing or delete key */
+      if (r->pos > r->tail && !r->truncated) {
+	if (RING_CHAR(r, --r->pos) == '$')
+	  r->pos--;		/* '$' went in as '$$' */
+      }
+    } else if (c == '\025') {	/* ^U: start the line again */
+      r->pos = r->tail;
+      r->truncated = FALSE;
+    } else if (isascii(c) && isprint(c) && !r->truncated) {
+      int n = (c == '$' ? 2 : 1);	/* if it's a $, double it */
+
+      /* MAX_INPUT_LENGTH - 1 as ever, less one for a '$ => $$' expansion */
+      if (r->pos - r->tail + n > MAX_INPUT_LENGTH - 2)
+	r->truncated = TRUE;
+      else if (!RING_ROOM(r, n) && (kept = ring_make_room(t, n)) <= 0) {
+	if (kept < 0)
+	  return (-1);
+	r->pos = r->tail;
+	r->discard = TRUE;
+      } else {
+	RING_CHAR(r, r->pos++) = c;
+	if (n == 2)
+	  RING_CHAR(r, r->pos++) = c;
+      }
+    }
+  }
+
+  return (0);
+}
+
+/*
+ * NOTE: 'dest' must be at least MAX_INPUT_LENGTH big.
+ */
+static int get_from_input(struct descriptor_data *d, char *dest, int *aliased)
+{
+  struct input_ring *r = &d->in_ring;
+  size_t length;
+
+  if (!r->lines)
+    return (0);
+
+  /* past CONFIG_INPUT_LINE_RATE, lines wait their turn */
+  if (CONFIG_INPUT_LINE_RATE > 0 && !INPUT_EDITING(d)) {
+    if (bucket_fill(&d->in_lines, CONFIG_INPUT_LINE_RATE) < 1)
+      return (0);
+    d->in_lines.tokens -= PASSES_PER_SEC;
+  }
+
+  length = ring_line_length(r);
+  ring_copy(r, r->head, dest, length + 1);
+  r->head += length + 1;
+  if (!--r->lines)
+    d->in_stats.flooding = FALSE;
+  *aliased = 0;
+
+  return (1);
+}
+
+/* give a closing descriptor's ring buffer back to the pool */
+static void free_input_ring(struct input_ring *r)
+{
+  if (r->block) {
+    r->block->next = inpool;
+    inpool = r->block;
+    r->block = NULL;
+  }
+  r->lines = 0;
+}
 
-  /* first, find the point where we left off reading data */
-  buf_length = strlen(t->inbuf);
-  read_point = t->inbuf + buf_length;
-  space_left = MAX_RAW_INPUT_LENGTH - buf_length - 1;
+/*
+ * Read what a descriptor has sent us, take the telnet commands out of it
+ * and put the text into lines.  It used to be copied into d->inbuf until
+ * a newline came and the lines then split out of that; now each read is
+ * dealt with as it comes, however it ends.
+ */
+int process_input(struct descriptor_data *t)
+{
+  char buf[MAX_RAW_INPUT_LENGTH];
+  ssize_t bytes_read;
+  size_t want;
+  struct input_stats *s = &t->in_stats;
+  time_t now;
+  long allowed;
 
   do {
-    if (space_left <= 0) {
-      log("WARNING: process_input: about to close connection: input overflow");
-      return (-1);
+    /* past CONFIG_INPUT_BYTE_RATE, the rest waits in the socket */
+    want = sizeof(buf);
+    if (CONFIG_INPUT_BYTE_RATE > 0) {
+      if ((allowed = bucket_fill(&t->in_bytes, CONFIG_INPUT_BYTE_RATE)) < 1) {
+	s->throttled++;
+	return (0);
+      }
+      want = MIN(want, (size_t) allowed);
+    }
+
+    /* each byte read can take two in the ring ('$' goes in as '$$') */
+    if (INPUT_EDITING(t) && t->in_ring.block) {
+      struct input_ring *r = &t->in_ring;
+      size_t room = INPUT_RING_SIZE - 1 - (r->pos - r->head);
+
+      if ((want = MIN(want, room / 2)) < 1) {
+	s->throttled++;
+	return (0);
+      }
     }
 
-    bytes_read = perform_socket_read(t->descriptor, read_point, space_left);
+    bytes_read = perform_socket_read(t->descriptor, buf, want);
 
     if (bytes_read < 0)	/* Error, disconnect them. */
       return (-1);
     else if (bytes_read == 0)	/* Just blocking, no problems. */
       return (0);
 
-    /* at this point, we know we got some data from the read */
-
-    *(read_point + bytes_read) = '\0';	/* terminate the string */
-
-    /* search for a newline in the data we just read */
-    for (ptr = read_point; *ptr && !nl_pos; ptr++)
-      if (ISNEWL(*ptr))
-	nl_pos = ptr;
+    if (s->second != (now = time(0))) {
+      s->second = now;
+      s->sec_bytes = s->sec_lines = 0;
+    }
+    s->bytes += bytes_read;
+    if ((s->sec_bytes += bytes_read) > s->peak_bytes)
+      s->peak_bytes = s->sec_bytes;
+    if (CONFIG_INPUT_BYTE_RATE > 0)
+      t->in_bytes.tokens -= bytes_read * PASSES_PER_SEC;
 
-    read_point += bytes_read;
-    space_left -= bytes_read;
+    if (assemble_input(t, buf, telnet_filter(t, buf, bytes_read)) < 0) {
+      log("WARNING: process_input: about to close connection: input overflow");
+      return (-1);
+    }
 
 /*
  * on some systems such as AIX, POSIX-standard nonblocking I/O is broken,
@@ -2011,108 +2406,47 @@ int process_input(struct descriptor_data *t)
  * this descriptor is in the read set).  JE 2/23/95.
  */
 #if !defined(POSIX_NONBLOCK_BROKEN)
-  } while (nl_pos == NULL);
+  } while ((size_t) bytes_read == want);	/* a full read may have more behind it */
 #else
   } while (0);
-
-  if (nl_pos == NULL)
-    return (0);
 #endif /* POSIX_NONBLOCK_BROKEN */
 
-  /*
-   * okay, at this point we have at least one newline in the string; now we
-   * can copy the formatted data to a new array for further processing.
-   */
-
-  read_point = t->inbuf;
-
-  while (nl_pos != NULL) {
-    write_point = tmp;
-    space_left = MAX_INPUT_LENGTH - 1;
-
-    /* The '> 1' reserves room for a '$ => $$' expansion. */
-    for (ptr = read_point; (space_left > 1) && (ptr < nl_pos); ptr++) {
-      if (*ptr == '\b' || *ptr == 127) { /* handle backspacing or delete key */
-	if (write_point > tmp) {
-	  if (*(--write_point) == '$') {
-	    write_point--;
-	    space_left += 2;
-	  } else
-	    space_left++;
-	}
-      } else if (isascii(*ptr) && isprint(*ptr)) {
-	if ((*(write_point++) = *ptr) == '$') {		/* copy one character */
-	  *(write_point++) = '$';	/* if it's a $, double it */
-	  space_left -= 2;
-	} else
-	  space_left--;
-      }
-    }
-
-    *write_point = '\0';
-
-    if ((space_left <= 0) && (ptr < nl_pos)) {
-      char buffer[MAX_INPUT_LENGTH + 64];
-
-      snprintf(buffer, sizeof(buffer), "Line too long.  Truncated to:\r\n%s\r\n", tmp);
-      if (write_to_descriptor(t->descriptor, buffer) < 0)
-	return (-1);
-    }
-    if (t->snoop_by)
-      write_to_output(t->snoop_by, "%% %s\r\n", tmp);
-    failed_subst = 0;
-
-    if (*tmp == '!' && !(*(tmp + 1)))	/* Redo last command. */
-      strcpy(tmp, t->last_input);	/* strcpy: OK (by mutual MAX_INPUT_LENGTH) */
-    else if (*tmp == '!' && *(tmp + 1)) {
-      char *commandln = (tmp + 1);
-      int starting_pos = t->history_pos,
-	  cnt = (t->history_pos == 0 ? HISTORY_SIZE - 1 : t->history_pos - 1);
-
-      skip_spaces(&commandln);
-      for (; cnt != starting_pos; cnt--) {
-	if (t->history[cnt] && is_abbrev(commandln, t->history[cnt])) {
-	  strcpy(tmp, t->history[cnt]);	/* strcpy: OK (by mutual MAX_INPUT_LENGTH) */
-	  strcpy(t->last_input, tmp);	/* strcpy: OK (by mutual MAX_INPUT_LENGTH) */
-          write_to_output(t, "%s\r\n", tmp);
-	  break;
-	}
-        if (cnt == 0)	/* At top, loop to bottom. */
-	  cnt = HISTORY_SIZE;
-      }
-    } else if (*tmp == '^') {
-      if (!(failed_subst = perform_subst(t, t->last_input, tmp)))
-	strcpy(t->last_input, tmp);	/* strcpy: OK (by mutual MAX_INPUT_LENGTH) */
-    } else {
-      strcpy(t->last_input, tmp);	/* strcpy: OK (by mutual MAX_INPUT_LENGTH) */
-      if (t->history[t->history_pos])
-	free(t->history[t->history_pos]);	/* Clear the old line. */
-      t->history[t->history_pos] = strdup(tmp);	/* Save the new. */
-      if (++t->history_pos >= HISTORY_SIZE)	/* Wrap to top. */
-	t->history_pos = 0;
-    }
-
-    if (!failed_subst)
-      write_to_q(tmp, &t->input, 0);
+  return (1);
+}
 
-    /* find the end of this line */
-    while (ISNEWL(*nl_pos))
-      nl_pos++;
 
-    /* see if there's another newline in the input buffer */
-    read_point = ptr = nl_pos;
-    for (nl_pos = NULL; *ptr && !nl_pos; ptr++)
-      if (ISNEWL(*ptr))
-	nl_pos = ptr;
+/* per-descriptor input counts and telnet options, for "show input" */
+void input_report(struct char_data *ch)
+{
+  struct descriptor_data *d;
+  struct input_stats *s;
+  char size[16];
+  time_t now = time(0);
+  int secs;
+
+  send_to_char(ch, "Limits: %d bytes/sec, %d lines/sec, %d lines waiting, then %s.\r\n",
+	CONFIG_INPUT_BYTE_RATE, CONFIG_INPUT_LINE_RATE, CONFIG_INPUT_QUEUE_LINES,
+	input_overflow_types[CONFIG_INPUT_OVERFLOW]);
+  send_to_char(ch,
+	"Num Name          Bytes   Lines  B/sec L/sec  Peak B/s L/s Wait  Drop Thrtl Client       Size    GMCP Charset\r\n"
+	"--- ------------ -------- ------ ----- ----- --------- ---- ---- ----- ----- ------------ ------- ---- -------\r\n");
+  for (d = descriptor_list; d; d = d->next) {
+    if (d->character && GET_INVIS_LEV(d->character) > GET_LEVEL(ch))
+      continue;
+    s = &d->in_stats;
+    secs = MAX(1, now - d->login_time);
+    if (d->telnet.cols || d->telnet.rows)
+      snprintf(size, sizeof(size), "%dx%d", d->telnet.cols, d->telnet.rows);
+    else
+      strcpy(size, "-");	/* strcpy: OK */
+    send_to_char(ch, "%3d %-12.12s %8lu %6lu %5lu %5lu %5d %3d %4d %5lu %5lu %-12.12s %-7s %-4s %s\r\n",
+	d->desc_num, d->character && GET_NAME(d->character) ? GET_NAME(d->character) : "-",
+	s->bytes, s->lines, s->bytes / secs, s->lines / secs,
+	s->peak_bytes, s->peak_lines, d->in_ring.lines, s->dropped, s->throttled,
+	*d->telnet.ttype ? d->telnet.ttype : "-", size,
+	IS_SET(d->telnet.opts, TELNET_GMCP) ? "Yes" : "-",
+	*d->telnet.charset ? d->telnet.charset : "-");
   }
-
-  /* now move the rest of the buffer up to the beginning for the next pass */
-  write_point = t->inbuf;
-  while (*read_point)
-    *(write_point++) = *(read_point++);
-  *write_point = '\0';
-
-  return (1);
 }
 
 
@@ -2369,14 +2703,93 @@ RETSIGTYPE websterlink(int sig)
 
 #ifdef CIRCLE_UNIX
 
+/*
+ * One job at a time can run in a child process, which starts with a copy
+ * of the game as it stood, does the job and exits while the game carries
+ * on.  OLC saves use it to write zone files.
+ */
+static volatile pid_t job_pid = 0;
+static volatile sig_atomic_t job_finished = FALSE;
+static volatile int job_status = 0;
+
 /* clean up our zombie kids to avoid defunct processes */
 RETSIGTYPE reap(int sig)
 {
-  while (waitpid(-1, NULL, WNOHANG) > 0);
+  pid_t pid;
+  int status;
+
+  while ((pid = waitpid(-1, &status, WNOHANG)) > 0)
+    if (pid == job_pid) {
+      job_status = status;
+      job_finished = TRUE;
+    }
 
   my_signal(SIGCHLD, reap);
 }
 
+/* TRUE if 'job' went off to a child process; FALSE to run it here instead */
+int start_background_job(int (*job)(void))
+{
+  sigset_t mask, was;
+  pid_t pid;
+
+  if (job_pid > 0)
+    return (FALSE);
+
+  /* or the child would write out what is buffered a second time */
+  fflush(NULL);
+
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGCHLD);
+  sigprocmask(SIG_BLOCK, &mask, &was);
+
+  if ((pid = fork()) == 0) {
+    int ok = job();
+
+    fflush(NULL);
+    _exit(ok ? 0 : 1);
+  }
+  if (pid > 0) {
+    job_pid = pid;
+    job_finished = FALSE;
+  }
+  sigprocmask(SIG_SETMASK, &was, NULL);
+
+  if (pid < 0) {
+    log("SYSERR: Unable to fork a background job: %s", strerror(errno));
+    return (FALSE);
+  }
+  return (TRUE);
+}
+
+/* BG_RUNNING while the job runs (unless told to wait), then whether it worked */
+int background_job_done(int wait)
+{
+  sigset_t mask, was;
+  int status = -1;
+
+  if (job_pid <= 0)
+    return (TRUE);
+
+  if (wait) {
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &mask, &was);
+    while (!job_finished && waitpid(job_pid, &status, 0) < 0 && errno == EINTR);
+    if (!job_finished) {
+      job_status = status;
+      job_finished = TRUE;
+    }
+    sigprocmask(SIG_SETMASK, &was, NULL);
+  }
+
+  if (!job_finished)
+    return (BG_RUNNING);
+
+  job_pid = 0;
+  return (WIFEXITED(job_status) && WEXITSTATUS(job_status) == 0);
+}
+
 /* Dying anyway... */
 RETSIGTYPE checkpointing(int sig)
 {
@@ -2400,6 +2813,19 @@ RETSIGTYPE hupsig(int sig)
 
 #endif	/* CIRCLE_UNIX */
 
+#ifndef CIRCLE_UNIX
+/* no fork() here, so background jobs are done on the spot */
+int start_background_job(int (*job)(void))
+{
+  return (FALSE);
+}
+
+int background_job_done(int wait)
+{
+  return (TRUE);
+}
+#endif
+
 /*
  * This is an implementation of signal() using sigaction() for portability.
  * (sigaction() is POSIX; signal() is not.)  Taken from Stevens' _Advanced
@@ -2722,6 +3148,7 @@ void act(const char *str, int hide_invisible, struct char_data *ch,
 	 struct obj_data *obj, const void *vict_obj, int type)
 {
   const struct char_data *to;
+  room_rnum room;
   int to_sleeping;
 
   if (!str || !*str)
@@ -2782,15 +3209,20 @@ void act(const char *str, int hide_invisible, struct char_data *ch,
   /* ASSUMPTION: at this point we know type must be TO_NOTVICT or TO_ROOM */
 
   if (ch && IN_ROOM(ch) != NOWHERE)
-    to = world[IN_ROOM(ch)].people;
-  else if (obj && IN_ROOM(obj) != NOWHERE)
-    to = world[IN_ROOM(obj)].people;
+    room = IN_ROOM(ch);
+  else if (obj && OBJ_IN_ROOM(obj) != NOWHERE)
+    room = OBJ_IN_ROOM(obj);
   else {
     log("SYSERR: no valid target to act()!");
     return;
   }
 
-  for (; to; to = to->next_in_room) {
+  /* nobody here has a descriptor or an act trigger to hear it with */
+  if (!world[room].census.pcs &&
+	!(room_occupants(room) & (OCC_SWITCHED | (dg_act_check ? OCC_SCRIPTED : 0))))
+    return;
+
+  for (to = world[room].people; to; to = to->next_in_room) {
     if (!SENDOK(to) || (to == ch))
       continue;
     if (hide_invisible && ch && !CAN_SEE(to, ch))
@@ -10,6 +10,7 @@
 
 #define NUM_RESERVED_DESCS	8
 #define COPYOVER_FILE "copyover.dat"
+#define COPYOVER_SNAPSHOT "copyover.bin"
 
 /* comm.c */
 size_t	send_to_char(struct char_data *ch, const char *messg, ...) __attribute__ ((format (printf, 2, 3)));
@@ -47,5 +48,32 @@ void	string_write(struct descriptor_data *d, char **txt, size_t len, long mailto
 #define PAGE_WIDTH	80
 void	page_string(struct descriptor_data *d, char *str, int keep_internal);
 
+void	input_report(struct char_data *ch);
+
+/* the telnet protocol: a client's input, and GMCP out to it; protocol.c */
+void	telnet_negotiate(struct descriptor_data *d);
+void	telnet_save(struct descriptor_data *d, char *buf, size_t size);
+void	telnet_restore(struct descriptor_data *d, const char *state);
+size_t	telnet_filter(struct descriptor_data *d, char *buf, size_t len);
+int	gmcp_update(struct descriptor_data *d);
+void	gmcp_hit_changed(struct char_data *ch);
+
+/* something a GMCP message tells ch's client about may have changed */
+#define GMCP_DIRTY(ch, bits) \
+	do { if ((ch)->desc) (ch)->desc->gmcp.dirty |= (bits); } while (0)
+
+/* the socket took only part of d's GMCP: nothing else may go until it's out */
+#define GMCP_WAITING(d)	((d)->gmcp.pending > (d)->gmcp.written)
+
+/* a job run in a child process */
+int	start_background_job(int (*job)(void));
+int	background_job_done(int wait);
+#define BG_RUNNING	(-1)
+
+/* the players handed across a copyover; copyover.c */
+struct descriptor_data *copyover_descriptor(socket_t desc, const char *host);
+void	write_copyover_snapshot(void);
+int	read_copyover_snapshot(void);
+
 typedef RETSIGTYPE sigfunc(int);
 
@@ -329,6 +329,61 @@ int nameserver_is_slow = NO;
  */
 int auto_save_olc = 1;
 
+/*
+ * How many microseconds of script execution are allowed per pulse before
+ * random and time trigger checks are deferred to the following pulses.
+ * Set to 0 to never defer them.
+ */
+int script_budget = 0;
+
+/*
+ * On average, one allocation in this many bytes is remembered by the
+ * allocation tracker (see memtrack.c and 'show memory').  Lower values
+ * give finer live memory estimates for a little more overhead; 0 turns
+ * sampling off and keeps only the per call site counters.
+ */
+int mem_sample_rate = 65536;
+
+/*
+ * How many zone reset commands a queued zone reset may run each pulse
+ * before the rest of the zone is left for the following pulses, so big
+ * zones don't stall the game when they come due.  Set to 0 to reset
+ * each zone all at once.  Boot and zreset always do the whole zone.
+ */
+int zone_reset_budget = 100;
+
+/*
+ * Mobs in zones without players only act on one mobile pulse in this
+ * many (so 6 is about once a minute).  1 lets them act every pulse as
+ * usual; 0 leaves them still until a player comes.  Zones flagged
+ * ALWAYS_ACTIVE in zedit are always treated as having players.
+ */
+int dormant_mob_pulses = 6;
+
+/*
+ * A zone that has had no players in it for this many minutes hibernates:
+ * its mobs, objects and scripts are left out of the periodic updates
+ * until a player comes, a script reaches into it or it resets, when its
+ * affects and object timers are caught up.  0 keeps every zone awake.
+ */
+int hibernate_minutes = 15;
+
+/*
+ * How fast one connection's input is taken in.  Past input_byte_rate
+ * bytes a second (after a few seconds' burst) the rest is left unread
+ * in the socket, so the client is slowed down and nothing is lost.
+ * Past input_line_rate lines a second the lines wait in its queue, and
+ * when more than input_queue_lines are waiting, input_overflow says what
+ * happens: INPUT_DROP_NEWEST, INPUT_DROP_OLDEST or INPUT_DISCONNECT.
+ * A rate of 0 means no limit; lines are never run faster than one a
+ * pulse in any case.  Neither the line rate nor the queue limit applies
+ * to someone in the string editor or OLC, so a paste there is not cut up.
+ */
+int input_byte_rate = 2048;
+int input_line_rate = 5;
+int input_queue_lines = 100;
+int input_overflow = INPUT_DROP_NEWEST;
+
 /*
  * if you wish to enable Aedit, set this to 1 
  * This will make the mud look for a file called socials.new,
@@ -64,6 +64,25 @@ const char *room_bits[] = {
 };
 
 
+/* OCC_x */
+const char *occupant_bits[] = {
+  "AGGRESSIVE",
+  "SCRIPTED",
+  "SWITCHED",
+  "HIDDEN",
+  "\n"
+};
+
+
+/* INPUT_x */
+const char *input_overflow_types[] = {
+  "drop newest",
+  "drop oldest",
+  "disconnect",
+  "\n"
+};
+
+
 /* EX_x */
 const char *exit_bits[] = {
   "DOOR",
@@ -3,6 +3,8 @@ extern const char *oasisolc_version;
 extern const char *ascii_pfiles_version;
 extern const char *dirs[];
 extern const char *room_bits[];
+extern const char *occupant_bits[];
+extern const char *input_overflow_types[];
 extern const char *exit_bits[];
 extern const char *sector_types[];
 extern const char *genders[];
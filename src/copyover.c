@@ -0,0 +1,770 @@
+/* ************************************************************************
+*   File: copyover.c                                    Part of CircleMUD *
+*  Usage: the players' state handed from one process to the next          *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+*                                                                         *
+*  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+*  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+************************************************************************ */
+
+/*
+ * A copyover used to hand the new process nothing but COPYOVER_FILE, the
+ * sockets and names of the players, and the new process read every one
+ * of them back in from the player, rent, alias and variable files as if
+ * they had just logged in.  do_copyover() now also writes the players as
+ * they are into COPYOVER_SNAPSHOT: stats, affects with the time they have
+ * left, what they carry and wear down to the insides of containers, the
+ * room they are standing in, aliases, script variables and the charmed
+ * followers with them.  It notes when each zone last reset, too, so zones
+ * keep their reset times instead of all coming due together.  Fighting is
+ * left behind.
+ *
+ * The snapshot is raw structures, so it only means anything to a game
+ * built with the same structure layouts; the header records them.  If
+ * they don't match, or the file is missing, cut short or garbled, the new
+ * process says so in the log and loads the players from their files the
+ * old way; do_copyover() still saves them there first.  Nothing is
+ * restored until the whole file has been read and checked.
+ *
+ * The world itself still boots from the world files.
+ */
+
+#include "conf.h"
+#include "sysdep.h"
+
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "db.h"
+#include "handler.h"
+#include "interpreter.h"
+#include "dg_scripts.h"
+
+/* external variables */
+extern struct descriptor_data *descriptor_list;
+extern struct char_data *character_list;
+extern struct zone_data *zone_table;
+extern zone_rnum top_of_zone_table;
+extern struct obj_data *obj_proto;
+extern room_rnum r_mortal_start_room;
+extern room_rnum r_immort_start_room;
+extern room_rnum r_frozen_start_room;
+extern time_t boot_time;
+
+/* external functions */
+void timediff(struct timeval *diff, struct timeval *a, struct timeval *b);
+
+#define SNAPSHOT_MAGIC		"CIRCSNAP"
+#define SNAPSHOT_END		0x534e4150	/* after the last record	*/
+#define SNAPSHOT_VERSION	3
+#define SNAPSHOT_LAYOUTS	10
+#define SNAPSHOT_DEPTH		16	/* containers deeper go in the last */
+
+struct snapshot_header {
+  char magic[8];
+  int version;
+  int layout[SNAPSHOT_LAYOUTS];	/* sizes of what is written raw	*/
+  time_t boot_time;
+  int players;
+  int zones;
+};
+
+/* an object in a character's equipment or inventory */
+struct snapshot_obj {
+  obj_vnum vnum;		/* NOTHING ends the list		*/
+  sh_int worn_on;		/* wear position, -1 if carried		*/
+  int depth;			/* 0 on the char, n+1 in the last n	*/
+  struct obj_flag_data flags;	/* weight is without the contents	*/
+  struct obj_affected_type affected[MAX_OBJ_AFFECT];
+};
+
+static void snapshot_layout(int *layout)
+{
+  layout[0] = sizeof(struct char_player_data);
+  layout[1] = sizeof(struct char_ability_data);
+  layout[2] = sizeof(struct char_point_data);
+  layout[3] = sizeof(struct char_special_data_saved);
+  layout[4] = sizeof(struct player_special_data_saved);
+  layout[5] = sizeof(struct affected_type);
+  layout[6] = sizeof(struct snapshot_obj);
+  layout[7] = NUM_WEARS;
+  layout[8] = MAX_SKILLS;
+  layout[9] = sizeof(time_t);
+}
+
+/* ******************************************************************* */
+
+static FILE *snap_fl;
+static bool snap_ok;
+
+static void put(const void *data, size_t len)
+{
+  if (snap_ok && fwrite(data, 1, len, snap_fl) != len)
+    snap_ok = FALSE;
+}
+
+#define PUT(x)	put(&(x), sizeof(x))
+
+/* NULL goes in as a length of 0 */
+static void put_str(const char *str)
+{
+  int len = str ? strlen(str) + 1 : 0;
+
+  PUT(len);
+  if (len)
+    put(str, len);
+}
+
+static void put_objs(struct obj_data *obj, int worn_on, int depth);
+
+/* an object, followed by what is in it */
+static void put_obj(struct obj_data *obj, int worn_on, int depth)
+{
+  struct snapshot_obj so;
+  struct obj_data *proto, *cont;
+
+  /* made up on the spot, like money; rent loses these too */
+  if (GET_OBJ_RNUM(obj) == NOTHING)
+    return;
+
+  memset(&so, 0, sizeof(so));
+  so.vnum = GET_OBJ_VNUM(obj);
+  so.worn_on = worn_on;
+  so.depth = depth;
+  so.flags = obj->obj_flags;
+  so.flags.timer = GET_OBJ_TIMER(obj);
+  for (cont = obj->contains; cont; cont = cont->next_content)
+    if (GET_OBJ_RNUM(cont) != NOTHING)
+      so.flags.weight -= GET_OBJ_WEIGHT(cont);
+  memcpy(so.affected, obj->affected, sizeof(so.affected));
+  PUT(so);
+
+  /* strings shared with the prototype aren't worth writing */
+  proto = &obj_proto[GET_OBJ_RNUM(obj)];
+  put_str(obj->name != proto->name ? obj->name : NULL);
+  put_str(obj->description != proto->description ? obj->description : NULL);
+  put_str(obj->short_description != proto->short_description ? obj->short_description : NULL);
+  put_str(obj->action_description != proto->action_description ? obj->action_description : NULL);
+
+  put_objs(obj->contains, -1, depth + 1);
+}
+
+/* a list goes in backwards, since it is built up again from the front */
+static void put_objs(struct obj_data *obj, int worn_on, int depth)
+{
+  if (obj) {
+    put_objs(obj->next_content, worn_on, depth);
+    put_obj(obj, worn_on, depth);
+  }
+}
+
+/*
+ * What a PC and an NPC have in common.  Affects and equipment come off
+ * first, as in save_char(), so the stats are written without them, and
+ * go back on afterwards.
+ */
+static void put_snapshot_char(struct char_data *ch)
+{
+  struct obj_data *eq[NUM_WEARS];
+  struct affected_type *aff, affs[MAX_AFFECT];
+  struct snapshot_obj end;
+  int i, num_affs = 0;
+
+  for (i = 0; i < NUM_WEARS; i++)
+    eq[i] = GET_EQ(ch, i) ? unequip_char(ch, i) : NULL;
+
+  for (aff = ch->affected; aff && num_affs < MAX_AFFECT; aff = aff->next) {
+    affs[num_affs] = *aff;
+    affs[num_affs].duration = affect_duration(aff);
+    affs[num_affs].next = NULL;
+    affs[num_affs].holder = NULL;
+    affs[num_affs].wheel_next = NULL;
+    affs[num_affs].wheel_pprev = NULL;
+    affs[num_affs++].expires = 0;
+  }
+  while (ch->affected)
+    affect_remove(ch, ch->affected);
+  ch->aff_abils = ch->real_abils;
+
+  PUT(ch->real_abils);
+  PUT(ch->points);
+  PUT(ch->char_specials.saved);
+  PUT(GET_HIT(ch));
+  PUT(GET_MANA(ch));
+  PUT(PLR_FLAGS(ch));
+  PUT(AFF_FLAGS(ch));
+  PUT(GET_POS(ch));
+  PUT(num_affs);
+  for (i = 0; i < num_affs; i++)
+    PUT(affs[i]);
+
+  for (i = 0; i < num_affs; i++)
+    affect_to_char(ch, &affs[i]);
+
+  for (i = 0; i < NUM_WEARS; i++)
+    if (eq[i]) {
+      put_obj(eq[i], i, 0);
+      equip_char(ch, eq[i], i);
+    }
+  put_objs(ch->carrying, -1, 0);
+
+  memset(&end, 0, sizeof(end));
+  end.vnum = NOTHING;
+  PUT(end);
+}
+
+/* someone switched into a mob is saved as themselves */
+#define SNAPSHOT_CHAR(d)	((d)->original ? (d)->original : (d)->character)
+
+static void put_player(struct descriptor_data *d)
+{
+  struct char_data *ch = SNAPSHOT_CHAR(d), *fol;
+  struct char_player_data player;
+  struct alias_data *a;
+  struct trig_var_data *var;
+  struct follow_type *f;
+  room_vnum room = GET_ROOM_VNUM(IN_ROOM(ch));
+  mob_vnum vnum;
+  int count;
+  char telnet[MAX_INPUT_LENGTH];
+
+  put_str(d->host);
+  PUT(d->descriptor);
+  telnet_save(d, telnet, sizeof(telnet));
+  put_str(telnet);
+  PUT(GET_PREF(ch));
+
+  /* the strings go separately; the rest is plain data */
+  player = ch->player;
+  player.time.played += time(0) - player.time.logon;
+  player.name = player.short_descr = player.long_descr = NULL;
+  player.description = player.title = NULL;
+  PUT(player);
+  put_str(GET_NAME(ch));
+  put_str(GET_TITLE(ch));
+  put_str(ch->player.description);
+  put_str(POOFIN(ch));
+  put_str(POOFOUT(ch));
+  put_str(GET_HOST(ch));
+  PUT(ch->player_specials->saved);
+  PUT(room);
+
+  put_snapshot_char(ch);
+
+  for (count = 0, a = GET_ALIASES(ch); a; a = a->next)
+    count++;
+  PUT(count);
+  for (a = GET_ALIASES(ch); a; a = a->next) {
+    put_str(a->alias);
+    put_str(a->replacement);
+    PUT(a->type);
+  }
+
+  count = 0;
+  if (SCRIPT(ch))
+    for (var = SCRIPT(ch)->global_vars; var; var = var->next)
+      count++;
+  PUT(count);
+  if (SCRIPT(ch))
+    for (var = SCRIPT(ch)->global_vars; var; var = var->next) {
+      put_str(var->name);
+      put_str(var->value);
+      PUT(var->context);
+    }
+
+  /* charmed mobs standing with their master come along */
+  for (count = 0, f = ch->followers; f; f = f->next)
+    if (IS_NPC(f->follower) && AFF_FLAGGED(f->follower, AFF_CHARM) &&
+	IN_ROOM(f->follower) == IN_ROOM(ch))
+      count++;
+  PUT(count);
+  for (f = ch->followers; f; f = f->next) {
+    fol = f->follower;
+    if (IS_NPC(fol) && AFF_FLAGGED(fol, AFF_CHARM) && IN_ROOM(fol) == IN_ROOM(ch)) {
+      vnum = GET_MOB_VNUM(fol);
+      PUT(vnum);
+      put_snapshot_char(fol);
+    }
+  }
+}
+
+/*
+ * Called by do_copyover() before it saves and drops anybody, for the
+ * same players it keeps: those in the game and not in OLC.  An immortal
+ * switched into a mob comes back in their own body.
+ */
+void write_copyover_snapshot(void)
+{
+  struct snapshot_header hdr;
+  struct descriptor_data *d;
+  struct timeval start, now, spent;
+  zone_rnum zone;
+  int end = SNAPSHOT_END;
+  long size;
+
+  gettimeofday(&start, (struct timezone *) 0);
+
+  if (!(snap_fl = fopen(COPYOVER_SNAPSHOT, "wb"))) {
+    log("SYSERR: Couldn't write %s, the new process will load players from their files: %s",
+	COPYOVER_SNAPSHOT, strerror(errno));
+    return;
+  }
+  snap_ok = TRUE;
+
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, SNAPSHOT_MAGIC, sizeof(hdr.magic));
+  hdr.version = SNAPSHOT_VERSION;
+  snapshot_layout(hdr.layout);
+  hdr.boot_time = boot_time;
+  hdr.zones = top_of_zone_table + 1;
+  for (d = descriptor_list; d; d = d->next)
+    if (d->character && STATE(d) == CON_PLAYING)
+      hdr.players++;
+  PUT(hdr);
+
+  for (d = descriptor_list; d; d = d->next)
+    if (d->character && STATE(d) == CON_PLAYING)
+      put_player(d);
+
+  for (zone = 0; zone <= top_of_zone_table; zone++) {
+    PUT(zone_table[zone].number);
+    PUT(zone_table[zone].last_reset);
+  }
+  PUT(end);
+
+  size = ftell(snap_fl);
+  if (fclose(snap_fl) != 0)
+    snap_ok = FALSE;
+  snap_fl = NULL;
+
+  if (!snap_ok) {
+    log("SYSERR: Writing %s failed, the new process will load players from their files.",
+	COPYOVER_SNAPSHOT);
+    unlink(COPYOVER_SNAPSHOT);
+    return;
+  }
+
+  gettimeofday(&now, (struct timezone *) 0);
+  timediff(&spent, &now, &start);
+  log("Copyover: wrote %d players to %s (%ld bytes) in %ld usecs.", hdr.players,
+	COPYOVER_SNAPSHOT, size, spent.tv_sec * 1000000L + spent.tv_usec);
+}
+
+/* ******************************************************************* */
+
+static char *snap_buf;
+static size_t snap_len, snap_pos;
+
+static bool get(void *data, size_t len)
+{
+  if (!snap_ok || len > snap_len - snap_pos) {
+    snap_ok = FALSE;
+    memset(data, 0, len);
+    return (FALSE);
+  }
+  memcpy(data, snap_buf + snap_pos, len);
+  snap_pos += len;
+  return (TRUE);
+}
+
+#define GET(x)	get(&(x), sizeof(x))
+
+static char *get_str(void)
+{
+  int len = 0;
+  char *str;
+
+  if (!GET(len) || len <= 0)
+    return (NULL);
+  if ((size_t) len > snap_len - snap_pos || snap_buf[snap_pos + len - 1]) {
+    snap_ok = FALSE;
+    return (NULL);
+  }
+  str = strdup(snap_buf + snap_pos);
+  snap_pos += len;
+  return (str);
+}
+
+/* skips what get_str() would have read, for the dry run */
+static void skip_str(void)
+{
+  int len = 0;
+
+  if (GET(len) && len > 0) {
+    if ((size_t) len > snap_len - snap_pos || snap_buf[snap_pos + len - 1])
+      snap_ok = FALSE;
+    else
+      snap_pos += len;
+  }
+}
+
+/* the object strings; NULL leaves the prototype's */
+static void get_obj_str(char **str, int restore)
+{
+  char *s;
+
+  if (!restore) {
+    skip_str();
+    return;
+  }
+  if ((s = get_str()) != NULL)
+    *str = s;
+}
+
+/*
+ * With 'restore' FALSE this only walks the records, checking they are all
+ * there.  Objects whose prototype has gone are dropped; what was in them
+ * goes to the character's inventory.
+ */
+static void get_objs(struct char_data *ch, int restore)
+{
+  struct obj_data *cont[SNAPSHOT_DEPTH], *obj;
+  struct snapshot_obj so;
+  obj_rnum rnum;
+  int i, depth;
+
+  memset(cont, 0, sizeof(cont));
+
+  while (GET(so) && so.vnum != NOTHING) {
+    if (so.depth < 0 || so.worn_on >= NUM_WEARS) {
+      snap_ok = FALSE;
+      return;
+    }
+    depth = MIN(so.depth, SNAPSHOT_DEPTH - 1);
+    if (!restore || (rnum = real_object(so.vnum)) == NOTHING) {
+      if (restore)
+	log("SYSERR: Copyover: %s's object #%d no longer exists.", GET_NAME(ch), so.vnum);
+      for (i = 0; i < 4; i++)
+	skip_str();
+      cont[depth] = NULL;
+      continue;
+    }
+
+    obj = read_object(rnum, REAL);
+    obj->obj_flags = so.flags;
+    set_obj_timer(obj, so.flags.timer);
+    memcpy(obj->affected, so.affected, sizeof(obj->affected));
+    get_obj_str(&obj->name, TRUE);
+    get_obj_str(&obj->description, TRUE);
+    get_obj_str(&obj->short_description, TRUE);
+    get_obj_str(&obj->action_description, TRUE);
+
+    if (depth > 0 && cont[depth - 1])
+      obj_to_obj(obj, cont[depth - 1]);
+    else if (so.worn_on >= 0 && !GET_EQ(ch, so.worn_on))
+      equip_char(ch, obj, so.worn_on);
+    else
+      obj_to_char(obj, ch);
+    cont[depth] = obj;
+  }
+}
+
+/* a character's own record: what it is and where it stands */
+static void get_snapshot_stats(struct char_data *ch, int restore)
+{
+  byte pos;
+
+  if (!restore) {
+    struct char_ability_data abils;
+    struct char_point_data points;
+    struct char_special_data_saved saved;
+    sh_int hit, mana;
+    long act, affected_by;
+
+    GET(abils);
+    GET(points);
+    GET(saved);
+    GET(hit);
+    GET(mana);
+    GET(act);
+    GET(affected_by);
+  } else {
+    GET(ch->real_abils);
+    GET(ch->points);
+    GET(ch->char_specials.saved);
+    GET(GET_HIT(ch));
+    GET(GET_MANA(ch));
+    GET(PLR_FLAGS(ch));
+    GET(AFF_FLAGS(ch));
+    ch->aff_abils = ch->real_abils;
+  }
+
+  GET(pos);
+  if (restore)
+    GET_POS(ch) = (pos == POS_FIGHTING ? POS_STANDING : pos);
+}
+
+/* what it is under and carries; equipping it wants it in a room */
+static void get_snapshot_gear(struct char_data *ch, int restore)
+{
+  struct affected_type aff;
+  int i, num_affs;
+
+  GET(num_affs);
+  if (num_affs < 0 || num_affs > MAX_AFFECT) {
+    snap_ok = FALSE;
+    return;
+  }
+  for (i = 0; i < num_affs; i++)
+    if (GET(aff) && restore)
+      affect_to_char(ch, &aff);
+
+  get_objs(ch, restore);
+}
+
+static void get_snapshot_char(struct char_data *ch, int restore)
+{
+  get_snapshot_stats(ch, restore);
+  get_snapshot_gear(ch, restore);
+}
+
+static void get_follower(struct char_data *ch, int restore)
+{
+  struct char_data *mob = NULL;
+  struct follow_type *k;
+  mob_vnum vnum;
+  mob_rnum rnum;
+
+  GET(vnum);
+  if (restore && (rnum = real_mobile(vnum)) != NOBODY) {
+    mob = read_mobile(rnum, REAL);
+    char_to_room(mob, IN_ROOM(ch));
+  }
+  get_snapshot_char(mob, restore && mob);
+  if (!mob)
+    return;
+
+  /* add_follower() without the messages */
+  mob->master = ch;
+  CREATE(k, struct follow_type, 1);
+  k->follower = mob;
+  k->next = ch->followers;
+  ch->followers = k;
+}
+
+/* what enter_player_game() does, from the snapshot instead of files */
+static void get_player(int restore)
+{
+  struct descriptor_data *d = NULL;
+  struct char_data *ch = NULL;
+  struct char_player_data player;
+  struct player_special_data_saved saved;
+  struct alias_data *a;
+  room_vnum vnum;
+  room_rnum room;
+  socket_t desc;
+  long pref, context;
+  char *host, *telnet, *name = NULL, *value;
+  int i, count, type, lost = FALSE;
+
+  host = get_str();
+  GET(desc);
+  telnet = get_str();
+  GET(pref);
+  GET(player);
+
+  /* nobody by that name any more: read past them and drop the connection */
+  if (restore && (!(name = get_str()) || get_ptable_by_name(name) < 0)) {
+    log("SYSERR: Copyover: %s isn't in the player index.", name ? name : "<no name>");
+    if (name)
+      free(name);
+    name = NULL;
+    lost = TRUE;
+    restore = FALSE;
+  }
+
+  if (restore) {
+    SLAB_CREATE(ch, struct char_data, SLAB_CHAR);
+    clear_char(ch);
+    CREATE(ch->player_specials, struct player_special_data, 1);
+    ch->player = player;
+    GET_PC_NAME(ch) = name;
+    GET_TITLE(ch) = get_str();
+    ch->player.description = get_str();
+    POOFIN(ch) = get_str();
+    POOFOUT(ch) = get_str();
+    GET_HOST(ch) = get_str();
+    GET(ch->player_specials->saved);
+  } else {
+    for (i = (lost ? 1 : 0); i < 6; i++)
+      skip_str();
+    GET(saved);
+  }
+  GET(vnum);
+
+  /* the record goes in first: the id, flags and room all come from it */
+  if (restore)
+    reset_char(ch);
+  get_snapshot_stats(ch, restore);
+
+  if (restore) {
+    GET_PFILEPOS(ch) = get_ptable_by_name(GET_NAME(ch));
+    REMOVE_BIT(PLR_FLAGS(ch), PLR_WRITING | PLR_MAILING | PLR_CRYO);
+    GET_PREF(ch) = pref;
+    ch->player.time.logon = time(0);
+
+    GET_ID(ch) = GET_IDNUM(ch);
+    add_to_lookup_table(GET_ID(ch), (void *) ch);
+    ch->next = character_list;
+    character_list = ch;
+
+    if ((room = real_room(vnum)) == NOWHERE)
+      room = (GET_LEVEL(ch) >= LVL_IMMORT ? r_immort_start_room : r_mortal_start_room);
+    if (PLR_FLAGGED(ch, PLR_FROZEN))
+      room = r_frozen_start_room;
+    char_to_room(ch, room);
+  }
+
+  get_snapshot_gear(ch, restore);
+
+  GET(count);
+  for (i = 0; i < count && snap_ok; i++) {
+    if (!restore) {
+      skip_str();
+      skip_str();
+      GET(type);
+      continue;
+    }
+    CREATE(a, struct alias_data, 1);
+    a->alias = get_str();
+    a->replacement = get_str();
+    GET(a->type);
+    if (!a->alias || !a->replacement) {
+      snap_ok = FALSE;
+      break;
+    }
+    a->next = GET_ALIASES(ch);
+    GET_ALIASES(ch) = a;
+  }
+
+  if (restore)
+    CREATE(SCRIPT(ch), struct script_data, 1);
+  GET(count);
+  for (i = 0; i < count && snap_ok; i++) {
+    if (!restore) {
+      skip_str();
+      skip_str();
+      GET(context);
+      continue;
+    }
+    name = get_str();
+    value = get_str();
+    GET(context);
+    if (name && value)
+      add_var(&(SCRIPT(ch)->global_vars), name, value, context);
+    if (name)
+      free(name);
+    if (value)
+      free(value);
+  }
+
+  GET(count);
+  for (i = 0; i < count && snap_ok; i++)
+    get_follower(ch, restore);
+
+  if (lost && (d = copyover_descriptor(desc, host ? host : "")) != NULL) {
+    write_to_descriptor(desc, "\n\rSomehow, your character was lost in the copyover. Sorry.\n\r");
+    close_socket(d);
+  }
+
+  /* someone whose connection went in the meantime is left linkless */
+  if (restore && (d = copyover_descriptor(desc, host ? host : "")) != NULL) {
+    telnet_restore(d, telnet);
+    d->character = ch;
+    ch->desc = d;
+    STATE(d) = CON_PLAYING;
+    write_to_descriptor(desc, "\n\rCopyover recovery complete.\n\r");
+    look_at_room(ch, 0);
+  }
+  if (host)
+    free(host);
+  if (telnet)
+    free(telnet);
+}
+
+/*
+ * Called by copyover_recover() once the world is up.  Returns FALSE if
+ * there is no usable snapshot, having restored nothing, and the players
+ * are to be loaded from COPYOVER_FILE instead.
+ */
+int read_copyover_snapshot(void)
+{
+  struct snapshot_header hdr;
+  struct timeval start, now, spent;
+  int layout[SNAPSHOT_LAYOUTS], i, restore, end;
+  zone_vnum vnum;
+  zone_rnum zone;
+  time_t last_reset;
+  FILE *fl;
+  long size;
+
+  gettimeofday(&start, (struct timezone *) 0);
+
+  if (!(fl = fopen(COPYOVER_SNAPSHOT, "rb"))) {
+    log("Copyover: no %s, loading players from their files.", COPYOVER_SNAPSHOT);
+    return (FALSE);
+  }
+  unlink(COPYOVER_SNAPSHOT);
+
+  fseek(fl, 0, SEEK_END);
+  size = ftell(fl);
+  rewind(fl);
+  if (size <= 0) {
+    fclose(fl);
+    return (FALSE);
+  }
+  CREATE(snap_buf, char, size);
+  snap_len = fread(snap_buf, 1, size, fl);
+  fclose(fl);
+
+  snapshot_layout(layout);
+
+  /* once to check the whole thing is there, then once for real */
+  for (restore = FALSE; restore <= TRUE; restore++) {
+    snap_pos = 0;
+    snap_ok = TRUE;
+
+    GET(hdr);
+    if (!snap_ok || memcmp(hdr.magic, SNAPSHOT_MAGIC, sizeof(hdr.magic)) ||
+	hdr.version != SNAPSHOT_VERSION || memcmp(hdr.layout, layout, sizeof(layout))) {
+      log("Copyover: %s is from a different build, loading players from their files.",
+	  COPYOVER_SNAPSHOT);
+      free(snap_buf);
+      snap_buf = NULL;
+      return (FALSE);
+    }
+
+    for (i = 0; i < hdr.players && snap_ok; i++)
+      get_player(restore);
+
+    for (i = 0; i < hdr.zones && snap_ok; i++) {
+      GET(vnum);
+      GET(last_reset);
+      if (restore && (zone = real_zone(vnum)) != NOWHERE) {
+	zone_table[zone].last_reset = last_reset;
+	schedule_zone_reset(zone);
+      }
+    }
+
+    GET(end);
+    if (!snap_ok || end != SNAPSHOT_END) {
+      /* only the dry run can get here; it has restored nothing */
+      log("SYSERR: Copyover: %s is damaged, loading players from their files.",
+	  COPYOVER_SNAPSHOT);
+      free(snap_buf);
+      snap_buf = NULL;
+      return (FALSE);
+    }
+  }
+
+  boot_time = hdr.boot_time;
+  free(snap_buf);
+  snap_buf = NULL;
+
+  gettimeofday(&now, (struct timezone *) 0);
+  timediff(&spent, &now, &start);
+  log("Copyover: restored %d players from %s in %ld usecs.", hdr.players,
+	COPYOVER_SNAPSHOT, spent.tv_sec * 1000000L + spent.tv_usec);
+  return (TRUE);
+}
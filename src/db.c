@@ -25,6 +25,7 @@
 #include "house.h"
 #include "constants.h"
 #include "oasis.h"
+#include "genwld.h"
 #include "dg_scripts.h"
 #include "dg_event.h"
 
@@ -95,7 +96,6 @@ int top_of_socialt = -1;                        /* number of socials */
 struct time_info_data time_info;/* the infomation about the time    */
 struct weather_data weather_info;	/* the infomation about the weather */
 struct player_special_data dummy_mob;	/* dummy spec area for mobs	*/
-struct reset_q_type reset_q;	/* queue of zones to be reset	 */
 
 /* local functions */
 int check_bitvector_names(bitvector_t bits, size_t namecount, const char *whatami, const char *whatbits);
@@ -161,6 +161,9 @@ void clean_llog_entries(void);
 void create_command_list(void);
 void build_player_index(void);
 void clean_pfiles(void);
+void timediff(struct timeval *diff, struct timeval *a, struct timeval *b);
+void char_catch_up(struct char_data *ch, int ticks);	/* In limits.c */
+void run_held_obj_timer(struct obj_data *obj);
 
 /* external vars */
 extern struct descriptor_data *descriptor_list;
@@ -383,6 +386,7 @@ void destroy_db(void)
       extract_script(&world[cnt], WLD_TRIGGER);
     /* free script proto list */
     free_proto_script(&world[cnt], WLD_TRIGGER);
+    free_speech_index(world[cnt].speech);
     
     for (itr = 0; itr < NUM_OF_DIRS; itr++) {
       if (!world[cnt].dir_option[itr])
@@ -397,6 +401,7 @@ void destroy_db(void)
   }
   free(world);
   top_of_world = 0;
+  path_free();
   
   /* Objects */
   for (cnt = 0; cnt <= top_of_objt; cnt++) {
@@ -467,15 +472,10 @@ void destroy_db(void)
 
 #undef THIS_CMD
 
-  /* zone table reset queue */
-  if (reset_q.head) {
-    struct reset_q_element *ftemp=reset_q.head, *temp;
-    while (ftemp) {
-      temp = ftemp->next;
-      free(ftemp);
-      ftemp = temp;
-    }   
-  }
+  /* zone reset schedule */
+  free_reset_heap();
+  free_vnum_tables();
+  free_name_indexes();
     
   /* Triggers */
   for (cnt=0; cnt < top_of_trigt; cnt++) {
@@ -495,6 +495,8 @@ void destroy_db(void)
       }
       free_trigger(trig_index[cnt]->proto);
     }
+    if (trig_index[cnt]->prof)
+      free(trig_index[cnt]->prof);
     free(trig_index[cnt]);
   }
   free(trig_index);
@@ -626,8 +628,6 @@ void boot_db(void)
     reset_zone(i);
   }
 
-  reset_q.head = reset_q.tail = NULL;
-
   if (!boot_time)
     boot_time = time(0);
 
@@ -903,6 +903,11 @@ void index_boot(int mode)
   }
   fclose(db_index);
 
+  /* index the vnums just loaded */
+  if (mode == DB_BOOT_WLD || mode == DB_BOOT_MOB || mode == DB_BOOT_OBJ ||
+      mode == DB_BOOT_ZON)
+    vnum_reindex(mode, 0);
+
   /* sort the help index */
   if (mode == DB_BOOT_HLP) {
     qsort(help_table, top_of_h_table, sizeof(struct help_index_element), hsort);
@@ -1754,9 +1759,11 @@ void load_zones(FILE *fl, char *zonename)
   if ((ptr = strchr(buf, '~')) != NULL)	/* take off the '~' if it's there */
     *ptr = '\0';
   Z.name = strdup(buf);
+  Z.reset_heap_pos = -1;
+  Z.emptied_at = time(0);
 
   line_num += get_line(fl, buf);
-  if (sscanf(buf, " %hd %hd %d %d ", &Z.bot, &Z.top, &Z.lifespan, &Z.reset_mode) != 4) {
+  if (sscanf(buf, " %hd %hd %d %d %d ", &Z.bot, &Z.top, &Z.lifespan, &Z.reset_mode, &Z.zone_flags) < 4) {
     /*
      * This may be due to the fact that the zone has no builder.  So, we just attempt
      * to fix this by copying the previous 2 last reads into this variable and the
@@ -1857,15 +1864,197 @@ void get_one_line(FILE *fl, char *buf)
 *  procedures for resetting, both play-time and boot-time               *
 *************************************************************************/ 
 
+/*
+ * Name indexes for 'vnum'.  Each holds every word of the mobiles' or
+ * objects' keywords, the room titles or the trigger names, lowercased and
+ * sorted, with the rnum it came from; isname() matches a search that is
+ * the start of any word, which is a binary search and a short walk here.
+ * OLC marks an index stale whenever it changes that table, and the next
+ * search builds it again.  A search with a space in it can only match a
+ * whole name, so it still goes through the table the long way.
+ */
+struct name_key {
+  const char *word;
+  IDXTYPE rnum;
+};
+
+struct name_index {
+  struct name_key *keys;
+  char *words;		/* every word, each ending in a NUL */
+  int count;
+  bool built;
+};
+
+static struct name_index name_indexes[NUM_NAME_INDEXES];
+
+void name_index_stale(int which)
+{
+  name_indexes[which].built = FALSE;
+}
+
+void free_name_indexes(void)
+{
+  int i;
+
+  for (i = 0; i < NUM_NAME_INDEXES; i++) {
+    if (name_indexes[i].keys)
+      free(name_indexes[i].keys);
+    if (name_indexes[i].words)
+      free(name_indexes[i].words);
+    name_indexes[i].keys = NULL;
+    name_indexes[i].words = NULL;
+    name_indexes[i].built = FALSE;
+  }
+}
+
+static int name_index_size(int which)
+{
+  switch (which) {
+  case NAME_INDEX_MOB:  return (top_of_mobt + 1);
+  case NAME_INDEX_OBJ:  return (top_of_objt + 1);
+  case NAME_INDEX_ROOM: return (top_of_world + 1);
+  case NAME_INDEX_TRIG: return (top_of_trigt);
+  }
+  return (0);
+}
+
+static const char *indexed_name(int which, int rnum)
+{
+  switch (which) {
+  case NAME_INDEX_MOB:  return (mob_proto[rnum].player.name);
+  case NAME_INDEX_OBJ:  return (obj_proto[rnum].name);
+  case NAME_INDEX_ROOM: return (world[rnum].name);
+  case NAME_INDEX_TRIG: return (trig_index[rnum]->proto ? trig_index[rnum]->proto->name : NULL);
+  }
+  return (NULL);
+}
+
+static IDXTYPE indexed_vnum(int which, int rnum)
+{
+  switch (which) {
+  case NAME_INDEX_MOB:  return (mob_index[rnum].vnum);
+  case NAME_INDEX_OBJ:  return (obj_index[rnum].vnum);
+  case NAME_INDEX_ROOM: return (world[rnum].number);
+  case NAME_INDEX_TRIG: return (trig_index[rnum]->vnum);
+  }
+  return (NOWHERE);
+}
+
+static int name_key_compare(const void *a, const void *b)
+{
+  return (strcmp(((const struct name_key *) a)->word, ((const struct name_key *) b)->word));
+}
+
+static void build_name_index(int which)
+{
+  struct name_index *ni = &name_indexes[which];
+  int i, size = name_index_size(which), len = 0, max_keys = 0;
+  const char *name;
+  char *w;
+
+  if (ni->keys)
+    free(ni->keys);
+  if (ni->words)
+    free(ni->words);
+
+  for (i = 0; i < size; i++)
+    if ((name = indexed_name(which, i)) != NULL) {
+      len += strlen(name) + 1;
+      max_keys += strlen(name) / 2 + 1;	/* words are at least one apart */
+    }
+
+  CREATE(ni->words, char, len + 1);
+  CREATE(ni->keys, struct name_key, max_keys + 1);
+  ni->count = 0;
+
+  for (w = ni->words, i = 0; i < size; i++) {
+    if ((name = indexed_name(which, i)) == NULL)
+      continue;
+    for (;;) {
+      while (*name == ' ' || *name == '\t')
+        name++;
+      if (!*name)
+        break;
+      ni->keys[ni->count].word = w;
+      ni->keys[ni->count++].rnum = i;
+      for (; *name && *name != ' ' && *name != '\t'; name++)
+        *w++ = LOWER(*name);
+      *w++ = '\0';
+    }
+  }
+
+  qsort(ni->keys, ni->count, sizeof(struct name_key), name_key_compare);
+  ni->built = TRUE;
+}
+
+struct name_hit {
+  IDXTYPE vnum, rnum;
+};
+
+static int name_hit_compare(const void *a, const void *b)
+{
+  return (((const struct name_hit *) a)->vnum - ((const struct name_hit *) b)->vnum);
+}
+
+/* finds what isname(searchname, <name>) would, by vnum; free '*hits' after */
+static int name_search(int which, char *searchname, struct name_hit **hits)
+{
+  struct name_index *ni = &name_indexes[which];
+  char word[MAX_INPUT_LENGTH];
+  int i, bot, top, mid, len, found = 0, max;
+
+  for (len = 0; searchname[len] && len < (int) sizeof(word) - 1; len++)
+    word[len] = LOWER(searchname[len]);
+  word[len] = '\0';
+
+  if (strchr(word, ' ') || strchr(word, '\t')) {
+    max = name_index_size(which);
+    CREATE(*hits, struct name_hit, max + 1);
+    for (i = 0; i < max; i++)
+      if (isname(searchname, indexed_name(which, i)))
+        (*hits)[found++].rnum = i;
+  } else {
+    if (!ni->built)
+      build_name_index(which);
+
+    /* the first word that doesn't sort before the search */
+    for (bot = 0, top = ni->count; bot < top; ) {
+      mid = (bot + top) / 2;
+      if (strcmp(ni->keys[mid].word, word) < 0)
+        bot = mid + 1;
+      else
+        top = mid;
+    }
+    for (max = bot; max < ni->count && !strncmp(ni->keys[max].word, word, len); max++);
+
+    CREATE(*hits, struct name_hit, max - bot + 1);
+    for (i = bot; i < max; i++)
+      (*hits)[found++].rnum = ni->keys[i].rnum;
+  }
+
+  /* sort by vnum and drop a second word of the same name */
+  for (i = 0; i < found; i++)
+    (*hits)[i].vnum = indexed_vnum(which, (*hits)[i].rnum);
+  qsort(*hits, found, sizeof(struct name_hit), name_hit_compare);
+  for (i = max = 0; i < found; i++)
+    if (!max || (*hits)[max - 1].rnum != (*hits)[i].rnum)
+      (*hits)[max++] = (*hits)[i];
+
+  return (max);
+}
+
 int vnum_mobile(char *searchname, struct char_data *ch)
 {
-  int nr, found = 0;
+  struct name_hit *hits;
+  int i, nr, found = name_search(NAME_INDEX_MOB, searchname, &hits);
 
-  for (nr = 0; nr <= top_of_mobt; nr++)
-    if (isname(searchname, mob_proto[nr].player.name))
-      send_to_char(ch, "%3d. [%5d] %-40s %s\r\n", 
-                   ++found, mob_index[nr].vnum, mob_proto[nr].player.short_descr,
-                   mob_proto[nr].proto_script ? "[TRIG]" : "" );
+  for (i = 0; i < found; i++) {
+    nr = hits[i].rnum;
+    send_to_char(ch, "%3d. [%5d] %-40s %s\r\n", 
+                 i + 1, mob_index[nr].vnum, mob_proto[nr].player.short_descr,
+                 mob_proto[nr].proto_script ? "[TRIG]" : "" );
+  }
+  free(hits);
 
   return (found);
 }
@@ -1874,36 +2063,48 @@ int vnum_mobile(char *searchname, struct char_data *ch)
 
 int vnum_object(char *searchname, struct char_data *ch)
 {
-  int nr, found = 0;
+  struct name_hit *hits;
+  int i, nr, found = name_search(NAME_INDEX_OBJ, searchname, &hits);
 
-  for (nr = 0; nr <= top_of_objt; nr++)
-    if (isname(searchname, obj_proto[nr].name))
-      send_to_char(ch, "%3d. [%5d] %-40s %s\r\n", 
-                   ++found, obj_index[nr].vnum, obj_proto[nr].short_description,
-                   obj_proto[nr].proto_script ? "[TRIG]" : "" );
+  for (i = 0; i < found; i++) {
+    nr = hits[i].rnum;
+    send_to_char(ch, "%3d. [%5d] %-40s %s\r\n", 
+                 i + 1, obj_index[nr].vnum, obj_proto[nr].short_description,
+                 obj_proto[nr].proto_script ? "[TRIG]" : "" );
+  }
+  free(hits);
 
   return (found);
 }
 
 int vnum_room(char *searchname, struct char_data *ch)
 {
- int nr, found = 0;
+  struct name_hit *hits;
+  int i, nr, found = name_search(NAME_INDEX_ROOM, searchname, &hits);
+
+  for (i = 0; i < found; i++) {
+    nr = hits[i].rnum;
+    send_to_char(ch, "%3d. [%5d] %-40s %s\r\n",
+                 i + 1, world[nr].number, world[nr].name,
+                 world[nr].proto_script ? "[TRIG]" : "" );
+  }
+  free(hits);
 
- for (nr = 0; nr <= top_of_world; nr++)
-   if (isname(searchname, world[nr].name))
-   send_to_char(ch, "%3d. [%5d] %-40s %s\r\n",
-   ++found, world[nr].number, world[nr].name,
-  world[nr].proto_script ? "[TRIG]" : "" );
   return (found);
 }
 
 int vnum_trig(char *searchname, struct char_data *ch)
 {
- int nr, found = 0;
-  for (nr = 0; nr < top_of_trigt; nr++)
-    if (isname(searchname, trig_index[nr]->proto->name))
+  struct name_hit *hits;
+  int i, nr, found = name_search(NAME_INDEX_TRIG, searchname, &hits);
+
+  for (i = 0; i < found; i++) {
+    nr = hits[i].rnum;
     send_to_char(ch, "%3d. [%5d] %-40s\r\n",
-    ++found, trig_index[nr]->vnum, trig_index[nr]->proto->name);
+                 i + 1, trig_index[nr]->vnum, trig_index[nr]->proto->name);
+  }
+  free(hits);
+
   return (found);
 } 
 
@@ -1912,7 +2113,7 @@ struct char_data *create_char(void)
 {
   struct char_data *ch;
 
-  CREATE(ch, struct char_data, 1);
+  SLAB_CREATE(ch, struct char_data, SLAB_CHAR);
   clear_char(ch);
   ch->next = character_list;
   character_list = ch;
@@ -1939,19 +2140,21 @@ struct char_data *read_mobile(mob_vnum nr, int type) /* and mob_rnum */
   } else
     i = nr;
 
-  CREATE(mob, struct char_data, 1);
+  SLAB_CREATE(mob, struct char_data, SLAB_CHAR);
   clear_char(mob);
-  *mob = mob_proto[i];
+  copy_char(mob, mob_proto + i);
+  mob->ref_slot = 0;
   mob->next = character_list;
   character_list = mob;
+  add_mob_instance(mob);
 
   if (!mob->points.max_hit) {
-    mob->points.max_hit = dice(mob->points.hit, mob->points.mana);
+    mob->points.max_hit = dice(GET_HIT(mob), GET_MANA(mob));
   } else
-    mob->points.max_hit = rand_number(mob->points.hit, mob->points.mana);
+    mob->points.max_hit = rand_number(GET_HIT(mob), GET_MANA(mob));
 
-  mob->points.hit = mob->points.max_hit;
-  mob->points.mana = mob->points.max_mana;
+  GET_HIT(mob) = mob->points.max_hit;
+  GET_MANA(mob) = mob->points.max_mana;
 
   mob->player.time.birth = time(0);
   mob->player.time.played = 0;
@@ -1975,7 +2178,7 @@ struct obj_data *create_obj(void)
 {
   struct obj_data *obj;
 
-  CREATE(obj, struct obj_data, 1);
+  SLAB_CREATE(obj, struct obj_data, SLAB_OBJ);
   clear_object(obj);
   obj->next = object_list;
   object_list = obj;
@@ -1999,11 +2202,14 @@ struct obj_data *read_object(obj_vnum nr, int type) /* and obj_rnum */
     return (NULL);
   }
 
-  CREATE(obj, struct obj_data, 1);
+  SLAB_CREATE(obj, struct obj_data, SLAB_OBJ);
   clear_object(obj);
   *obj = obj_proto[i];
   obj->next = object_list;
   object_list = obj;
+  add_obj_instance(obj);
+  if (obj->obj_flags.timer)
+    set_obj_timer(obj, obj->obj_flags.timer);
 
   obj_index[i].number++;
 
@@ -2019,79 +2225,6 @@ struct obj_data *read_object(obj_vnum nr, int type) /* and obj_rnum */
 
 
 
-#define ZO_DEAD  999
-
-/* update zone ages, queue for reset if necessary, and dequeue when possible */
-void zone_update(void)
-{
-  int i;
-  struct reset_q_element *update_u, *temp;
-  static int timer = 0;
-
-  /* jelson 10/22/92 */
-  if (((++timer * PULSE_ZONE) / PASSES_PER_SEC) >= 60) {
-    /* one minute has passed */
-    /*
-     * NOT accurate unless PULSE_ZONE is a multiple of PASSES_PER_SEC or a
-     * factor of 60
-     */
-
-    timer = 0;
-
-    /* since one minute has passed, increment zone ages */
-    for (i = 0; i <= top_of_zone_table; i++) {
-      if (zone_table[i].age < zone_table[i].lifespan &&
-	  zone_table[i].reset_mode)
-	(zone_table[i].age)++;
-
-      if (zone_table[i].age >= zone_table[i].lifespan &&
-	  zone_table[i].age < ZO_DEAD && zone_table[i].reset_mode) {
-	/* enqueue zone */
-
-	CREATE(update_u, struct reset_q_element, 1);
-
-	update_u->zone_to_reset = i;
-	update_u->next = 0;
-
-	if (!reset_q.head)
-	  reset_q.head = reset_q.tail = update_u;
-	else {
-	  reset_q.tail->next = update_u;
-	  reset_q.tail = update_u;
-	}
-
-	zone_table[i].age = ZO_DEAD;
-      }
-    }
-  }	/* end - one minute has passed */
-
-
-  /* dequeue zones (if possible) and reset */
-  /* this code is executed every 10 seconds (i.e. PULSE_ZONE) */
-  for (update_u = reset_q.head; update_u; update_u = update_u->next)
-    if (zone_table[update_u->zone_to_reset].reset_mode == 2 ||
-	is_empty(update_u->zone_to_reset)) {
-      reset_zone(update_u->zone_to_reset);
-      mudlog(CMP, LVL_IMPL, FALSE, "Auto zone reset: %s (Zone %d)", 
-          zone_table[update_u->zone_to_reset].name, zone_table[update_u->zone_to_reset].number);
-      /* dequeue */
-      if (update_u == reset_q.head)
-	reset_q.head = reset_q.head->next;
-      else {
-	for (temp = reset_q.head; temp->next != update_u;
-	     temp = temp->next);
-
-	if (!update_u->next)
-	  reset_q.tail = temp;
-
-	temp->next = update_u->next;
-      }
-
-      free(update_u);
-      break;
-    }
-}
-
 void log_zone_error(zone_rnum zone, int cmd_no, const char *message)
 {
   mudlog(NRM, LVL_GOD, TRUE, "SYSERR: zone file: %s", message);
@@ -2102,18 +2235,92 @@ void log_zone_error(zone_rnum zone, int cmd_no, const char *message)
 #define ZONE_ERROR(message) \
 	{ log_zone_error(zone, cmd_no, message); last_cmd = 0; }
 
-/* execute the reset command table of a given zone */
-void reset_zone(zone_rnum zone)
+/*
+ * Queued zone resets are run a slice at a time: one zone at a time, and
+ * at most CONFIG_ZONE_RESET_BUDGET zone commands a pulse.  A slice only
+ * ends where a new if_flag chain starts, so nobody sees a mob that has
+ * been loaded but not yet equipped, and the mobs later commands may
+ * still refer back to are kept by char_ref in case they die meanwhile.
+ * The zone is remembered by its vnum and its place in the command list
+ * by position, so zone and command edits between slices can't leave
+ * either dangling.  reset_zone() still does a whole zone at once, for
+ * boot and zreset.
+ */
+struct reset_progress {
+  zone_vnum zone;		/* NOWHERE when nothing is being reset	*/
+  int cmd_no;			/* next command to run			*/
+  int last_cmd;			/* whether the one before it did anything */
+  struct char_ref mob;		/* last mob loaded, for 'G' and 'E'	*/
+  struct char_ref tmob;		/* last mob loaded, for 'T' and 'V'	*/
+};
+
+static struct reset_progress zone_resetting = { NOWHERE, 0, 0, { 0, 0 }, { 0, 0 } };
+unsigned long zone_reset_slices = 0;	/* resets cut short by the budget */
+
+static void start_zone_reset(struct reset_progress *rp, zone_rnum zone)
+{
+  wake_zone(zone);
+  rp->zone = zone_table[zone].number;
+  rp->cmd_no = rp->last_cmd = 0;
+  rp->mob = rp->tmob = ref_char(NULL);
+}
+
+/* charge a slice to the zone's reset times, shown by 'show resets' */
+static void time_zone_reset(zone_rnum zone, struct timeval *start, int finished)
 {
-  int cmd_no, last_cmd = 0;
-  struct char_data *mob = NULL;
+  struct timeval stop, spent;
+  unsigned long usec;
+
+  gettimeofday(&stop, (struct timezone *) 0);
+  timediff(&spent, &stop, start);
+  usec = spent.tv_sec * 1000000 + spent.tv_usec;
+  zone_table[zone].reset_usec += usec;
+  zone_table[zone].reset_max_usec = MAX(zone_table[zone].reset_max_usec, usec);
+  if (finished)
+    zone_table[zone].resets++;
+}
+
+/*
+ * Runs the reset commands of rp->zone from rp->cmd_no on, taking each
+ * one out of *budget if there is one.  When the budget runs out, stops
+ * at the next chain that starts and returns FALSE to be called again
+ * later; returns TRUE once the zone is done.
+ */
+static int run_zone_reset_cmds(struct reset_progress *rp, int *budget)
+{
+  zone_rnum zone;
+  int cmd_no, last_cmd;
+  struct char_data *mob;
   struct obj_data *obj, *obj_to;
   room_vnum rvnum;
   room_rnum rrnum;
-  struct char_data *tmob=NULL; /* for trigger assignment */
+  struct char_data *tmob; /* for trigger assignment */
   struct obj_data *tobj=NULL;  /* for trigger assignment */
-
-  for (cmd_no = 0; ZCMD.command != 'S'; cmd_no++) {
+  struct timeval start;
+
+  if ((zone = real_zone(rp->zone)) == NOWHERE)
+    return (TRUE);	/* deleted since the last slice */
+
+  gettimeofday(&start, (struct timezone *) 0);
+
+  /* the command list may have been shortened since the last slice */
+  for (cmd_no = 0; cmd_no < rp->cmd_no && ZCMD.command != 'S'; cmd_no++);
+  last_cmd = rp->last_cmd;
+  mob = deref_char(rp->mob);
+  tmob = deref_char(rp->tmob);
+
+  for (; ZCMD.command != 'S'; cmd_no++) {
+
+    if (budget && (*budget)-- <= 0 && !ZCMD.if_flag &&
+	!strchr("GETV", ZCMD.command)) {
+      rp->cmd_no = cmd_no;
+      rp->last_cmd = last_cmd;
+      rp->mob = ref_char(mob);
+      rp->tmob = ref_char(tmob);
+      time_zone_reset(zone, &start, FALSE);
+      zone_reset_slices++;
+      return (FALSE);
+    }
 
     if (ZCMD.if_flag && !last_cmd)
       continue;
@@ -2150,7 +2357,7 @@ void reset_zone(zone_rnum zone)
           tobj = obj;
 	} else {
 	  obj = read_object(ZCMD.arg1, REAL);
-	  IN_ROOM(obj) = NOWHERE;
+	  OBJ_IN_ROOM(obj) = NOWHERE;
 	  last_cmd = 1;
           tobj = obj;
 	}
@@ -2210,10 +2417,10 @@ void reset_zone(zone_rnum zone)
 	  ZONE_ERROR(error);
 	} else {
 	  obj = read_object(ZCMD.arg1, REAL);
-          IN_ROOM(obj) = IN_ROOM(mob);
+          OBJ_IN_ROOM(obj) = IN_ROOM(mob);
           load_otrigger(obj);
           if (wear_otrigger(obj, mob, ZCMD.arg3)) {
-            IN_ROOM(obj) = NOWHERE;
+            OBJ_IN_ROOM(obj) = NOWHERE;
             equip_char(mob, obj, ZCMD.arg3);
           } else
             obj_to_char(obj, mob);
@@ -2241,7 +2448,9 @@ void reset_zone(zone_rnum zone)
         snprintf(error, sizeof(error), "door does not exist in room %d - dir %d, command disabled",  world[ZCMD.arg1].number, ZCMD.arg2);
 	ZONE_ERROR(error);
 	ZCMD.command = '*';
-      } else
+      } else {
+	int was_closed = EXIT_FLAGGED(world[ZCMD.arg1].dir_option[ZCMD.arg2], EX_CLOSED);
+
 	switch (ZCMD.arg3) {
 	case 0:
 	  REMOVE_BIT(world[ZCMD.arg1].dir_option[ZCMD.arg2]->exit_info,
@@ -2262,6 +2471,9 @@ void reset_zone(zone_rnum zone)
 		  EX_CLOSED);
 	  break;
 	}
+	if (was_closed != EXIT_FLAGGED(world[ZCMD.arg1].dir_option[ZCMD.arg2], EX_CLOSED))
+	  path_doors_changed();
+      }
       last_cmd = 1;
       tmob = NULL;
       tobj = NULL;
@@ -2326,8 +2538,6 @@ void reset_zone(zone_rnum zone)
     }
   }
 
-  zone_table[zone].age = 0;
-
   /* handle reset_wtrigger's */
   rvnum = zone_table[zone].bot;
   while (rvnum <= zone_table[zone].top) {
@@ -2335,6 +2545,306 @@ void reset_zone(zone_rnum zone)
     if (rrnum != NOWHERE) reset_wtrigger(&world[rrnum]);
     rvnum++;
   }
+
+  time_zone_reset(zone, &start, TRUE);
+  zone_table[zone].last_reset = time(0);
+  schedule_zone_reset(zone);
+  return (TRUE);
+}
+
+/* loads draw from their own stream, so what they hand out can be replayed */
+static int run_zone_reset(struct reset_progress *rp, int *budget)
+{
+  int was = rng_use(RNG_LOOT), done;
+
+  done = run_zone_reset_cmds(rp, budget);
+  rng_use(was);
+  return (done);
+}
+
+/* execute the reset command table of a given zone, all at once */
+void reset_zone(zone_rnum zone)
+{
+  struct reset_progress rp;
+
+  /* this overtakes a reset of the same zone that is under way */
+  if (zone_resetting.zone == zone_table[zone].number)
+    zone_resetting.zone = NOWHERE;
+
+  start_zone_reset(&rp, zone);
+  run_zone_reset(&rp, NULL);
+}
+
+/*
+ * Zones waiting for their next reset are kept in a binary heap ordered by
+ * when they are due, so finding the zones to reset is a look at the top
+ * of the heap rather than a walk over every zone.  A zone that comes due
+ * while players it has to wait for are in it leaves the heap and waits
+ * until char_from_room() sees its last player leave, when zone_emptied()
+ * puts it back.  Its due time has passed by then, so it goes first.
+ * Players who don't hold a reset up (linkdead, nohassle) still count as
+ * being there, so check_waiting_zones() also looks at the waiting zones
+ * every PULSE_ZONE, as zone_update() used to look at them all.
+ * The heap holds zone rnums; rebuild_reset_heap() puts it right after
+ * zones are added.
+ */
+static zone_rnum *reset_heap = NULL;
+static int reset_heap_size = 0, reset_heap_max = 0;
+
+#define RESET_DUE(i)	(zone_table[reset_heap[(i)]].reset_due)
+
+static void reset_heap_set(int pos, zone_rnum zone)
+{
+  reset_heap[pos] = zone;
+  zone_table[zone].reset_heap_pos = pos;
+}
+
+static void reset_heap_up(int pos)
+{
+  zone_rnum zone = reset_heap[pos];
+
+  while (pos > 0 && RESET_DUE((pos - 1) / 2) > zone_table[zone].reset_due) {
+    reset_heap_set(pos, reset_heap[(pos - 1) / 2]);
+    pos = (pos - 1) / 2;
+  }
+  reset_heap_set(pos, zone);
+}
+
+static void reset_heap_down(int pos)
+{
+  zone_rnum zone = reset_heap[pos];
+  int child;
+
+  while ((child = pos * 2 + 1) < reset_heap_size) {
+    if (child + 1 < reset_heap_size && RESET_DUE(child + 1) < RESET_DUE(child))
+      child++;
+    if (RESET_DUE(child) >= zone_table[zone].reset_due)
+      break;
+    reset_heap_set(pos, reset_heap[child]);
+    pos = child;
+  }
+  reset_heap_set(pos, zone);
+}
+
+static void reset_heap_push(zone_rnum zone)
+{
+  if (reset_heap_size >= reset_heap_max) {
+    reset_heap_max = MAX(reset_heap_max * 2, top_of_zone_table + 1);
+    RECREATE(reset_heap, zone_rnum, reset_heap_max);
+  }
+  reset_heap_set(reset_heap_size++, zone);
+  reset_heap_up(reset_heap_size - 1);
+}
+
+static void reset_heap_remove(zone_rnum zone)
+{
+  int pos = zone_table[zone].reset_heap_pos;
+
+  if (pos < 0)
+    return;
+
+  zone_table[zone].reset_heap_pos = -1;
+  if (pos == --reset_heap_size)
+    return;
+
+  reset_heap_set(pos, reset_heap[reset_heap_size]);
+  reset_heap_up(pos);
+  reset_heap_down(zone_table[reset_heap[pos]].reset_heap_pos);
+}
+
+/* (re)schedule a zone's next reset from its lifespan; after zedit too */
+void schedule_zone_reset(zone_rnum zone)
+{
+  struct zone_data *z = &zone_table[zone];
+
+  reset_heap_remove(zone);
+  z->reset_waiting = FALSE;
+  z->reset_due = z->last_reset + z->lifespan * SECS_PER_REAL_MIN;
+  if (z->reset_mode)
+    reset_heap_push(zone);
+}
+
+/* called when the last player leaves a zone */
+void zone_emptied(zone_rnum zone)
+{
+  zone_table[zone].emptied_at = time(0);
+  if (zone_table[zone].reset_waiting) {
+    zone_table[zone].reset_waiting = FALSE;
+    reset_heap_push(zone);
+  }
+}
+
+/* every PULSE_ZONE: put back waiting zones left with nobody who counts */
+void check_waiting_zones(void)
+{
+  zone_rnum zone;
+
+  for (zone = 0; zone <= top_of_zone_table; zone++)
+    if (zone_table[zone].reset_waiting && is_empty(zone)) {
+      zone_table[zone].reset_waiting = FALSE;
+      reset_heap_push(zone);
+    }
+}
+
+/* after zone rnums have moved: keep what was scheduled, drop the rest */
+void rebuild_reset_heap(void)
+{
+  zone_rnum zone;
+
+  reset_heap_size = 0;
+  for (zone = 0; zone <= top_of_zone_table; zone++)
+    if (zone_table[zone].reset_heap_pos >= 0)
+      reset_heap_push(zone);
+}
+
+void free_reset_heap(void)
+{
+  if (reset_heap)
+    free(reset_heap);
+  reset_heap = NULL;
+  reset_heap_size = reset_heap_max = 0;
+}
+
+/*
+ * Called every pulse: carries on with the zone being reset, then starts
+ * on the zones that have come due, for as long as the budget lasts.
+ */
+void zone_reset_continue(void)
+{
+  int left = CONFIG_ZONE_RESET_BUDGET, *budget = left > 0 ? &left : NULL;
+  time_t now = time(0);
+  zone_rnum zone;
+  struct zone_data *z;
+
+  for (;;) {
+    if (zone_resetting.zone == NOWHERE) {
+      if (!reset_heap_size || RESET_DUE(0) > now)
+	return;
+
+      zone = reset_heap[0];
+      z = &zone_table[zone];
+      reset_heap_remove(zone);
+
+      /* is_empty() for players who don't count, linkdead or nohassle */
+      if (z->reset_mode == 1 && z->players && !is_empty(zone)) {
+	z->reset_waiting = TRUE;
+	continue;
+      }
+
+      z->auto_resets++;
+      z->reset_lag += now - z->reset_due;
+      z->reset_max_lag = MAX(z->reset_max_lag, (unsigned long) (now - z->reset_due));
+      start_zone_reset(&zone_resetting, zone);
+    }
+
+    if (!run_zone_reset(&zone_resetting, budget))
+      return;
+
+    if ((zone = real_zone(zone_resetting.zone)) != NOWHERE)
+      mudlog(CMP, LVL_IMPL, FALSE, "Auto zone reset: %s (Zone %d)",
+	  zone_table[zone].name, zone_table[zone].number);
+    zone_resetting.zone = NOWHERE;
+
+    if (budget && left <= 0)
+      return;
+  }
+}
+
+/* minutes since the zone was last reset, for the zone listings */
+int zone_age(zone_rnum zone)
+{
+  return ((time(0) - zone_table[zone].last_reset) / SECS_PER_REAL_MIN);
+}
+
+/*
+ * A zone nobody has been in for CONFIG_HIBERNATE_MINUTES hibernates: its
+ * mobs, objects and rooms are passed over by mobile_activity(),
+ * point_update() and the script sweeps.  Affects and object timers run
+ * out on their timer wheels as usual, but timer triggers wait for the
+ * zone to wake.  The zone notes the hibernate_clock, which counts the
+ * hourly updates, and wake_zone() heals its mobs by the updates they
+ * missed and runs the triggers.  Zones wake when a player comes in (see
+ * char_to_room()), when a script looks up something in them by UID and
+ * when they reset.  A player coming in or a script lookup only queues
+ * the wake for the next pulse, since catching up can extract what the
+ * mover or the script is holding.
+ */
+unsigned long hibernate_clock = 0;
+static int wakes_queued = 0;
+
+/* called every mud hour, after the hourly updates */
+void hibernate_zones(void)
+{
+  time_t cutoff = time(0) - CONFIG_HIBERNATE_MINUTES * SECS_PER_REAL_MIN;
+  zone_rnum zone;
+  struct zone_data *z;
+
+  hibernate_clock++;
+
+  for (zone = 0; zone <= top_of_zone_table; zone++) {
+    z = &zone_table[zone];
+
+    if (CONFIG_HIBERNATE_MINUTES <= 0 || ZONE_FLAGGED(zone, ZONE_ALWAYS_ACTIVE)) {
+      wake_zone(zone);
+      continue;
+    }
+    if (z->hibernating || z->players || z->emptied_at > cutoff ||
+	zone_resetting.zone == z->number)
+      continue;
+
+    z->hibernating = TRUE;
+    z->slept_at = hibernate_clock;
+  }
+}
+
+/* bring a hibernating zone up to date and back into the updates */
+void wake_zone(zone_rnum zone)
+{
+  struct zone_data *z = &zone_table[zone];
+  struct char_data *ch;
+  struct obj_data *obj, *next_obj;
+  room_rnum room;
+  int missed;
+
+  if (!z->hibernating)
+    return;
+
+  z->hibernating = FALSE;
+  z->wakes++;
+  if (z->wake_queued) {
+    z->wake_queued = FALSE;
+    wakes_queued--;
+  }
+  if ((missed = hibernate_clock - z->slept_at) <= 0)
+    return;
+
+  for (ch = z->mobs; ch; ch = ch->next_in_zone)
+    char_catch_up(ch, missed);
+
+  /* timer triggers that ran out while it slept; rare enough to look for */
+  for (obj = object_list; obj; obj = next_obj) {
+    next_obj = obj->next;
+    if ((room = obj_room(obj)) != NOWHERE && world[room].zone == zone)
+      run_held_obj_timer(obj);
+  }
+}
+
+void queue_zone_wake(zone_rnum zone)
+{
+  if (zone_table[zone].hibernating && !zone_table[zone].wake_queued) {
+    zone_table[zone].wake_queued = TRUE;
+    wakes_queued++;
+  }
+}
+
+/* called every pulse */
+void wake_queued_zones(void)
+{
+  zone_rnum zone;
+
+  for (zone = 0; wakes_queued > 0 && zone <= top_of_zone_table; zone++)
+    if (zone_table[zone].wake_queued)
+      wake_zone(zone);
 }
 
 
@@ -2344,6 +2854,9 @@ int is_empty(zone_rnum zone_nr)
 {
   struct descriptor_data *i;
 
+  if (!zone_table[zone_nr].players)
+    return (1);
+
   for (i = descriptor_list; i; i = i->next) {
     if (STATE(i) != CON_PLAYING)
       continue;
@@ -2431,6 +2944,8 @@ void free_char(struct char_data *ch)
   int i;
   struct alias_data *a;
 
+  unref_char(ch);
+
   if (ch->player_specials != NULL && ch->player_specials != &dummy_mob) {
     while ((a = GET_ALIASES(ch)) != NULL) {
       GET_ALIASES(ch) = (GET_ALIASES(ch))->next;
@@ -2500,7 +3015,8 @@ void free_char(struct char_data *ch)
   if (GET_ID(ch) != 0) 
   remove_from_lookup_table(GET_ID(ch));
 
-  free(ch);
+  char_hot_free(ch);
+  SLAB_FREE(ch);
 }
 
 
@@ -2526,7 +3042,7 @@ void free_obj(struct obj_data *obj)
   /* find_obj helper */
   remove_from_lookup_table(GET_ID(obj));
 
-  free(obj);
+  SLAB_FREE(obj);
 }
 
 
@@ -2633,7 +3149,7 @@ void reset_char(struct char_data *ch)
   ch->next_fighting = NULL;
   ch->next_in_room = NULL;
   FIGHTING(ch) = NULL;
-  ch->char_specials.position = POS_STANDING;
+  GET_POS(ch) = POS_STANDING;
   ch->mob_specials.default_pos = POS_STANDING;
   ch->char_specials.carry_weight = 0;
   ch->char_specials.carry_items = 0;
@@ -2652,6 +3168,7 @@ void reset_char(struct char_data *ch)
 void clear_char(struct char_data *ch)
 {
   memset((char *) ch, 0, sizeof(struct char_data));
+  char_hot_alloc(ch);
 
   IN_ROOM(ch) = NOWHERE;
   GET_PFILEPOS(ch) = -1;
@@ -2671,7 +3188,7 @@ void clear_object(struct obj_data *obj)
   memset((char *) obj, 0, sizeof(struct obj_data));
 
   obj->item_number = NOTHING;
-  IN_ROOM(obj) = NOWHERE;
+  OBJ_IN_ROOM(obj) = NOWHERE;
   obj->worn_on = NOWHERE;
 }
 
@@ -2766,108 +3283,269 @@ void init_char(struct char_data *ch)
 
 
 
-/* returns the real number of the room with given virtual number */
-room_rnum real_room(room_vnum vnum)
-{
-  room_rnum bot, top, mid;
+/*
+ * vnum -> rnum lookups.  These used to be binary searches over the sorted
+ * tables, which also meant OLC had to insert new rooms, mobiles and
+ * objects in vnum order and renumber everything after them.  Now each
+ * table has a direct index: 256 pages of 256 slots, a page allocated the
+ * first time a vnum in its range is used, each slot holding the rnum for
+ * that vnum or NOWHERE.  A new entry can go at the end of its table and
+ * keep everyone else's rnum; only deleting one still shifts the rest, and
+ * the caller then reindexes from the hole with vnum_reindex().
+ *
+ * The lookups check the slot against the table they point into, so a
+ * stale slot just misses.
+ */
+#define VNUM_PAGE_BITS	8
+#define VNUM_PAGE_SIZE	(1 << VNUM_PAGE_BITS)
+#define VNUM_PAGES	(65536 >> VNUM_PAGE_BITS)
 
-  bot = 0;
-  top = top_of_world;
+struct vnum_table {
+  IDXTYPE *page[VNUM_PAGES];
+  int pages;
+};
 
-  /* perform binary search on world-table */
-  for (;;) {
-    mid = (bot + top) / 2;
+static struct vnum_table room_vnums, mob_vnums, obj_vnums, zone_vnums;
 
-    if ((world + mid)->number == vnum)
-      return (mid);
-    if (bot > top)
-      return (NOWHERE);
-    if (top == 0)
-      return (NOWHERE);
-    if ((world + mid)->number > vnum)
-      top = mid - 1;
-    else
-      bot = mid + 1;
+static struct vnum_table *vnum_table_for(int mode)
+{
+  switch (mode) {
+  case DB_BOOT_WLD: return (&room_vnums);
+  case DB_BOOT_MOB: return (&mob_vnums);
+  case DB_BOOT_OBJ: return (&obj_vnums);
+  case DB_BOOT_ZON: return (&zone_vnums);
   }
+  log("SYSERR: No vnum table for mode %d.", mode);
+  return (NULL);
 }
 
+static IDXTYPE vnum_slot(const struct vnum_table *t, IDXTYPE vnum)
+{
+  ush_int v = (ush_int) vnum;
+  IDXTYPE *page = t->page[v >> VNUM_PAGE_BITS];
 
+  return (page ? page[v & (VNUM_PAGE_SIZE - 1)] : NOWHERE);
+}
 
-/* returns the real number of the monster with given virtual number */
-mob_rnum real_mobile(mob_vnum vnum)
+static void vnum_set(struct vnum_table *t, IDXTYPE vnum, IDXTYPE rnum)
 {
-  mob_rnum bot, top, mid;
+  ush_int v = (ush_int) vnum;
+  IDXTYPE **page = &t->page[v >> VNUM_PAGE_BITS];
 
-  bot = 0;
-  top = top_of_mobt;
+  if (!*page) {
+    if (rnum == NOWHERE)
+      return;
+    CREATE(*page, IDXTYPE, VNUM_PAGE_SIZE);
+    memset(*page, 0xff, sizeof(IDXTYPE) * VNUM_PAGE_SIZE);	/* all NOWHERE */
+    t->pages++;
+  }
+  (*page)[v & (VNUM_PAGE_SIZE - 1)] = rnum;
+}
 
-  /* perform binary search on mob-table */
-  for (;;) {
-    mid = (bot + top) / 2;
+/* point the vnums of rnums 'from' through the end of the table at them */
+void vnum_reindex(int mode, IDXTYPE from)
+{
+  struct vnum_table *t = vnum_table_for(mode);
+  int i;
 
-    if ((mob_index + mid)->vnum == vnum)
-      return (mid);
-    if (bot > top)
-      return (NOBODY);
-    if (top == 0)
-      return (NOBODY);
-    if ((mob_index + mid)->vnum > vnum)
-      top = mid - 1;
-    else
-      bot = mid + 1;
+  if (!t)
+    return;
+
+  switch (mode) {
+  case DB_BOOT_WLD:
+    for (i = from; i <= top_of_world; i++)
+      vnum_set(t, world[i].number, i);
+    break;
+  case DB_BOOT_MOB:
+    for (i = from; i <= top_of_mobt; i++)
+      vnum_set(t, mob_index[i].vnum, i);
+    break;
+  case DB_BOOT_OBJ:
+    for (i = from; i <= top_of_objt; i++)
+      vnum_set(t, obj_index[i].vnum, i);
+    break;
+  case DB_BOOT_ZON:
+    for (i = from; i <= top_of_zone_table; i++)
+      vnum_set(t, zone_table[i].number, i);
+    break;
   }
 }
 
+/* forget a vnum whose entry has been deleted */
+void vnum_unindex(int mode, IDXTYPE vnum)
+{
+  struct vnum_table *t = vnum_table_for(mode);
 
-/* returns the real number of the object with given virtual number */
-obj_rnum real_object(obj_vnum vnum)
+  if (t)
+    vnum_set(t, vnum, NOWHERE);
+}
+
+void free_vnum_tables(void)
 {
-  obj_rnum bot, top, mid;
+  struct vnum_table *tables[] = { &room_vnums, &mob_vnums, &obj_vnums, &zone_vnums };
+  int i, p;
+
+  for (i = 0; i < 4; i++) {
+    for (p = 0; p < VNUM_PAGES; p++)
+      if (tables[i]->page[p]) {
+        free(tables[i]->page[p]);
+        tables[i]->page[p] = NULL;
+      }
+    tables[i]->pages = 0;
+  }
+}
 
-  bot = 0;
-  top = top_of_objt;
 
-  /* perform binary search on obj-table */
-  for (;;) {
-    mid = (bot + top) / 2;
+/* returns the real number of the room with given virtual number */
+room_rnum real_room(room_vnum vnum)
+{
+  room_rnum rnum = vnum_slot(&room_vnums, vnum);
 
-    if ((obj_index + mid)->vnum == vnum)
-      return (mid);
-    if (bot > top)
-      return (NOTHING);
-    if (top == 0)
-      return (NOTHING);
-    if ((obj_index + mid)->vnum > vnum)
-      top = mid - 1;
-    else
-      bot = mid + 1;
-  }
+  if (rnum != NOWHERE && rnum <= top_of_world && world[rnum].number == vnum)
+    return (rnum);
+  return (NOWHERE);
+}
+
+
+/* returns the real number of the monster with given virtual number */
+mob_rnum real_mobile(mob_vnum vnum)
+{
+  mob_rnum rnum = vnum_slot(&mob_vnums, vnum);
+
+  if (rnum != NOWHERE && rnum <= top_of_mobt && mob_index[rnum].vnum == vnum)
+    return (rnum);
+  return (NOBODY);
+}
+
+
+/* returns the real number of the object with given virtual number */
+obj_rnum real_object(obj_vnum vnum)
+{
+  obj_rnum rnum = vnum_slot(&obj_vnums, vnum);
+
+  if (rnum != NOWHERE && rnum <= top_of_objt && obj_index[rnum].vnum == vnum)
+    return (rnum);
+  return (NOTHING);
 }
 
 
 /* returns the real number of the zone with given virtual number */
 zone_rnum real_zone(zone_vnum vnum)
 {
-  zone_rnum bot, top, mid;
+  zone_rnum rnum = vnum_slot(&zone_vnums, vnum);
 
-  bot = 0;
-  top = top_of_zone_table;
+  if (rnum != NOWHERE && rnum <= top_of_zone_table && zone_table[rnum].number == vnum)
+    return (rnum);
+  return (NOWHERE);
+}
 
-  /* perform binary search on zone-table */
-  for (;;) {
-    mid = (bot + top) / 2;
 
-    if ((zone_table + mid)->number == vnum)
+/*
+ * What a zone's vnum range holds, looked up through the vnum indexes and
+ * the sorted trigger index rather than by going through whole tables.
+ */
+void count_zone_contents(zone_rnum zone, int *rooms, int *mobs, int *objs, int *trigs)
+{
+  int v, t;
+
+  *rooms = *mobs = *objs = *trigs = 0;
+  for (v = zone_table[zone].bot; v <= zone_table[zone].top; v++) {
+    *rooms += (real_room(v) != NOWHERE);
+    *mobs += (real_mobile(v) != NOBODY);
+    *objs += (real_object(v) != NOTHING);
+  }
+  for (t = first_trigger_from(zone_table[zone].bot);
+       t < top_of_trigt && trig_index[t]->vnum <= zone_table[zone].top; t++)
+    (*trigs)++;
+}
+
+/* the binary search real_room() used to be, over a sorted copy of the vnums */
+static int vnum_bsearch(const room_vnum *vnums, int count, room_vnum vnum)
+{
+  int bot = 0, top = count - 1, mid;
+
+  while (bot <= top) {
+    mid = (bot + top) / 2;
+    if (vnums[mid] == vnum)
       return (mid);
-    if (bot > top)
-      return (NOWHERE);
-    if (top == 0)
-      return (NOWHERE);
-    if ((zone_table + mid)->number > vnum)
+    if (vnums[mid] > vnum)
       top = mid - 1;
     else
       bot = mid + 1;
   }
+  return (-1);
+}
+
+static int vnum_compare(const void *a, const void *b)
+{
+  return (*(const room_vnum *) a - *(const room_vnum *) b);
+}
+
+/* half the lookups are for rooms that exist, half for random vnums */
+static void vnum_bench(struct char_data *ch, int lookups)
+{
+  struct timeval before, after, spent;
+  unsigned long search_usecs, index_usecs;
+  room_vnum *vnums, vnum;
+  int i, rooms = top_of_world + 1, search_found = 0, index_found = 0;
+
+  CREATE(vnums, room_vnum, rooms);
+  for (i = 0; i < rooms; i++)
+    vnums[i] = world[i].number;
+  qsort(vnums, rooms, sizeof(room_vnum), vnum_compare);
+
+  gettimeofday(&before, (struct timezone *) 0);
+  for (i = 0; i < lookups; i++) {
+    vnum = (i & 1) ? (room_vnum) ((i * 40503U) % 65535) : vnums[(i * 7919U) % rooms];
+    search_found += (vnum_bsearch(vnums, rooms, vnum) >= 0);
+  }
+  gettimeofday(&after, (struct timezone *) 0);
+  timediff(&spent, &after, &before);
+  search_usecs = spent.tv_sec * 1000000 + spent.tv_usec;
+
+  gettimeofday(&before, (struct timezone *) 0);
+  for (i = 0; i < lookups; i++) {
+    vnum = (i & 1) ? (room_vnum) ((i * 40503U) % 65535) : vnums[(i * 7919U) % rooms];
+    index_found += (real_room(vnum) != NOWHERE);
+  }
+  gettimeofday(&after, (struct timezone *) 0);
+  timediff(&spent, &after, &before);
+  index_usecs = spent.tv_sec * 1000000 + spent.tv_usec;
+
+  free(vnums);
+
+  send_to_char(ch, "%d room lookups on a world of %d:\r\n"
+	"              usecs  nsecs/lookup    found\r\n"
+	"Binary   %10lu %13lu %8d\r\n"
+	"Indexed  %10lu %13lu %8d\r\n", lookups, rooms,
+	search_usecs, search_usecs * 1000 / lookups, search_found,
+	index_usecs, index_usecs * 1000 / lookups, index_found);
+}
+
+/* show vnums [bench [<rooms to add>]] */
+void vnum_report(struct char_data *ch, char *value, char *arg)
+{
+  struct vnum_table *tables[] = { &room_vnums, &mob_vnums, &obj_vnums, &zone_vnums };
+  const char *names[] = { "Rooms", "Mobiles", "Objects", "Zones" };
+  int entries[4], i;
+
+  if (*value && is_abbrev(value, "bench")) {
+    skip_spaces(&arg);
+    vnum_bench(ch, 1000000);
+    add_room_bench(ch, *arg && is_number(arg) ? MIN(MAX(atoi(arg), 1), 10000) : 1000);
+    return;
+  }
+
+  entries[0] = top_of_world + 1;
+  entries[1] = top_of_mobt + 1;
+  entries[2] = top_of_objt + 1;
+  entries[3] = top_of_zone_table + 1;
+
+  send_to_char(ch, "Table    Entries  Pages    Bytes\r\n"
+	"-------- ------- ------ --------\r\n");
+  for (i = 0; i < 4; i++)
+    send_to_char(ch, "%-8s %7d %6d %8d\r\n", names[i], entries[i],
+	tables[i]->pages, (int) (tables[i]->pages * VNUM_PAGE_SIZE * sizeof(IDXTYPE)));
 }
 
 
@@ -3052,6 +3730,15 @@ extern int siteok_everyone;
 extern int nameserver_is_slow;
 extern int use_new_socials;
 extern int auto_save_olc;
+extern int script_budget;
+extern int mem_sample_rate;
+extern int zone_reset_budget;
+extern int dormant_mob_pulses;
+extern int hibernate_minutes;
+extern int input_byte_rate;
+extern int input_line_rate;
+extern int input_queue_lines;
+extern int input_overflow;
 extern const char *MENU;
 extern const char *WELC_MESSG;
 extern const char *START_MESSG;
@@ -3134,6 +3821,15 @@ void load_default_config( void )
   CONFIG_NS_IS_SLOW             = nameserver_is_slow;
   CONFIG_NEW_SOCIALS            = use_new_socials;
   CONFIG_OLC_SAVE               = auto_save_olc;
+  CONFIG_SCRIPT_BUDGET          = script_budget;
+  CONFIG_MEM_SAMPLE_RATE        = mem_sample_rate;
+  CONFIG_ZONE_RESET_BUDGET      = zone_reset_budget;
+  CONFIG_DORMANT_MOB_PULSES     = dormant_mob_pulses;
+  CONFIG_HIBERNATE_MINUTES      = hibernate_minutes;
+  CONFIG_INPUT_BYTE_RATE        = input_byte_rate;
+  CONFIG_INPUT_LINE_RATE        = input_line_rate;
+  CONFIG_INPUT_QUEUE_LINES      = input_queue_lines;
+  CONFIG_INPUT_OVERFLOW         = input_overflow;
   CONFIG_MENU                   = strdup(MENU);
   CONFIG_WELC_MESSG             = strdup(WELC_MESSG);
   CONFIG_START_MESSG            = strdup(START_MESSG);
@@ -3218,6 +3914,8 @@ void load_config( void )
             CONFIG_DFLT_IP = NULL;
         } else if (!str_cmp(tag, "dflt_port"))
           CONFIG_DFLT_PORT = num;
+        else if (!str_cmp(tag, "dormant_mob_pulses"))
+          CONFIG_DORMANT_MOB_PULSES = num;
         break;
         
       case 'f':
@@ -3227,6 +3925,11 @@ void load_config( void )
           CONFIG_FROZEN_START = num;
         break;
         
+      case 'h':
+        if (!str_cmp(tag, "hibernate_minutes"))
+          CONFIG_HIBERNATE_MINUTES = num;
+        break;
+
       case 'i':
         if (!str_cmp(tag, "idle_void"))
           CONFIG_IDLE_VOID = num;
@@ -3238,6 +3941,14 @@ void load_config( void )
           CONFIG_IMMORT_LEVEL_OK = num;
         else if (!str_cmp(tag, "immort_start_room"))
           CONFIG_IMMORTAL_START = num;
+        else if (!str_cmp(tag, "input_byte_rate"))
+          CONFIG_INPUT_BYTE_RATE = num;
+        else if (!str_cmp(tag, "input_line_rate"))
+          CONFIG_INPUT_LINE_RATE = num;
+        else if (!str_cmp(tag, "input_queue_lines"))
+          CONFIG_INPUT_QUEUE_LINES = num;
+        else if (!str_cmp(tag, "input_overflow"))
+          CONFIG_INPUT_OVERFLOW = MIN(MAX(num, 0), NUM_INPUT_OVERFLOW - 1);
         break;
         
       case 'l':
@@ -3272,6 +3983,8 @@ void load_config( void )
           CONFIG_MAX_PC_CORPSE_TIME = num;
         else if (!str_cmp(tag, "max_playing"))
           CONFIG_MAX_PLAYING = num;
+        else if (!str_cmp(tag, "mem_sample_rate"))
+          CONFIG_MEM_SAMPLE_RATE = num;
         else if (!str_cmp(tag, "menu")) {
           if (CONFIG_MENU)
             free(CONFIG_MENU);
@@ -3333,7 +4046,8 @@ void load_config( void )
           if (CONFIG_START_MESSG)
             free(CONFIG_START_MESSG);
           CONFIG_START_MESSG = fread_string(fl, buf);
-        }
+        } else if (!str_cmp(tag, "script_budget"))
+          CONFIG_SCRIPT_BUDGET = num;
         break;
         
       case 't':
@@ -3358,6 +4072,11 @@ void load_config( void )
           CONFIG_WELC_MESSG = fread_string(fl, buf);
         }
         break;
+
+      case 'z':
+        if (!str_cmp(tag, "zone_reset_budget"))
+          CONFIG_ZONE_RESET_BUDGET = num;
+        break;
         
       default:
         break;
@@ -122,7 +122,17 @@
 void	boot_db(void);
 void	destroy_db(void);
 int	create_entry(char *name);
-void	zone_update(void);
+void	zone_reset_continue(void);
+void	schedule_zone_reset(zone_rnum zone);
+void	zone_emptied(zone_rnum zone);
+void	check_waiting_zones(void);
+void	rebuild_reset_heap(void);
+void	free_reset_heap(void);
+int	zone_age(zone_rnum zone);
+void	hibernate_zones(void);
+void	wake_zone(zone_rnum zone);
+void	queue_zone_wake(zone_rnum zone);
+void	wake_queued_zones(void);
 char	*fread_string(FILE *fl, const char *error);
 long	get_id_by_name(const char *name);
 char	*get_name_by_id(long id);
@@ -136,6 +146,21 @@ zone_rnum real_zone(zone_vnum vnum);
 room_rnum real_room(room_vnum vnum);
 mob_rnum real_mobile(mob_vnum vnum);
 obj_rnum real_object(obj_vnum vnum);
+void	vnum_reindex(int mode, IDXTYPE from);
+void	vnum_unindex(int mode, IDXTYPE vnum);
+void	free_vnum_tables(void);
+void	vnum_report(struct char_data *ch, char *value, char *arg);
+void	count_zone_contents(zone_rnum zone, int *rooms, int *mobs, int *objs, int *trigs);
+
+/* name indexes for 'vnum', in db.c */
+#define NAME_INDEX_MOB		0
+#define NAME_INDEX_OBJ		1
+#define NAME_INDEX_ROOM		2
+#define NAME_INDEX_TRIG		3
+#define NUM_NAME_INDEXES	4
+
+void	name_index_stale(int which);
+void	free_name_indexes(void);
 
 int	load_char(const char *name, struct char_data *ch);
 void	save_char(struct char_data *ch);
@@ -199,9 +224,31 @@ struct zone_data {
    room_vnum top;           /* upper limit for rooms in this zone */
 
    int	reset_mode;         /* conditions for reset (see below)   */
+   int	zone_flags;         /* ZONE_x, below			  */
    zone_vnum number;	    /* virtual number of this zone	  */
    struct reset_com *cmd;   /* command table for reset	          */
 
+   unsigned long resets;	    /* times reset since boot		  */
+   unsigned long reset_usec;  /* time spent in those resets	  */
+   unsigned long reset_max_usec; /* the slowest of them		  */
+
+   time_t last_reset;         /* when it was last reset		  */
+   time_t reset_due;          /* when it is next due for one	  */
+   int	reset_heap_pos;       /* place in the reset heap, -1 if out */
+   bool	reset_waiting;        /* due, waiting for players to leave  */
+   int	players;              /* players in it, see char_to_room()  */
+   unsigned long auto_resets; /* resets that came due since boot	  */
+   unsigned long reset_lag;   /* seconds they started late, in all  */
+   unsigned long reset_max_lag; /* the latest of them		  */
+
+   struct char_data *mobs;    /* mobs in it, for mobile_activity()  */
+
+   bool	hibernating;          /* left out of the periodic updates   */
+   bool	wake_queued;          /* to be woken next pulse, see below  */
+   time_t emptied_at;         /* when its last player left	  */
+   unsigned long slept_at;    /* hibernate_clock when it went to sleep */
+   unsigned long wakes;       /* times woken since boot		  */
+
    /*
     * Reset mode:
     *   0: Don't reset, and don't update age.
@@ -210,22 +257,16 @@ struct zone_data {
     */
 };
 
+/* zone flags */
+#define ZONE_ALWAYS_ACTIVE	(1 << 0)   /* mobs act with no players in it */
 
+#define ZONE_FLAGGED(rnum, flag)  (IS_SET(zone_table[(rnum)].zone_flags, (flag)))
 
-/* for queueing zones for update   */
-struct reset_q_element {
-   zone_rnum zone_to_reset;            /* ref to zone_data */
-   struct reset_q_element *next;
-};
-
+/* is the zone room 'room' is in hibernating?  NOWHERE never is */
+#define ROOM_HIBERNATING(room) ((room) != NOWHERE && \
+				zone_table[world[(room)].zone].hibernating)
 
 
-/* structure for the update queue     */
-struct reset_q_type {
-   struct reset_q_element *head;
-   struct reset_q_element *tail;
-};
-
 
 /* Added level, flags, and last, primarily for pfile autocleaning.  You
    can also use them to keep online statistics, and can add race, class,
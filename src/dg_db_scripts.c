@@ -36,7 +36,7 @@ void parse_trigger(FILE *trig_f, int nr)
     struct index_data *t_index;
     struct trig_data *trig;
 
-    CREATE(trig, trig_data, 1);
+    SLAB_CREATE(trig, trig_data, SLAB_TRIG);
     CREATE(t_index, index_data, 1);
 
     t_index->vnum = nr;
@@ -88,7 +88,7 @@ trig_data *read_trigger(int nr)
     if ((t_index = trig_index[nr]) == NULL)
 	return NULL;
 
-    CREATE(trig, trig_data, 1);
+    SLAB_CREATE(trig, trig_data, SLAB_TRIG);
     trig_data_copy(trig, t_index->proto);
 
     t_index->number++;
@@ -112,6 +112,8 @@ void trig_data_init(trig_data *this_data)
     this_data->wait_event = NULL;
     this_data->purged = FALSE;
     this_data->var_list = NULL;
+    this_data->speech_slot = 0;
+    this_data->speech_stamp = 0;
 
     this_data->next = NULL;  
 }
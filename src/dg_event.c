@@ -57,7 +57,7 @@ struct event *event_create(EVENTFUNC(*func), void *event_obj, long when)
   if (when < 1) /* make sure its in the future */
     when = 1;
  
-  CREATE(new_event, struct event, 1);
+  SLAB_CREATE(new_event, struct event, SLAB_EVENT);
   new_event->func = func;
   new_event->event_obj = event_obj;
   new_event->q_el = queue_enq(event_q, new_event, when + pulse);
@@ -81,7 +81,7 @@ void event_cancel(struct event *event)
 
   if (event->event_obj)
     free(event->event_obj);
-  free(event);
+  SLAB_FREE(event);
 }
 
 
@@ -108,7 +108,7 @@ void event_process(void)
     if ((new_time = (the_event->func)(the_event->event_obj)) > 0)
       the_event->q_el = queue_enq(event_q, the_event, new_time + pulse);
     else
-      free(the_event);
+      SLAB_FREE(the_event);
   }
 }
 
@@ -132,7 +132,7 @@ void event_free_all(void)
   while ((the_event = (struct event *) queue_head(event_q))) {
     if (the_event->event_obj)
       free(the_event->event_obj);
-    free(the_event);
+    SLAB_FREE(the_event);
   }
 
   queue_free(event_q);
@@ -34,7 +34,7 @@ void free_var_el(struct trig_var_data *var)
     free(var->name);
   if (var->value)
     free(var->value);
-  free(var);
+  SLAB_FREE(var);
 }
 
 /* release memory allocated for a variable list */
@@ -96,7 +96,7 @@ void free_trigger(struct trig_data *trig)
     if (GET_TRIG_WAIT(trig))
       event_cancel(GET_TRIG_WAIT(trig));
    
-    free(trig);
+    SLAB_FREE(trig);
 }
 
 
@@ -146,7 +146,7 @@ void do_dg_cast(void *go, struct script_data *sc, trig_data *trig,
       caster->player.short_descr = strdup("The gods");
     caster->next_in_room = caster_room->people;
     caster_room->people = caster;
-    caster->in_room = real_room(caster_room->number);
+    IN_ROOM(caster) = real_room(caster_room->number);
     call_magic(caster, tch, tobj, spellnum, DG_SPELL_LEVEL, CAST_SPELL);
     extract_char(caster);
   } else
@@ -313,6 +313,7 @@ void script_damage(struct char_data *vict, int dam)
 
   GET_HIT(vict) -= dam;
   GET_HIT(vict) = MIN(GET_HIT(vict), GET_MAX_HIT(vict));
+  gmcp_hit_changed(vict);
   
   update_pos(vict);
   send_char_pos(vict, dam);
@@ -320,7 +321,7 @@ void script_damage(struct char_data *vict, int dam)
   if (GET_POS(vict) == POS_DEAD) {
     if (!IS_NPC(vict))
       mudlog( BRF, 0, TRUE, "%s killed by script at %s", 
-                            GET_NAME(vict), world[vict->in_room].name);
+                            GET_NAME(vict), world[IN_ROOM(vict)].name);
     die(vict, NULL);
   }
 }  
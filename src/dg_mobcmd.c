@@ -827,7 +827,7 @@ ACMD(do_mhunt)
         mob_log(ch, "mhunt: victim (%s) does not exist", arg);
         return;
     }
-    HUNTING(ch) = victim;
+    SET_HUNTING(ch, victim);
   
 
 }
@@ -950,7 +950,8 @@ ACMD(do_mtransform)
   obj_data *obj[NUM_WEARS];
   mob_rnum this_rnum = GET_MOB_RNUM(ch);
   int keep_hp = 1; /* new mob keeps the old mob's hp/max hp/exp */
-  int pos;
+  int pos, hit = GET_HIT(ch);
+  byte position = GET_POS(ch);
 
     if (!MOB_OR_IMPL(ch)) {
         send_to_char(ch, "Huh?!?\r\n");
@@ -1025,17 +1026,28 @@ ACMD(do_mtransform)
 
     GET_WAS_IN(&tmpmob) = GET_WAS_IN(ch);
     if (keep_hp) {
-      GET_HIT(&tmpmob) = GET_HIT(ch);
       GET_MAX_HIT(&tmpmob) = GET_MAX_HIT(ch);
       GET_EXP(&tmpmob) = GET_EXP(ch);
     }
     GET_GOLD(&tmpmob) = GET_GOLD(ch);
-    GET_POS(&tmpmob) = GET_POS(ch);
     IS_CARRYING_W(&tmpmob) = IS_CARRYING_W(ch);
     IS_CARRYING_N(&tmpmob) = IS_CARRYING_N(ch);
     FIGHTING(&tmpmob) = FIGHTING(ch);
-    HUNTING(&tmpmob) = HUNTING(ch);
-    memcpy(ch, &tmpmob, sizeof(*ch));
+    tmpmob.char_specials.hunting = ch->char_specials.hunting;
+    tmpmob.ref_slot = ch->ref_slot;
+    tmpmob.next_instance = ch->next_instance;
+    tmpmob.prev_instance = ch->prev_instance;
+    tmpmob.next_in_zone = ch->next_in_zone;
+    tmpmob.prev_in_zone = ch->prev_in_zone;
+    tmpmob.combat.valid = FALSE;
+
+    /* tmpmob's hot fields are m's slot: ch keeps its own and takes them over */
+    copy_char(ch, &tmpmob);
+    if (keep_hp)
+      GET_HIT(ch) = hit;
+    GET_POS(ch) = position;
+    /* it may be aggressive, or hidden, now where it wasn't before */
+    room_census_dirty(IN_ROOM(ch));
 
     for (pos = 0; pos < NUM_WEARS; pos++) {
       if (obj[pos])
@@ -1147,6 +1159,7 @@ ACMD(do_mdoor)
             break;
         }
     }
+    path_exits_changed();
 }
 
 ACMD(do_mfollow)
@@ -82,8 +82,8 @@ void obj_log(obj_data *obj, const char *format, ...)
 /* returns the real room number that the object or object's carrier is in */
 room_rnum obj_room(obj_data *obj)
 {
-    if (IN_ROOM(obj) != NOWHERE)
-        return IN_ROOM(obj);
+    if (OBJ_IN_ROOM(obj) != NOWHERE)
+        return OBJ_IN_ROOM(obj);
     else if (obj->carried_by)
         return IN_ROOM(obj->carried_by);
     else if (obj->worn_by)
@@ -120,8 +120,8 @@ room_rnum find_obj_target_room(obj_data *obj, char *rawroomstr)
         location = IN_ROOM(target_mob);
     else if ((target_obj = get_obj_by_obj(obj, roomstr)))
     {
-        if (IN_ROOM(target_obj) != NOWHERE)
-            location = IN_ROOM(target_obj);
+        if (OBJ_IN_ROOM(target_obj) != NOWHERE)
+            location = OBJ_IN_ROOM(target_obj);
         else 
             return NOWHERE;
     }
@@ -296,7 +296,7 @@ OCMD(do_otimer)
   else if (!isdigit(*arg)) 
     obj_log(obj, "otimer: bad argument");
   else
-    GET_OBJ_TIMER(obj) = atoi(arg);
+    set_obj_timer(obj, atoi(arg));
 }
 
 
@@ -329,9 +329,14 @@ OCMD(do_otransform)
       unequip_char(obj->worn_by, pos);
     }
 
-    /* move new obj info over to old object and delete new obj */
+    /* move new obj info over to old object and delete new obj; obj takes
+       o's prototype, so it leaves its old instance list here and joins the
+       new one once the copy is done */
+    remove_obj_instance(obj);
+    obj_timer_clear(obj);
+    obj_timer_clear(o);
     memcpy(&tmpobj, o, sizeof(*o));
-    tmpobj.in_room = IN_ROOM(obj);
+    tmpobj.in_room = OBJ_IN_ROOM(obj);
     tmpobj.carried_by = obj->carried_by;
     tmpobj.worn_by = obj->worn_by;
     tmpobj.worn_on = obj->worn_on;
@@ -343,6 +348,9 @@ OCMD(do_otransform)
     tmpobj.next_content = obj->next_content;
     tmpobj.next = obj->next;
     memcpy(obj, &tmpobj, sizeof(*obj));
+    add_obj_instance(obj);
+    if (obj->obj_flags.timer)
+      set_obj_timer(obj, obj->obj_flags.timer);
 
     if (wearer) {
       equip_char(wearer, obj, pos);
@@ -700,6 +708,7 @@ OCMD(do_odoor)
             break;
         }
     }
+    path_exits_changed();
 }
 
 
@@ -153,7 +153,7 @@ void trigedit_setup_new(struct descriptor_data *d)
   /*
    * Allocate a scratch trigger structure
    */
-  CREATE(trig, struct trig_data, 1);
+  SLAB_CREATE(trig, struct trig_data, SLAB_TRIG);
 
   trig->nr = -1;
 
@@ -182,7 +182,7 @@ void trigedit_setup_existing(struct descriptor_data *d, int rtrg_num)
   /*
    * Allocate a scratch trigger structure
    */
-  CREATE(trig, struct trig_data, 1);
+  SLAB_CREATE(trig, struct trig_data, SLAB_TRIG);
 
   trig_data_copy(trig, trig_index[rtrg_num]->proto);
 
@@ -424,6 +424,8 @@ void trigedit_save(struct descriptor_data *d)
   char bitBuf[MAX_INPUT_LENGTH];
   char fname[MAX_INPUT_LENGTH];
   
+  name_index_stale(NAME_INDEX_TRIG);
+
   if ((rnum = real_trigger(OLC_NUM(d))) != NOTHING) {
     proto = trig_index[rnum]->proto;
     for (cmd = proto->cmdlist; cmd; cmd = next_cmd) { 
@@ -496,10 +498,12 @@ void trigedit_save(struct descriptor_data *d)
         live_trig->narg = proto->narg;
         live_trig->data_type = proto->data_type;
         live_trig->depth = 0;
+        live_trig->speech_stamp = 0;	/* arglist changed, reindex */
       }
 
       live_trig = live_trig->next_in_world;
     }
+    cmd_filter_changed();	/* live command triggers may have changed */
   } else {
     /* this is a new trigger */
     CREATE(new_index, struct index_data *, top_of_trigt + 2);
@@ -534,7 +538,7 @@ void trigedit_save(struct descriptor_data *d)
           new_index[rnum]->vnum = OLC_NUM(d);
           new_index[rnum]->number = 0; 
           new_index[rnum]->func = NULL;
-          CREATE(proto, struct trig_data, 1);
+          SLAB_CREATE(proto, struct trig_data, SLAB_TRIG);
           new_index[rnum]->proto = proto;
           trig_data_copy(proto, trig);
 
@@ -565,7 +569,7 @@ void trigedit_save(struct descriptor_data *d)
       new_index[rnum]->number = 0;
       new_index[rnum]->func = NULL;
                         
-      CREATE(proto, struct trig_data, 1);
+      SLAB_CREATE(proto, struct trig_data, SLAB_TRIG);
       new_index[rnum]->proto = proto;
       trig_data_copy(proto, trig);
 
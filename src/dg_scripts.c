@@ -31,9 +31,12 @@
 extern unsigned long pulse;
 extern struct spell_info_type spell_info[];
 extern struct time_info_data time_info;
+extern unsigned long cmd_filter_walks, cmd_filter_skips, cmd_filter_avoided;
+extern unsigned long cmd_filter_rebuilds;
 
 /* external functions */
 int is_empty(zone_rnum zone_nr);
+void timediff(struct timeval *diff, struct timeval *a, struct timeval *b);
 room_rnum find_target_room(struct char_data *ch, char *rawroomstr);
 zone_rnum real_zone_by_thing(room_vnum vznum);
 
@@ -59,6 +62,7 @@ struct cmdlist_element *find_else_end(trig_data *trig,
                                       struct script_data *sc, int type);
 void process_wait(void *go, trig_data *trig, int type, char *cmd,
                   struct cmdlist_element *cl);
+static int run_script(void *go_adress, trig_data *trig, int type, int mode);
 void process_set(struct script_data *sc, trig_data *trig, char *cmd);
 void process_attach(void *go, struct script_data *sc, trig_data *trig,
                     int type, char *cmd);
@@ -262,20 +266,30 @@ int can_wear_on_pos(struct obj_data *obj, int pos)
 /* return char with UID n */
 struct char_data *find_char(long n)
 {
+  struct char_data *ch;
+
   if (n>=ROOM_ID_BASE) /* See note in dg_scripts.h */
     return NULL;
 
-  return find_char_by_uid_in_lookup_table(n);
+  if ((ch = find_char_by_uid_in_lookup_table(n)) && ROOM_HIBERNATING(IN_ROOM(ch)))
+    queue_zone_wake(world[IN_ROOM(ch)].zone);
+  return ch;
 }
 
 
 /* return object with UID n */
 obj_data *find_obj(long n)
 {
+  obj_data *obj;
+  room_rnum room;
+
   if (n < OBJ_ID_BASE) /* see note in dg_scripts.h */
     return NULL;
     
-  return find_obj_by_uid_in_lookup_table(n);
+  if ((obj = find_obj_by_uid_in_lookup_table(n)) &&
+      ROOM_HIBERNATING(room = obj_room(obj)))
+    queue_zone_wake(world[room].zone);
+  return obj;
 }
 
 /* return room with UID n */
@@ -288,8 +302,11 @@ room_data *find_room(long n)
     return NULL;
   rnum = real_room((room_vnum)n);  
 
-  if (rnum != NOWHERE)
+  if (rnum != NOWHERE) {
+    if (ROOM_HIBERNATING(rnum))
+      queue_zone_wake(world[rnum].zone);
     return &world[rnum];
+  }
 
   return NULL;
 }
@@ -581,86 +598,226 @@ obj_data *get_obj_by_room(room_data *room, char *name)
 }
 
 /* checks every PULSE_SCRIPT for random triggers */
-void script_trigger_check(void)
+/*
+ * Random and time triggers are checked by sweeping every scripted mob,
+ * object and room.  When the per-pulse script budget is used up, the sweep
+ * stops where it is and script_sweep_continue() picks it up again on the
+ * following pulses.  The cursors are kept valid by extract_obj() and
+ * extract_char_final(), the same way stop_fighting() does for
+ * next_combat_list.  Nothing in a hibernating zone is checked, not even
+ * global triggers; flag the zone ALWAYS_ACTIVE to keep those running.
+ */
+#define SWEEP_IDLE   0
+#define SWEEP_CHARS  1
+#define SWEEP_OBJS   2
+#define SWEEP_ROOMS  3
+
+struct script_sweep {
+  int phase;			/* SWEEP_xxx                          */
+  char_data *next_ch;		/* next character to check            */
+  obj_data *next_obj;		/* next object to check               */
+  room_rnum next_room;		/* next room to check                 */
+  long mtype, otype, wtype;	/* trigger bits this sweep looks for  */
+  void (*mfunc)(char_data *ch);
+  void (*ofunc)(obj_data *obj);
+  void (*wfunc)(room_data *room);
+};
+
+static struct script_sweep random_sweep = {
+  SWEEP_IDLE, NULL, NULL, 0, MTRIG_RANDOM, OTRIG_RANDOM, WTRIG_RANDOM,
+  random_mtrigger, random_otrigger, random_wtrigger
+};
+
+static struct script_sweep time_sweep = {
+  SWEEP_IDLE, NULL, NULL, 0, MTRIG_TIME, OTRIG_TIME, WTRIG_TIME,
+  time_mtrigger, time_otrigger, time_wtrigger
+};
+
+/* usecs spent in scripts during the current pulse, reset by heartbeat() */
+unsigned long script_pulse_usec = 0;
+/* number of times a sweep was cut short by the script budget */
+unsigned long script_sweeps_deferred = 0;
+/* lines run by script_driver(), used for the per-trigger line counts */
+static unsigned long script_lines_run = 0;
+
+#define SCRIPT_BUDGET_SPENT() (CONFIG_SCRIPT_BUDGET > 0 && \
+                               script_pulse_usec >= CONFIG_SCRIPT_BUDGET)
+
+/* runs a sweep until it is done or the budget runs out */
+static void run_script_sweep(struct script_sweep *sw)
 {
   char_data *ch;
   obj_data *obj;
-  struct room_data *room=NULL;
-  int nr;
+  room_data *room;
   struct script_data *sc;
 
-  for (ch = character_list; ch; ch = ch->next) {
-    if (SCRIPT(ch)) {
-      sc = SCRIPT(ch);
-
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_RANDOM) &&
+  if (sw->phase == SWEEP_CHARS) {
+    while ((ch = sw->next_ch) != NULL) {
+      if ((sc = SCRIPT(ch)) && IS_SET(SCRIPT_TYPES(sc), sw->mtype) &&
+          !ROOM_HIBERNATING(IN_ROOM(ch)) &&
           (!is_empty(world[IN_ROOM(ch)].zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-        random_mtrigger(ch);
+           IS_SET(SCRIPT_TYPES(sc), MTRIG_GLOBAL))) {
+        if (SCRIPT_BUDGET_SPENT()) {
+          script_sweeps_deferred++;
+          return;
+        }
+        sw->next_ch = ch->next;
+        sw->mfunc(ch);
+      } else
+        sw->next_ch = ch->next;
     }
+    sw->phase = SWEEP_OBJS;
+    sw->next_obj = object_list;
   }
-  
-  for (obj = object_list; obj; obj = obj->next) {
-    if (SCRIPT(obj)) {
-      sc = SCRIPT(obj);
 
-      if (IS_SET(SCRIPT_TYPES(sc), OTRIG_RANDOM))
-        random_otrigger(obj);
+  if (sw->phase == SWEEP_OBJS) {
+    while ((obj = sw->next_obj) != NULL) {
+      if ((sc = SCRIPT(obj)) && IS_SET(SCRIPT_TYPES(sc), sw->otype) &&
+          !ROOM_HIBERNATING(obj_room(obj))) {
+        if (SCRIPT_BUDGET_SPENT()) {
+          script_sweeps_deferred++;
+          return;
+        }
+        sw->next_obj = obj->next;
+        sw->ofunc(obj);
+      } else
+        sw->next_obj = obj->next;
     }
+    sw->phase = SWEEP_ROOMS;
+    sw->next_room = 0;
+  }
+
+  if (sw->phase == SWEEP_ROOMS) {
+    for (; sw->next_room <= top_of_world; sw->next_room++) {
+      room = &world[sw->next_room];
+      if ((sc = SCRIPT(room)) && IS_SET(SCRIPT_TYPES(sc), sw->wtype) &&
+          !zone_table[room->zone].hibernating &&
+          (!is_empty(room->zone) || IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL))) {
+        if (SCRIPT_BUDGET_SPENT()) {
+          script_sweeps_deferred++;
+          return;
+        }
+        sw->wfunc(room);
+      }
+    }
+    sw->phase = SWEEP_IDLE;
   }
+}
 
-  for (nr = 0; nr <= top_of_world; nr++) {
-    if (SCRIPT(&world[nr])) {
-      room = &world[nr];
-      sc = SCRIPT(room);
-      
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_RANDOM) &&
-          (!is_empty(room->zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-        random_wtrigger(room);
-    }
+/* starts a new sweep, unless the last one is still catching up */
+static void start_script_sweep(struct script_sweep *sw)
+{
+  int was = rng_use(RNG_SCRIPT);
+
+  if (sw->phase == SWEEP_IDLE) {
+    sw->phase = SWEEP_CHARS;
+    sw->next_ch = character_list;
   }
+  run_script_sweep(sw);
+  rng_use(was);
 }
 
-void check_time_triggers(void) 
+void script_trigger_check(void)
 {
-  char_data *ch;
-  obj_data *obj;
-  struct room_data *room=NULL;
-  int nr;
-  struct script_data *sc;
+  start_script_sweep(&random_sweep);
+}
 
-  for (ch = character_list; ch; ch = ch->next) {
-    if (SCRIPT(ch)) {
-      sc = SCRIPT(ch);
+void check_time_triggers(void)
+{
+  start_script_sweep(&time_sweep);
+}
 
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_TIME) &&
-          (!is_empty(world[IN_ROOM(ch)].zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-        time_mtrigger(ch);
-    }
-  }
-  
-  for (obj = object_list; obj; obj = obj->next) {
-    if (SCRIPT(obj)) {
-      sc = SCRIPT(obj);
+/* called every pulse to finish sweeps deferred by the script budget */
+void script_sweep_continue(void)
+{
+  int was = rng_use(RNG_SCRIPT);
 
-      if (IS_SET(SCRIPT_TYPES(sc), OTRIG_TIME))
-        time_otrigger(obj);
-    }
-  }
+  if (random_sweep.phase != SWEEP_IDLE)
+    run_script_sweep(&random_sweep);
+  if (time_sweep.phase != SWEEP_IDLE)
+    run_script_sweep(&time_sweep);
+  rng_use(was);
+}
 
-  for (nr = 0; nr <= top_of_world; nr++) {
-    if (SCRIPT(&world[nr])) {
-      room = &world[nr];
-      sc = SCRIPT(room);
-      
-      if (IS_SET(SCRIPT_TYPES(sc), WTRIG_TIME) &&
-          (!is_empty(room->zone) ||
-           IS_SET(SCRIPT_TYPES(sc), WTRIG_GLOBAL)))
-        time_wtrigger(room);
-    }
+/* keep the sweep cursors off characters and objects being freed */
+void script_sweep_remove_char(char_data *ch)
+{
+  if (random_sweep.next_ch == ch)
+    random_sweep.next_ch = ch->next;
+  if (time_sweep.next_ch == ch)
+    time_sweep.next_ch = ch->next;
+}
+
+void script_sweep_remove_obj(obj_data *obj)
+{
+  if (random_sweep.next_obj == obj)
+    random_sweep.next_obj = obj->next;
+  if (time_sweep.next_obj == obj)
+    time_sweep.next_obj = obj->next;
+}
+
+/* compares two trigger rnums by total time spent, most expensive first */
+static int prof_compare(const void *a, const void *b)
+{
+  struct trig_prof_data *pa = trig_index[*(const int *)a]->prof;
+  struct trig_prof_data *pb = trig_index[*(const int *)b]->prof;
+
+  if (pa->total_usec != pb->total_usec)
+    return (pa->total_usec < pb->total_usec) ? 1 : -1;
+  return (pa->runs < pb->runs) ? 1 : (pa->runs > pb->runs) ? -1 : 0;
+}
+
+/* show scripts [reset | <count>] - triggers sorted by time spent */
+void script_prof_report(char_data *ch, char *arg)
+{
+  char buf[MAX_STRING_LENGTH];
+  struct trig_prof_data *prof;
+  int *list, count = 0, shown = 25, i;
+  size_t len, nlen;
+
+  if (*arg && is_abbrev(arg, "reset")) {
+    for (i = 0; i < top_of_trigt; i++)
+      if (trig_index[i]->prof)
+        memset(trig_index[i]->prof, 0, sizeof(struct trig_prof_data));
+    script_sweeps_deferred = 0;
+    cmd_filter_walks = cmd_filter_skips = cmd_filter_avoided = 0;
+    cmd_filter_rebuilds = 0;
+    send_to_char(ch, "Script accounting reset.\r\n");
+    return;
+  }
+  if (*arg && is_number(arg))
+    shown = MAX(1, atoi(arg));
+
+  CREATE(list, int, top_of_trigt + 1);
+  for (i = 0; i < top_of_trigt; i++)
+    if ((prof = trig_index[i]->prof) != NULL && prof->runs)
+      list[count++] = i;
+  qsort(list, count, sizeof(int), prof_compare);
+
+  len = snprintf(buf, sizeof(buf),
+      "Script budget: %d usecs/pulse, %lu usecs used this pulse, %lu sweeps deferred.\r\n"
+      "Command triggers: %lu walks, %lu skipped by prefilter, %lu trigger checks avoided, %lu rebuilds.\r\n"
+      " VNum  Name                   Runs    Total ms  Avg us   Max us     Lines  Waits\r\n"
+      "------ -------------------- -------- ---------- ------- -------- --------- ------\r\n",
+      CONFIG_SCRIPT_BUDGET, script_pulse_usec, script_sweeps_deferred,
+      cmd_filter_walks, cmd_filter_skips, cmd_filter_avoided, cmd_filter_rebuilds);
+
+  for (i = 0; i < count && i < shown; i++) {
+    prof = trig_index[list[i]]->prof;
+    nlen = snprintf(buf + len, sizeof(buf) - len,
+        "%6d %-20.20s %8lu %10.1f %7lu %8lu %9lu %6lu\r\n",
+        trig_index[list[i]]->vnum, GET_TRIG_NAME(trig_index[list[i]]->proto),
+        prof->runs, prof->total_usec / 1000.0, prof->total_usec / prof->runs,
+        prof->max_usec, prof->lines, prof->waits);
+    if (len + nlen >= sizeof(buf))
+      break;
+    len += nlen;
   }
+  if (!count)
+    strlcpy(buf + len, "No triggers have run yet.\r\n", sizeof(buf) - len);
+
+  free(list);
+  page_string(ch->desc, buf, TRUE);
 }
 
 
@@ -901,6 +1058,9 @@ void add_trigger(struct script_data *sc, trig_data *t, int loc)
   }
 
   SCRIPT_TYPES(sc) |= GET_TRIG_TYPE(t);
+  if (IS_SET(GET_TRIG_TYPE(t), MTRIG_COMMAND | OTRIG_COMMAND | WTRIG_COMMAND))
+    cmd_filter_changed();
+  room_census_changed();	/* it may be a mob's first trigger */
 
   t->next_in_world = trigger_list;
   trigger_list = t;
@@ -1090,6 +1250,9 @@ int remove_trigger(struct script_data *sc, char *name)
   }
       
   if (i) {
+    if (IS_SET(GET_TRIG_TYPE(i), MTRIG_COMMAND | OTRIG_COMMAND | WTRIG_COMMAND))
+      cmd_filter_changed();
+
     if (j) {
       j->next = i->next;
       extract_trigger(i);
@@ -1712,6 +1875,9 @@ void process_wait(void *go, trig_data *trig, int type, char *cmd,
 
   GET_TRIG_WAIT(trig) = event_create(trig_wait_event, wait_event_obj, when);
   trig->curr_state = cl->next;
+
+  if (GET_TRIG_RNUM(trig) != NOTHING && trig_index[GET_TRIG_RNUM(trig)]->prof)
+    trig_index[GET_TRIG_RNUM(trig)]->prof->waits++;
 }
 
 
@@ -1931,7 +2097,7 @@ void process_detach(void *go, struct script_data *sc, trig_data *trig,
 
 struct room_data *dg_room_of_obj(struct obj_data *obj)
 {
-  if (IN_ROOM(obj) != NOWHERE) return &world[IN_ROOM(obj)];
+  if (OBJ_IN_ROOM(obj) != NOWHERE) return &world[OBJ_IN_ROOM(obj)];
   if (obj->carried_by)        return &world[IN_ROOM(obj->carried_by)];
   if (obj->worn_by)           return &world[IN_ROOM(obj->worn_by)];
   if (obj->in_obj)            return (dg_room_of_obj(obj->in_obj));
@@ -2221,7 +2387,7 @@ ACMD(do_vdelete)
       vd_next = vd->next;
       free(vd->value);
       free(vd->name);
-      free(vd);
+      SLAB_FREE(vd);
     }
     sc_remote->global_vars = NULL;
     send_to_char(ch, "All variables deleted from that id.\r\n");
@@ -2245,7 +2411,7 @@ ACMD(do_vdelete)
   /* and free up the space */
   free(vd->value);
   free(vd->name);
-  free(vd);
+  SLAB_FREE(vd);
 
   send_to_char(ch, "Deleted.\r\n");
 }
@@ -2341,7 +2507,7 @@ void process_rdelete(struct script_data *sc, trig_data *trig, char *cmd)
   /* and free up the space */
   free(vd->value);
   free(vd->name);
-  free(vd);
+  SLAB_FREE(vd);
 }
 
 
@@ -2490,8 +2656,59 @@ void dg_letter_value(struct script_data *sc, trig_data *trig, char *cmd)
     int mode
       TRIG_NEW     just started from dg_triggers.c
       TRIG_RESTART restarted after a 'wait'
+
+    The run is timed and charged to the trigger's prototype; see
+    script_prof_report().
 */
 int script_driver(void *go_adress, trig_data *trig, int type, int mode)
+{
+  static int nesting = 0;
+  struct trig_prof_data *prof;
+  struct timeval start, stop, spent;
+  unsigned long lines, usec;
+  int ret_val, was;
+
+  /* scripts draw their own random numbers, whatever set them off */
+  was = rng_use(RNG_SCRIPT);
+
+  if (GET_TRIG_RNUM(trig) == NOTHING) {
+    ret_val = run_script(go_adress, trig, type, mode);
+    rng_use(was);
+    return ret_val;
+  }
+
+  if ((prof = trig_index[GET_TRIG_RNUM(trig)]->prof) == NULL) {
+    CREATE(prof, struct trig_prof_data, 1);
+    trig_index[GET_TRIG_RNUM(trig)]->prof = prof;
+  }
+
+  lines = script_lines_run;
+  gettimeofday(&start, (struct timezone *) 0);
+
+  nesting++;
+  ret_val = run_script(go_adress, trig, type, mode);
+  nesting--;
+
+  gettimeofday(&stop, (struct timezone *) 0);
+  timediff(&spent, &stop, &start);
+  usec = spent.tv_sec * 1000000 + spent.tv_usec;
+
+  /* trig may be gone by now, but the prototype's accounting is not */
+  prof->runs++;
+  prof->lines += script_lines_run - lines;
+  prof->total_usec += usec;
+  if (usec > prof->max_usec)
+    prof->max_usec = usec;
+
+  if (!nesting)
+    script_pulse_usec += usec;
+
+  rng_use(was);
+  return ret_val;
+}
+
+/* interprets the lines of a trigger, see script_driver() */
+static int run_script(void *go_adress, trig_data *trig, int type, int mode)
 {
   static int depth = 0;
   int ret_val = 1;
@@ -2565,6 +2782,8 @@ int script_driver(void *go_adress, trig_data *trig, int type, int mode)
   
   for (cl = (mode == TRIG_NEW) ? trig->cmdlist : trig->curr_state;
        cl && GET_TRIG_DEPTH(trig); cl = cl ? cl->next : NULL) {
+    script_lines_run++;
+
     for (p = cl->cmd; *p && isspace(*p); p++);
 
     if (*p == '*') /* comment */
@@ -2769,6 +2988,21 @@ trig_rnum real_trigger(trig_vnum vnum)
   }
 }
 
+/* the first trigger at or above 'vnum', or top_of_trigt if there is none */
+trig_rnum first_trigger_from(trig_vnum vnum)
+{
+  int bot = 0, top = top_of_trigt, mid;
+
+  while (bot < top) {
+    mid = (bot + top) / 2;
+    if (trig_index[mid]->vnum < vnum)
+      bot = mid + 1;
+    else
+      top = mid;
+  }
+  return (bot);
+}
+
 ACMD(do_tstat)
 {
   int rnum;
@@ -2970,6 +3204,7 @@ void save_char_vars(struct char_data *ch)
 struct lookup_table_t {
   long uid;
   void * c; 
+  struct char_ref ref;	/* for characters; checked before c is used */
   struct lookup_table_t *next;
 };
 struct lookup_table_t lookup_table[BUCKET_COUNT];
@@ -2991,8 +3226,12 @@ struct char_data *find_char_by_uid_in_lookup_table(long uid)
 
   for (;lt && lt->uid != uid ; lt = lt->next) ;
 
+  /*
+   * The reference is dead for a player gone back to the menu, whose entry
+   * stays until they come back into the game; that is not an error.
+   */
   if (lt)
-    return (struct char_data *)(lt->c);
+    return deref_char(lt->ref);
 
   log("find_char_by_uid_in_lookup_table : No entity with number %ld in lookup table", uid);
   return NULL;
@@ -3017,15 +3256,24 @@ void add_to_lookup_table(long uid, void *c)
   int bucket = (int) (uid & (BUCKET_COUNT - 1));
   struct lookup_table_t *lt = &lookup_table[bucket];
 
-  for (;lt->next; lt = lt->next)
-  if (lt->c == c && lt->uid == uid) {
-      log ("Add_to_lookup failed. Already there. (uid = %ld)", uid);
+  for (;; lt = lt->next) {
+    if (lt->c == c && lt->uid == uid) {
+      /* a player coming back from the menu needs a fresh reference */
+      if (uid < ROOM_ID_BASE)
+        lt->ref = ref_char((struct char_data *) c);
+      else
+        log ("Add_to_lookup failed. Already there. (uid = %ld)", uid);
       return;
     }
+    if (!lt->next)
+      break;
+  }
 
   CREATE(lt->next, struct lookup_table_t, 1);
   lt->next->uid = uid;
   lt->next->c = c;
+  if (uid < ROOM_ID_BASE)
+    lt->next->ref = ref_char((struct char_data *) c);
 }
 
 void remove_from_lookup_table(long uid)
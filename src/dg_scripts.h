@@ -111,6 +111,12 @@
 #define OCMD_INVEN             (1 << 1)	     /* obj must be in char's inven */
 #define OCMD_ROOM              (1 << 2)	     /* obj must be in char's room  */
 
+/* command trigger prefilter bits (struct cmd_filter), 'a'..'z' are 0..25 */
+#define CMD_FILTER_OTHER       (1U << 26)    /* arg starts with a non-letter */
+#define CMD_FILTER_ANY         (1U << 31)    /* '*' or missing arg, always   */
+
+#define CMD_FILTER_DIRTY(f)    ((f).stamp = 0)
+
 /* obj consume trigger commands */
 #define OCMD_EAT    1
 #define OCMD_DRINK  2
@@ -163,6 +169,8 @@ struct trig_data {
     struct event *wait_event;   	/* event to pause the trigger      */
     ubyte purged;			/* trigger is set to be purged     */
     struct trig_var_data *var_list;	/* list of local vars for trigger  */
+    int speech_slot;			/* slot in the room speech index   */
+    unsigned long speech_stamp;		/* build that assigned speech_slot */
     
     struct trig_data *next;  
     struct trig_data *next_in_world;    /* next in the global trigger list */
@@ -180,6 +188,15 @@ struct script_data {
   struct script_data *next;		/* used for purged_scripts    */
 };
 
+/* execution accounting for one trigger prototype, kept in trig_index */
+struct trig_prof_data {
+  unsigned long runs;			/* times started or resumed   */
+  unsigned long lines;			/* script lines executed      */
+  unsigned long waits;			/* waits scheduled            */
+  unsigned long total_usec;		/* time spent, nested included */
+  unsigned long max_usec;		/* most expensive single run  */
+};
+
 /* The event data for the wait command */
 struct wait_event_data {
   struct trig_data *trigger;
@@ -234,6 +251,8 @@ int cmd_otrig(obj_data *obj, char_data *actor, char *cmd,
 int command_mtrigger(char_data *actor, char *cmd, char *argument);
 int command_otrigger(char_data *actor, char *cmd, char *argument);
 int command_wtrigger(char_data *actor, char *cmd, char *argument);
+int command_trigger(char_data *actor, char *cmd, char *argument);
+void cmd_filter_changed(void);
 
 int death_mtrigger(char_data *ch, char_data *actor);
 void fight_mtrigger(char_data *ch);
@@ -285,6 +304,10 @@ obj_data *get_obj_in_list(char *name, obj_data *list);
 obj_data *get_object_in_equip(char_data * ch, char *name);
 void script_trigger_check(void);
 void check_time_triggers(void);
+void script_sweep_continue(void);
+void script_sweep_remove_char(char_data *ch);
+void script_sweep_remove_obj(obj_data *obj);
+void script_prof_report(char_data *ch, char *arg);
 void find_uid_name(char *uid, char *name, size_t nlen); 
 void do_sstat_room(struct char_data * ch);
 void do_sstat_object(char_data *ch, obj_data *j);
@@ -299,6 +322,7 @@ struct room_data *dg_room_of_obj(struct obj_data *obj);
 /* Thanks to Chris Gilbert for reminding me that there are other options. */
 int script_driver(void *go_adress, trig_data *trig, int type, int mode);
 trig_rnum real_trigger(trig_vnum vnum);
+trig_rnum first_trigger_from(trig_vnum vnum);
 void process_eval(void *go, struct script_data *sc, trig_data *trig,
                  int type, char *cmd);
 void read_saved_vars(struct char_data *ch); 
@@ -350,6 +374,13 @@ void sub_write_to_char(char_data *ch, char *tokens[],
 void sub_write(char *arg, char_data *ch, byte find_invis, int targets);
 void send_to_zone(char *messg, zone_rnum zone);
 
+/* from dg_speech.c */
+struct speech_index *room_speech_index(room_rnum room);
+void speech_index_dirty(room_rnum room);
+void speech_index_scan(struct speech_index *idx, const char *str);
+int speech_trigger_match(struct speech_index *idx, trig_data *t, char *str);
+void free_speech_index(struct speech_index *idx);
+
 /* from dg_misc.c */
 void do_dg_cast(void *go, struct script_data *sc, trig_data *trig, 
     int type, char *cmd);
@@ -0,0 +1,374 @@
+/**************************************************************************
+*  File: dg_speech.c                                                      *
+*                                                                         *
+*  Usage: per-room matchers for speech and act trigger phrases.           *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+*                                                                         *
+*  Death's Gate MUD is based on CircleMUD, Copyright (C) 1993, 94.        *
+*  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+**************************************************************************/
+
+/*
+ * Every room keeps an Aho-Corasick automaton over the phrases of the
+ * speech and act triggers present in it (its own wld speech triggers and
+ * those of the mobs standing there), so a 'say' is scanned once instead
+ * of once per trigger per mob.
+ *
+ * The index is marked dirty when a scripted mob enters or leaves the room
+ * and is rebuilt the next time someone speaks there.  It never follows a
+ * trig_data pointer; instead each indexed trigger remembers the stamp of
+ * the build that gave it its slot.  A trigger whose stamp doesn't match
+ * (newly attached, moved, or edited in trigedit) is checked the old way
+ * with word_check() and the index is marked dirty for the next speech.
+ */
+
+#include "conf.h"
+#include "sysdep.h"
+
+
+#include "structs.h"
+#include "dg_scripts.h"
+#include "utils.h"
+#include "db.h"
+
+struct speech_index {
+  bool dirty;			/* rebuild before next use           */
+  unsigned long stamp;		/* build stamp handed to triggers    */
+
+  int num_pats;			/* distinct phrases                  */
+  int *pat_len;			/* length of each phrase             */
+  ubyte *hit;			/* SPEECH_x of each, last scan       */
+  const char *scanned;		/* text the hits belong to           */
+
+  int num_slots;		/* indexed triggers                  */
+  int *slot_first;		/* first entry in slot_pats          */
+  int *slot_count;		/* number of phrases, -1 = anything  */
+  int *slot_pats;		/* phrase ids of each trigger        */
+
+  int num_states;		/* automaton states, 0 is the root   */
+  int num_classes;		/* character classes, 0 is 'other'   */
+  int class_of[256];		/* lowercased char -> class          */
+  int *delta;			/* num_states x num_classes moves    */
+  int *out;			/* phrase ending at state, or -1     */
+  int *dict;			/* next state on suffix chain w/ out */
+};
+
+/* phrases collected for one build, before the automaton exists */
+struct speech_build {
+  char **text;
+  int num_pats, max_pats;
+  int *slot_pats;
+  int num_entries, max_entries;
+  int *slot_first, *slot_count;
+  int num_slots, max_slots;
+};
+
+/* what the last scan found of each phrase, in idx->hit */
+#define SPEECH_UNSEEN	0	/* it doesn't occur                  */
+#define SPEECH_WORD	1	/* it first occurs as a word         */
+#define SPEECH_INSIDE	2	/* it first occurs inside a word     */
+
+static unsigned long speech_stamp = 0;
+
+static void free_speech_tables(struct speech_index *idx)
+{
+  if (idx->pat_len)
+    free(idx->pat_len);
+  if (idx->hit)
+    free(idx->hit);
+  if (idx->slot_first)
+    free(idx->slot_first);
+  if (idx->slot_count)
+    free(idx->slot_count);
+  if (idx->slot_pats)
+    free(idx->slot_pats);
+  if (idx->delta)
+    free(idx->delta);
+  if (idx->out)
+    free(idx->out);
+  if (idx->dict)
+    free(idx->dict);
+}
+
+void free_speech_index(struct speech_index *idx)
+{
+  if (!idx)
+    return;
+  free_speech_tables(idx);
+  free(idx);
+}
+
+void speech_index_dirty(room_rnum room)
+{
+  if (room != NOWHERE && room <= top_of_world && world[room].speech)
+    world[room].speech->dirty = TRUE;
+}
+
+/* returns the id of a phrase, adding it if it is new */
+static int speech_add_phrase(struct speech_build *b, const char *phrase)
+{
+  char *p;
+  int i;
+
+  for (i = 0; i < b->num_pats; i++)
+    if (!str_cmp(b->text[i], phrase))
+      return i;
+
+  if (b->num_pats == b->max_pats) {
+    b->max_pats = b->max_pats * 2 + 8;
+    RECREATE(b->text, char *, b->max_pats);
+  }
+  b->text[b->num_pats] = strdup(phrase);
+  for (p = b->text[b->num_pats]; *p; p++)
+    *p = LOWER(*p);
+
+  return b->num_pats++;
+}
+
+static void speech_add_entry(struct speech_build *b, int pat)
+{
+  if (b->num_entries == b->max_entries) {
+    b->max_entries = b->max_entries * 2 + 8;
+    RECREATE(b->slot_pats, int, b->max_entries);
+  }
+  b->slot_pats[b->num_entries++] = pat;
+}
+
+/* gives trigger t a slot and records the phrases it listens for */
+static void speech_add_trigger(struct speech_build *b, trig_data *t,
+                               unsigned long stamp)
+{
+  char words[MAX_INPUT_LENGTH], phrase[MAX_INPUT_LENGTH], *s;
+  int slot;
+
+  if (b->num_slots == b->max_slots) {
+    b->max_slots = b->max_slots * 2 + 8;
+    RECREATE(b->slot_first, int, b->max_slots);
+    RECREATE(b->slot_count, int, b->max_slots);
+  }
+  slot = b->num_slots++;
+  b->slot_first[slot] = b->num_entries;
+  b->slot_count[slot] = 0;
+
+  if (!GET_TRIG_ARG(t) || !*GET_TRIG_ARG(t))
+    ;				/* no phrases: it matches nothing */
+  else if (GET_TRIG_NARG(t)) {
+    /* same rules as word_check() */
+    if (*GET_TRIG_ARG(t) == '*')
+      b->slot_count[slot] = -1;
+    else {
+      strlcpy(words, GET_TRIG_ARG(t), sizeof(words));
+      for (s = one_phrase(words, phrase); *phrase; s = one_phrase(s, phrase)) {
+        speech_add_entry(b, speech_add_phrase(b, phrase));
+        b->slot_count[slot]++;
+      }
+    }
+  } else {
+    /* same rules as is_substring() on the whole argument */
+    speech_add_entry(b, speech_add_phrase(b, GET_TRIG_ARG(t)));
+    b->slot_count[slot] = 1;
+  }
+
+  t->speech_slot = slot;
+  t->speech_stamp = stamp;
+}
+
+/* builds the goto/failure automaton over the collected phrases */
+static void speech_build_automaton(struct speech_index *idx,
+                                   struct speech_build *b)
+{
+  int i, c, s, r, u, len, max_states, head, tail, *fail, *queue;
+  char *p;
+
+  memset(idx->class_of, 0, sizeof(idx->class_of));
+  idx->num_classes = 1;
+  for (max_states = 1, i = 0; i < b->num_pats; i++)
+    for (p = b->text[i]; *p; p++, max_states++)
+      if (!idx->class_of[(unsigned char) *p])
+        idx->class_of[(unsigned char) *p] = idx->num_classes++;
+
+  /* input is lowered before lookup, so map uppercase the same way */
+  for (c = 'A'; c <= 'Z'; c++)
+    idx->class_of[c] = idx->class_of[LOWER(c)];
+
+  CREATE(idx->delta, int, max_states * idx->num_classes);
+  CREATE(idx->out, int, max_states);
+  CREATE(idx->dict, int, max_states);
+  CREATE(idx->pat_len, int, MAX(1, b->num_pats));
+  CREATE(idx->hit, ubyte, MAX(1, b->num_pats));
+  CREATE(fail, int, max_states);
+  CREATE(queue, int, max_states);
+
+  for (i = 0; i < max_states * idx->num_classes; i++)
+    idx->delta[i] = -1;
+  for (i = 0; i < max_states; i++)
+    idx->out[i] = -1;
+
+  /* the trie */
+  idx->num_states = 1;
+  for (i = 0; i < b->num_pats; i++) {
+    for (s = 0, len = 0, p = b->text[i]; *p; p++, len++) {
+      c = idx->class_of[(unsigned char) *p];
+      if (idx->delta[s * idx->num_classes + c] < 0)
+        idx->delta[s * idx->num_classes + c] = idx->num_states++;
+      s = idx->delta[s * idx->num_classes + c];
+    }
+    idx->out[s] = i;
+    idx->pat_len[i] = len;
+  }
+
+  /* failure links, breadth first, turning the trie into a full DFA */
+  head = tail = 0;
+  for (c = 0; c < idx->num_classes; c++) {
+    if ((u = idx->delta[c]) < 0)
+      idx->delta[c] = 0;
+    else {
+      fail[u] = 0;
+      idx->dict[u] = 0;
+      queue[tail++] = u;
+    }
+  }
+  while (head < tail) {
+    r = queue[head++];
+    for (c = 0; c < idx->num_classes; c++) {
+      u = idx->delta[r * idx->num_classes + c];
+      if (u < 0)
+        idx->delta[r * idx->num_classes + c] =
+          idx->delta[fail[r] * idx->num_classes + c];
+      else {
+        fail[u] = idx->delta[fail[r] * idx->num_classes + c];
+        idx->dict[u] = (idx->out[fail[u]] >= 0) ? fail[u] : idx->dict[fail[u]];
+        queue[tail++] = u;
+      }
+    }
+  }
+
+  free(fail);
+  free(queue);
+}
+
+static void build_speech_index(room_rnum room)
+{
+  struct speech_index *idx = world[room].speech;
+  struct speech_build b;
+  char_data *ch;
+  trig_data *t;
+  int i;
+
+  memset(&b, 0, sizeof(b));
+  speech_stamp++;
+
+  for (ch = world[room].people; ch; ch = ch->next_in_room)
+    if (IS_NPC(ch) && SCRIPT_CHECK(ch, MTRIG_SPEECH | MTRIG_ACT))
+      for (t = TRIGGERS(SCRIPT(ch)); t; t = t->next)
+        if (IS_SET(GET_TRIG_TYPE(t), MTRIG_SPEECH | MTRIG_ACT))
+          speech_add_trigger(&b, t, speech_stamp);
+
+  if (SCRIPT_CHECK(&world[room], WTRIG_SPEECH))
+    for (t = TRIGGERS(SCRIPT(&world[room])); t; t = t->next)
+      if (IS_SET(GET_TRIG_TYPE(t), WTRIG_SPEECH))
+        speech_add_trigger(&b, t, speech_stamp);
+
+  free_speech_tables(idx);
+  memset(idx, 0, sizeof(struct speech_index));
+
+  speech_build_automaton(idx, &b);
+
+  idx->stamp = speech_stamp;
+  idx->num_pats = b.num_pats;
+  idx->num_slots = b.num_slots;
+  idx->slot_first = b.slot_first;
+  idx->slot_count = b.slot_count;
+  idx->slot_pats = b.slot_pats;
+
+  for (i = 0; i < b.num_pats; i++)
+    free(b.text[i]);
+  if (b.text)
+    free(b.text);
+}
+
+/* returns the up to date matcher for a room */
+struct speech_index *room_speech_index(room_rnum room)
+{
+  if (room == NOWHERE || room > top_of_world)
+    return NULL;
+
+  if (!world[room].speech) {
+    CREATE(world[room].speech, struct speech_index, 1);
+    world[room].speech->dirty = TRUE;
+  }
+  if (world[room].speech->dirty)
+    build_speech_index(room);
+
+  return world[room].speech;
+}
+
+/* word boundaries as is_substring() defines them */
+#define SPEECH_EDGE(c)  (!(c) || isspace((unsigned char) (c)) || \
+                         ispunct((unsigned char) (c)))
+
+/*
+ * Finds the first occurrence of every indexed phrase in str and whether
+ * it stands as a word or phrase there.  As with is_substring(), only
+ * the first occurrence counts, so "scatter the cat" does not match "cat".
+ * Matches come out in order of where they end, and for one phrase the
+ * earliest end is the earliest start, so the first one seen is it.
+ */
+void speech_index_scan(struct speech_index *idx, const char *str)
+{
+  int i, s, o, p;
+
+  if (!idx)
+    return;
+
+  memset(idx->hit, SPEECH_UNSEEN, MAX(1, idx->num_pats));
+  idx->scanned = str;
+
+  if (!idx->num_pats)
+    return;
+
+  for (i = 0, s = 0; str[i]; i++) {
+    s = idx->delta[s * idx->num_classes + idx->class_of[(unsigned char) str[i]]];
+    for (o = (idx->out[s] >= 0) ? s : idx->dict[s]; o > 0; o = idx->dict[o]) {
+      p = idx->out[o];
+      if (idx->hit[p] != SPEECH_UNSEEN)
+        continue;
+      if ((i + 1 == idx->pat_len[p] || SPEECH_EDGE(str[i - idx->pat_len[p]])) &&
+          SPEECH_EDGE(str[i + 1]))
+        idx->hit[p] = SPEECH_WORD;
+      else
+        idx->hit[p] = SPEECH_INSIDE;
+    }
+  }
+}
+
+/*
+ * Does speech or act trigger t fire on str?  Uses the last scan of str
+ * when t is indexed, and word_check()/is_substring() when it is not.
+ */
+int speech_trigger_match(struct speech_index *idx, trig_data *t, char *str)
+{
+  int i, slot;
+
+  if (!idx || t->speech_stamp != idx->stamp) {
+    if (idx)
+      idx->dirty = TRUE;
+    if (GET_TRIG_NARG(t))
+      return word_check(str, GET_TRIG_ARG(t));
+    return is_substring(GET_TRIG_ARG(t), str);
+  }
+
+  /* a nested trigger may have scanned something else in the meantime */
+  if (idx->scanned != str)
+    speech_index_scan(idx, str);
+
+  slot = t->speech_slot;
+  if (idx->slot_count[slot] < 0)
+    return 1;
+  for (i = 0; i < idx->slot_count[slot]; i++)
+    if (idx->hit[idx->slot_pats[idx->slot_first[slot] + i]] == SPEECH_WORD)
+      return 1;
+
+  return 0;
+}
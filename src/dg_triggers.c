@@ -177,6 +177,8 @@ void greet_memory_mtrigger(char_data *actor)
 
   if (!valid_dg_target(actor, DG_ALLOW_GODS))
     return;
+  if (!(room_occupants(IN_ROOM(actor)) & OCC_SCRIPTED))
+    return;
 
   for (ch = world[IN_ROOM(actor)].people; ch; ch = ch->next_in_room) {
     if (!SCRIPT_MEM(ch) || !AWAKE(ch) || FIGHTING(ch) || (ch == actor) || 
@@ -230,6 +232,8 @@ int greet_mtrigger(char_data *actor, int dir)
  
   if (!valid_dg_target(actor, DG_ALLOW_GODS))
     return TRUE;
+  if (!(room_occupants(IN_ROOM(actor)) & OCC_SCRIPTED))
+    return TRUE;
 
   for (ch = world[IN_ROOM(actor)].people; ch; ch = ch->next_in_room) {
     if (!SCRIPT_CHECK(ch, MTRIG_GREET | MTRIG_GREET_ALL) || 
@@ -316,6 +320,147 @@ int entry_mtrigger(char_data *ch)
   return 1;
 }
 
+/*
+ *  Command trigger prefilter
+ *
+ *  Every typed command is offered to the command triggers of the room,
+ *  the mobs in it, the objects on its floor and the actor's own gear.
+ *  A command trigger can only fire on a command that begins with the
+ *  first letter of its argument, so rooms and characters keep a mask of
+ *  those letters (struct cmd_filter) and the walk is skipped when the
+ *  typed command's letter is not in the mask.  A mask is rebuilt the
+ *  next time it is needed after it goes stale: when something with
+ *  command triggers enters or leaves it (see handler.c), or when any
+ *  command trigger is attached, removed or edited (cmd_filter_stamp).
+ */
+unsigned long cmd_filter_stamp = 1;	/* current mask generation        */
+unsigned long cmd_filter_walks = 0;	/* trigger walks asked for        */
+unsigned long cmd_filter_skips = 0;	/* ...turned away by a mask       */
+unsigned long cmd_filter_avoided = 0;	/* trigger checks those skips saved */
+unsigned long cmd_filter_rebuilds = 0;	/* masks rebuilt after going stale */
+
+/* the mask bit a trigger argument or typed command falls under */
+static unsigned int cmd_filter_bit(const char *str)
+{
+  int c;
+
+  if (!str || !*str || *str == '*')
+    return CMD_FILTER_ANY;
+
+  c = LOWER(*str);
+  if (c >= 'a' && c <= 'z')
+    return (1U << (c - 'a'));
+
+  return CMD_FILTER_OTHER;
+}
+
+static void cmd_filter_add(struct cmd_filter *f, struct script_data *sc,
+                           int type, int where)
+{
+  trig_data *t;
+
+  for (t = TRIGGERS(sc); t; t = t->next)
+    if (IS_SET(GET_TRIG_TYPE(t), type) &&
+        (!where || IS_SET(GET_TRIG_NARG(t), where))) {
+      f->mask |= cmd_filter_bit(GET_TRIG_ARG(t));
+      f->trigs++;
+    }
+}
+
+/* world, mob and floor object command triggers in a room */
+static struct cmd_filter *room_cmd_filter(room_rnum room)
+{
+  struct cmd_filter *f = &world[room].cmd_filter;
+  char_data *ch;
+  obj_data *obj;
+
+  if (f->stamp == cmd_filter_stamp)
+    return f;
+
+  f->mask = 0;
+  f->trigs = 0;
+  if (SCRIPT_CHECK(&world[room], WTRIG_COMMAND))
+    cmd_filter_add(f, SCRIPT(&world[room]), WTRIG_COMMAND, 0);
+  for (ch = world[room].people; ch; ch = ch->next_in_room)
+    if (SCRIPT_CHECK(ch, MTRIG_COMMAND))
+      cmd_filter_add(f, SCRIPT(ch), MTRIG_COMMAND, 0);
+  for (obj = world[room].contents; obj; obj = obj->next_content)
+    if (SCRIPT_CHECK(obj, OTRIG_COMMAND))
+      cmd_filter_add(f, SCRIPT(obj), OTRIG_COMMAND, OCMD_ROOM);
+
+  f->stamp = cmd_filter_stamp;
+  cmd_filter_rebuilds++;
+  return f;
+}
+
+/* object command triggers in a character's equipment and inventory */
+static struct cmd_filter *char_cmd_filter(char_data *ch)
+{
+  struct cmd_filter *f = &ch->cmd_filter;
+  obj_data *obj;
+  int i;
+
+  if (f->stamp == cmd_filter_stamp)
+    return f;
+
+  f->mask = 0;
+  f->trigs = 0;
+  for (i = 0; i < NUM_WEARS; i++)
+    if (GET_EQ(ch, i) && SCRIPT_CHECK(GET_EQ(ch, i), OTRIG_COMMAND))
+      cmd_filter_add(f, SCRIPT(GET_EQ(ch, i)), OTRIG_COMMAND, OCMD_EQUIP);
+  for (obj = ch->carrying; obj; obj = obj->next_content)
+    if (SCRIPT_CHECK(obj, OTRIG_COMMAND))
+      cmd_filter_add(f, SCRIPT(obj), OTRIG_COMMAND, OCMD_INVEN);
+
+  f->stamp = cmd_filter_stamp;
+  cmd_filter_rebuilds++;
+  return f;
+}
+
+/* could any trigger summarized by f fire on cmd? */
+static int cmd_filter_pass(struct cmd_filter *f, char *cmd)
+{
+  cmd_filter_walks++;
+
+  if (f->mask & (cmd_filter_bit(cmd) | CMD_FILTER_ANY))
+    return 1;
+
+  cmd_filter_skips++;
+  cmd_filter_avoided += f->trigs;
+  return 0;
+}
+
+/* command triggers were attached, removed or edited somewhere */
+void cmd_filter_changed(void)
+{
+  cmd_filter_stamp++;
+}
+
+/*
+ * offer a typed command to the world, mob and object command triggers
+ * around the actor, in that order.  returns 1 if a trigger took it over.
+ */
+int command_trigger(char_data *actor, char *cmd, char *argument)
+{
+  int room, own;
+
+  /* prevent people we like from becoming trapped :P */
+  if (!valid_dg_target(actor, 0))
+    return 0;
+
+  room = cmd_filter_pass(room_cmd_filter(IN_ROOM(actor)), cmd);
+  own = cmd_filter_pass(char_cmd_filter(actor), cmd);
+
+  if (room && command_wtrigger(actor, cmd, argument))
+    return 1;
+  if (room && command_mtrigger(actor, cmd, argument))
+    return 1;
+  if ((room || own) && command_otrigger(actor, cmd, argument))
+    return 1;
+
+  return 0;
+}
+
 int command_mtrigger(char_data *actor, char *cmd, char *argument)
 {
   char_data *ch, *ch_next;
@@ -365,6 +510,10 @@ void speech_mtrigger(char_data *actor, char *str)
   char_data *ch, *ch_next;
   trig_data *t;
   char buf[MAX_INPUT_LENGTH];
+  struct speech_index *idx;
+
+  idx = room_speech_index(IN_ROOM(actor));
+  speech_index_scan(idx, str);
 
   for (ch = world[IN_ROOM(actor)].people; ch; ch = ch_next)
   {
@@ -382,8 +531,7 @@ void speech_mtrigger(char_data *actor, char *str)
           continue;
         }
 
-        if (((GET_TRIG_NARG(t) && word_check(str, GET_TRIG_ARG(t))) ||
-             (!GET_TRIG_NARG(t) && is_substring(GET_TRIG_ARG(t), str)))) {
+        if (speech_trigger_match(idx, t, str)) {
           ADD_UID_VAR(buf, t, actor, "actor", 0);
           add_var(&GET_TRIG_VARS(t), "speech", str, 0);
           script_driver(&ch, t, MOB_TRIGGER, TRIG_NEW);
@@ -400,6 +548,7 @@ void act_mtrigger(const char_data *ch, char *str, char_data *actor,
 {
   trig_data *t;
   char buf[MAX_INPUT_LENGTH];
+  struct speech_index *idx = NULL;
   
   if (SCRIPT_CHECK(ch, MTRIG_ACT) && !AFF_FLAGGED(ch, AFF_CHARM) &&
       (actor!=ch))
@@ -413,8 +562,13 @@ void act_mtrigger(const char_data *ch, char *str, char_data *actor,
         continue;
       }
 
-      if (((GET_TRIG_NARG(t) && word_check(str, GET_TRIG_ARG(t))) ||
-           (!GET_TRIG_NARG(t) && is_substring(GET_TRIG_ARG(t), str)))) {
+      /* only scan the message once some act trigger wants it */
+      if (!idx) {
+        idx = room_speech_index(IN_ROOM(ch));
+        speech_index_scan(idx, str);
+      }
+
+      if (speech_trigger_match(idx, t, str)) {
         if (actor)
           ADD_UID_VAR(buf, t, actor, "actor", 0);
         if (victim)
@@ -1146,11 +1300,15 @@ void speech_wtrigger(char_data *actor, char *str)
   struct room_data *room;
   trig_data *t;
   char buf[MAX_INPUT_LENGTH];
+  struct speech_index *idx;
 
   if (!actor || !SCRIPT_CHECK(&world[IN_ROOM(actor)], WTRIG_SPEECH))
     return;
 
   room = &world[IN_ROOM(actor)];
+  idx = room_speech_index(IN_ROOM(actor));
+  speech_index_scan(idx, str);
+
   for (t = TRIGGERS(SCRIPT(room)); t; t = t->next) {
     if (!TRIGGER_CHECK(t, WTRIG_SPEECH))
       continue;
@@ -1161,9 +1319,7 @@ void speech_wtrigger(char_data *actor, char *str)
       continue;
     }
 
-    if (*GET_TRIG_ARG(t)=='*' ||
-       (GET_TRIG_NARG(t) && word_check(str, GET_TRIG_ARG(t))) ||
-       (!GET_TRIG_NARG(t) && is_substring(GET_TRIG_ARG(t), str))) {
+    if (*GET_TRIG_ARG(t)=='*' || speech_trigger_match(idx, t, str)) {
       ADD_UID_VAR(buf, t, actor, "actor", 0);
       add_var(&GET_TRIG_VARS(t), "speech", str, 0);
       script_driver(&room, t, WLD_TRIGGER, TRIG_NEW);
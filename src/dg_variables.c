@@ -53,7 +53,7 @@ void add_var(struct trig_var_data **var_list, char *name, char *value, long id)
   }
 
   else {
-    CREATE(vd, struct trig_var_data, 1);
+    SLAB_CREATE(vd, struct trig_var_data, SLAB_TRIG_VAR);
     
     CREATE(vd->name, char, strlen(name) + 1);
     strcpy(vd->name, name);                            /* strcpy: ok*/
@@ -420,6 +420,9 @@ void find_replacement(void *go, struct script_data *sc, trig_data *trig,
         - count number of objects in room X with this name/id/vnum
       %findmob.<room vnum X>(<mob vnum Y>)% 
         - count number of mobs in room X with vnum Y
+      %findpath.<room vnum X>(<room vnum Y>)%
+        - the directions from room X to room Y, separated by spaces,
+          or nothing if there is no way there
 
 for example you want to check how many PC's are in room with vnum 1204.
 as PC's have the vnum -1...
@@ -473,6 +476,22 @@ in the vault (vnum: 453) now and then. you can just use
           }
         }
       }
+      else if (!str_cmp(var, "findpath")) {
+        room_rnum from, to;
+        int route[500], steps;
+        size_t len = 0;
+
+        *str = '\0';
+        if (!field || !*field || !subfield || !*subfield)
+          script_log("findpath.vnum(vnum) - illegal syntax");
+        else if ((from = real_room(atoi(field))) == NOWHERE ||
+                 (to = real_room(atoi(subfield))) == NOWHERE)
+          script_log("findpath.vnum(vnum): No room with vnum %d", 
+                     real_room(atoi(field)) == NOWHERE ? atoi(field) : atoi(subfield));
+        else if ((steps = path_route(from, to, route, 500)) > 0)
+          for (i = 0; i < steps && len < slen; i++)
+            len += snprintf(str + len, slen - len, "%s%s", i ? " " : "", dirs[route[i]]);
+      }
       else if (!str_cmp(var, "random")) {
         if (!str_cmp(field, "char")) {
           rndm = NULL;
@@ -711,6 +730,7 @@ in the vault (vnum: 453) now and then. you can just use
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_HIT(c) += addition;
+              gmcp_hit_changed(c);
               update_pos(c);
             }
             snprintf(str, slen, "%d", GET_HIT(c));
@@ -801,6 +821,7 @@ in the vault (vnum: 453) now and then. you can just use
             if (subfield && *subfield) {
               int addition = atoi(subfield);
               GET_MANA(c) += addition;
+              GMCP_DIRTY(c, GMCP_VITALS);
             }
             snprintf(str, slen, "%d", GET_MANA(c));
           }
@@ -1102,8 +1123,8 @@ o->contains) ? "1" : "0"));
             snprintf(str, slen, "%ld", GET_ID(o));
 
           else if (!str_cmp(field, "is_inroom")) {
-            if (IN_ROOM(o) != NOWHERE)
-              snprintf(str, slen,"%c%ld",UID_CHAR, (long) world[IN_ROOM(o)].number + ROOM_ID_BASE); 
+            if (OBJ_IN_ROOM(o) != NOWHERE)
+              snprintf(str, slen,"%c%ld",UID_CHAR, (long) world[OBJ_IN_ROOM(o)].number + ROOM_ID_BASE); 
             else
               *str = '\0';
           }
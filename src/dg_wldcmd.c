@@ -296,6 +296,7 @@ WCMD(do_wdoor)
             break;
         }
     }
+    path_exits_changed();
 }
 
 
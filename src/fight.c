@@ -27,16 +27,41 @@
 struct char_data *combat_list = NULL;	/* head of l-list of fighting chars */
 struct char_data *next_combat_list = NULL;
 
+/* fight_messages by attack type, filled in by load_messages() */
+static struct message_list *fight_msg_index[TYPE_SUFFERING + 1];
+
+/*
+ * perform_violence() takes the combat list a room at a time.  When nobody
+ * in a room can hear it (no descriptors, no act triggers) the hit and miss
+ * messages for that room are never put together; combat_quiet says so to
+ * dam_message() and skill_message() for the turns taken there.
+ */
+static bool combat_quiet = FALSE;
+static bool combat_cache_on = TRUE;	/* these two are for		*/
+static bool combat_bench_loud = FALSE;	/*   'show combat bench'	*/
+
+struct combat_counts {
+  unsigned long rounds;		/* calls to perform_violence()		*/
+  unsigned long turns;		/* characters who took a turn		*/
+  unsigned long rooms;		/* rooms fights were resolved in	*/
+  unsigned long quiet_rooms;	/* ... of which nobody was listening	*/
+  unsigned long stats_built;	/* combat_stats() worked out again	*/
+  unsigned long stats_cached;	/* combat_stats() already known		*/
+};
+static struct combat_counts combat_counts;
+
 /* External structures */
 extern struct message_list fight_messages[MAX_MESSAGES];
 
 /* External procedures */
 char *fread_action(FILE *fl, int nr);
 ACMD(do_flee);
+ACMD(do_reload);
 int backstab_mult(int level);
 int thaco(struct char_data *ch);
 //int thaco(int ch_class, int level);
 int ok_damage_shopkeeper(struct char_data *ch, struct char_data *victim);
+void queue_aggro_check(room_rnum room);
 
 /* local functions */
 void perform_group_gain(struct char_data *ch, int base, struct char_data *victim);
@@ -58,6 +83,7 @@ void perform_violence(void);
 int compute_armor_class(struct char_data *ch);
 int compute_thaco(struct char_data *ch, struct char_data *vict);
 int calc_hits(struct char_data *ch, struct char_data *victim);
+void timediff(struct timeval *diff, struct timeval *a, struct timeval *b);
 
 /* Weapon attack texts */
 struct attack_hit_type attack_hit_text[] =
@@ -91,6 +117,7 @@ void appear(struct char_data *ch)
     affect_from_char(ch, SPELL_INVISIBLE);
 
   REMOVE_BIT(AFF_FLAGS(ch), AFF_INVISIBLE | AFF_HIDE);
+  room_census_dirty(IN_ROOM(ch));
 
   if (GET_LEVEL(ch) < LVL_IMMORT)
     act("$n slowly fades into existence.", FALSE, ch, 0, 0, TO_ROOM);
@@ -134,6 +161,8 @@ void free_messages(void)
       fight_messages[i].msg = fight_messages[i].msg->next;
       free(former);
     }
+
+  memset(fight_msg_index, 0, sizeof(fight_msg_index));
 }
 
 
@@ -194,6 +223,13 @@ void load_messages(void)
   log("Return value of fgets is: %s", error);
 
   fclose(fl);
+
+  memset(fight_msg_index, 0, sizeof(fight_msg_index));
+  for (i = 0; i < MAX_MESSAGES && fight_messages[i].a_type; i++)
+    if (fight_messages[i].a_type > 0 && fight_messages[i].a_type <= TYPE_SUFFERING)
+      fight_msg_index[fight_messages[i].a_type] = &fight_messages[i];
+    else
+      log("SYSERR: Combat messages for unknown attack type %d.", fight_messages[i].a_type);
 }
 
 
@@ -247,6 +283,7 @@ void set_fighting(struct char_data *ch, struct char_data *vict)
 
   FIGHTING(ch) = vict;
   GET_POS(ch) = POS_FIGHTING;
+  GMCP_DIRTY(ch, GMCP_COMBAT);
 
   if (!CONFIG_PK_ALLOWED)
     check_killer(ch, vict);
@@ -267,6 +304,12 @@ void stop_fighting(struct char_data *ch)
   FIGHTING(ch) = NULL;
   GET_POS(ch) = POS_STANDING;
   update_pos(ch);
+  GMCP_DIRTY(ch, GMCP_COMBAT);
+
+  /* anyone else here it would go for? */
+  if (IS_NPC(ch) && MOB_FLAGGED(ch, MOB_AGGRESSIVE | MOB_AGGR_EVIL |
+	MOB_AGGR_NEUTRAL | MOB_AGGR_GOOD | MOB_MEMORY))
+    queue_aggro_check(IN_ROOM(ch));
 }
 
 
@@ -281,7 +324,7 @@ void make_corpse(struct char_data *ch)
   corpse = create_obj();
 
   corpse->item_number = NOTHING;
-  IN_ROOM(corpse) = NOWHERE;
+  OBJ_IN_ROOM(corpse) = NOWHERE;
   corpse->name = strdup("corpse");
 
   snprintf(buf2, sizeof(buf2), "The corpse of %s is lying here.", GET_NAME(ch));
@@ -298,9 +341,9 @@ void make_corpse(struct char_data *ch)
   GET_OBJ_WEIGHT(corpse) = GET_WEIGHT(ch) + IS_CARRYING_W(ch);
   GET_OBJ_RENT(corpse) = 100000;
   if (IS_NPC(ch))
-    GET_OBJ_TIMER(corpse) = CONFIG_MAX_NPC_CORPSE_TIME;
+    set_obj_timer(corpse, CONFIG_MAX_NPC_CORPSE_TIME);
   else
-    GET_OBJ_TIMER(corpse) = CONFIG_MAX_PC_CORPSE_TIME;
+    set_obj_timer(corpse, CONFIG_MAX_PC_CORPSE_TIME);
 
   /* transfer character's inventory to the corpse */
   corpse->contains = ch->carrying;
@@ -577,6 +620,9 @@ void dam_message(int dam, struct char_data *ch, struct char_data *victim,
   };
 
 
+  if (combat_quiet)
+    return;
+
   w_type -= TYPE_HIT;		/* Change to base of table with text */
 
   if (dam == 0)		msgnum = 0;
@@ -617,69 +663,70 @@ void dam_message(int dam, struct char_data *ch, struct char_data *victim,
 int skill_message(int dam, struct char_data *ch, struct char_data *vict,
 		      int attacktype)
 {
-  load_messages();
-  int i, j, nr;
-  struct message_type *msg = malloc(sizeof(struct message_type));
-
+  int j, nr;
+  struct message_list *list;
+  struct message_type *msg;
   struct obj_data *weap = GET_EQ(ch, WEAR_WIELD);
 
-  for (i = 0; i < MAX_MESSAGES; i++) {
-    if (fight_messages[i].a_type == attacktype) {
-      nr = dice(1, fight_messages[i].number_of_attacks);
-      for (j = 1, msg = fight_messages[i].msg; (j < nr) && msg; j++)
-	msg = msg->next;
-
-      if (!IS_NPC(vict) && (GET_LEVEL(vict) >= LVL_IMPL)) {
-	act(msg->god_msg.attacker_msg, FALSE, ch, weap, vict, TO_CHAR);
-	act(msg->god_msg.victim_msg, FALSE, ch, weap, vict, TO_VICT);
-	act(msg->god_msg.room_msg, FALSE, ch, weap, vict, TO_NOTVICT);
-      } else if (dam != 0) {
-        /*
-         * Don't send redundant color codes for TYPE_SUFFERING & other types
-         * of damage without attacker_msg.
-         */
-	if (GET_POS(vict) == POS_DEAD) {
-          if (msg->die_msg.attacker_msg) {
-            send_to_char(ch, CCYEL(ch, C_CMP));
-            act(msg->die_msg.attacker_msg, FALSE, ch, weap, vict, TO_CHAR);
-            send_to_char(ch, CCNRM(ch, C_CMP));
-          }
-
-	  send_to_char(vict, CCRED(vict, C_CMP));
-	  act(msg->die_msg.victim_msg, FALSE, ch, weap, vict, TO_VICT | TO_SLEEP);
-	  send_to_char(vict, CCNRM(vict, C_CMP));
-
-	  act(msg->die_msg.room_msg, FALSE, ch, weap, vict, TO_NOTVICT);
-	} else {
-        if (msg->hit_msg.attacker_msg) {
-		  send_to_char(ch, CCYEL(ch, C_CMP));
-		  act(msg->hit_msg.attacker_msg, FALSE, ch, weap, vict, TO_CHAR);
-		  send_to_char(ch, CCNRM(ch, C_CMP));
-        }
-
-		send_to_char(vict, CCRED(vict, C_CMP));
-		act(msg->hit_msg.victim_msg, FALSE, ch, weap, vict, TO_VICT | TO_SLEEP);
-		send_to_char(vict, CCNRM(vict, C_CMP));
-
-		act(msg->hit_msg.room_msg, FALSE, ch, weap, vict, TO_NOTVICT);
-	}
-      } else if (ch != vict) {	/* Dam == 0 */
-        if (msg->miss_msg.attacker_msg) {
-		  send_to_char(ch, CCYEL(ch, C_CMP));
-		  act(msg->miss_msg.attacker_msg, FALSE, ch, weap, vict, TO_CHAR);
-		  send_to_char(ch, CCNRM(ch, C_CMP));
-        }
-
-		send_to_char(vict, CCRED(vict, C_CMP));
-		act(msg->miss_msg.victim_msg, FALSE, ch, weap, vict, TO_VICT | TO_SLEEP);
-		send_to_char(vict, CCNRM(vict, C_CMP));
-
-		act(msg->miss_msg.room_msg, FALSE, ch, weap, vict, TO_NOTVICT);
+  if (attacktype <= 0 || attacktype > TYPE_SUFFERING ||
+      !(list = fight_msg_index[attacktype]))
+    return (0);
+  /* roll even if nobody hears it, to keep the random numbers in step */
+  nr = dice(1, list->number_of_attacks);
+  if (combat_quiet)
+    return (1);
+
+  for (j = 1, msg = list->msg; (j < nr) && msg; j++)
+    msg = msg->next;
+
+  if (!IS_NPC(vict) && (GET_LEVEL(vict) >= LVL_IMPL)) {
+    act(msg->god_msg.attacker_msg, FALSE, ch, weap, vict, TO_CHAR);
+    act(msg->god_msg.victim_msg, FALSE, ch, weap, vict, TO_VICT);
+    act(msg->god_msg.room_msg, FALSE, ch, weap, vict, TO_NOTVICT);
+  } else if (dam != 0) {
+    /*
+     * Don't send redundant color codes for TYPE_SUFFERING & other types
+     * of damage without attacker_msg.
+     */
+    if (GET_POS(vict) == POS_DEAD) {
+      if (msg->die_msg.attacker_msg) {
+        send_to_char(ch, CCYEL(ch, C_CMP));
+        act(msg->die_msg.attacker_msg, FALSE, ch, weap, vict, TO_CHAR);
+        send_to_char(ch, CCNRM(ch, C_CMP));
       }
-      return (1);
+
+      send_to_char(vict, CCRED(vict, C_CMP));
+      act(msg->die_msg.victim_msg, FALSE, ch, weap, vict, TO_VICT | TO_SLEEP);
+      send_to_char(vict, CCNRM(vict, C_CMP));
+
+      act(msg->die_msg.room_msg, FALSE, ch, weap, vict, TO_NOTVICT);
+    } else {
+      if (msg->hit_msg.attacker_msg) {
+        send_to_char(ch, CCYEL(ch, C_CMP));
+        act(msg->hit_msg.attacker_msg, FALSE, ch, weap, vict, TO_CHAR);
+        send_to_char(ch, CCNRM(ch, C_CMP));
+      }
+
+      send_to_char(vict, CCRED(vict, C_CMP));
+      act(msg->hit_msg.victim_msg, FALSE, ch, weap, vict, TO_VICT | TO_SLEEP);
+      send_to_char(vict, CCNRM(vict, C_CMP));
+
+      act(msg->hit_msg.room_msg, FALSE, ch, weap, vict, TO_NOTVICT);
+    }
+  } else if (ch != vict) {	/* Dam == 0 */
+    if (msg->miss_msg.attacker_msg) {
+      send_to_char(ch, CCYEL(ch, C_CMP));
+      act(msg->miss_msg.attacker_msg, FALSE, ch, weap, vict, TO_CHAR);
+      send_to_char(ch, CCNRM(ch, C_CMP));
     }
+
+    send_to_char(vict, CCRED(vict, C_CMP));
+    act(msg->miss_msg.victim_msg, FALSE, ch, weap, vict, TO_VICT | TO_SLEEP);
+    send_to_char(vict, CCNRM(vict, C_CMP));
+
+    act(msg->miss_msg.room_msg, FALSE, ch, weap, vict, TO_NOTVICT);
   }
-  return (0);
+  return (1);
 }
 
 /*
@@ -702,8 +749,8 @@ int damage(struct char_data *ch, struct char_data *victim, int dam, int attackty
   }
 
   /* peaceful rooms */
-  if (ch->nr != real_mobile(DG_CASTER_PROXY) &&
-      ch != victim && ROOM_FLAGGED(IN_ROOM(ch), ROOM_PEACEFUL)) {
+  if (ch != victim && ROOM_FLAGGED(IN_ROOM(ch), ROOM_PEACEFUL) &&
+      ch->nr != real_mobile(DG_CASTER_PROXY)) {
     send_to_char(ch, "This room just has such a peaceful, easy feeling...\r\n");
     return (0);
   }
@@ -751,6 +798,7 @@ int damage(struct char_data *ch, struct char_data *victim, int dam, int attackty
   /* Set the maximum damage per round and subtract the hit points */
   dam = MAX(MIN(dam, 100), 0);
   GET_HIT(victim) -= dam;
+  gmcp_hit_changed(victim);
 
   /* Gain exp for the hit */
   if (ch != victim)
@@ -875,57 +923,92 @@ int compute_thaco(struct char_data *ch, struct char_data *victim)
   return calc_thaco;
 }
 
-int calc_hits(struct char_data *ch, struct char_data *victim)
+/*
+ * The attacker's side of calc_hits() and hit() only changes when its
+ * equipment, affects or skills do, so it is worked out once and kept in
+ * ch->combat until affect_total() or SET_SKILL() marks it stale.
+ */
+static struct combat_stats *combat_stats(struct char_data *ch)
 {
-  if(!GET_AMMO(ch)){ //can't fire with no bullets
-    send_to_char(ch, "You have to realod!\r\n");
-    return 0;
+  struct combat_stats *cs = &ch->combat;
+  struct obj_data *wielded = GET_EQ(ch, WEAR_WIELD);
+
+  if (cs->valid && combat_cache_on) {
+    combat_counts.stats_cached++;
+    return (cs);
+  }
+  combat_counts.stats_built++;
+
+  /* Find the weapon type (for display purposes only) */
+  if (wielded && GET_OBJ_TYPE(wielded) == ITEM_WEAPON)
+    cs->w_type = GET_OBJ_VAL(wielded, 5);
+  else if (IS_NPC(ch) && ch->mob_specials.attack_type != 0)
+    cs->w_type = ch->mob_specials.attack_type + TYPE_HIT;
+  else
+    cs->w_type = TYPE_HIT;
+
+  cs->min_dam = 1;
+  cs->max_dam = 3;
+  if (IS_NPC(ch))
+    cs->max_dam = ch->mob_specials.damsizedice;
+  else if (wielded) {
+    cs->min_dam = GET_OBJ_VAL(wielded, 1);
+    cs->max_dam = GET_OBJ_VAL(wielded, 2);
+  }
+
+  /* an unarmed critical hit does no extra damage */
+  cs->crit_mult = wielded ? GET_OBJ_VAL(wielded, 4) : 1;
+  cs->max_crit = (!IS_NPC(ch) && GET_SKILL(ch, SKILL_CRITICAL) == 100) ? 13 : 20;
+
+  if (IS_NPC(ch)) {
+    cs->thaco = 0;
+    cs->attacks = ch->mob_specials.damnodice;
+  } else {
+    cs->thaco = thaco(ch);
+    cs->attacks = GET_ATTACKS(ch);
+    if (GET_SKILL(ch, SKILL_RAPID_FIRE))
+      cs->attacks += cs->attacks / 2;
+  }
+  cs->attacks = MAX(1, cs->attacks);
+
+  cs->valid = TRUE;
+  return (cs);
 }
-  GET_AMMO(ch)--;
-  int max_crit = 20, dam, w_type, diceroll, crit_roll, thaco;
+
+int calc_hits(struct char_data *ch, struct char_data *victim)
+{
+  /* mobs don't carry ammunition */
+  if (!IS_NPC(ch)) {
+    if(!GET_AMMO(ch)){ //can't fire with no bullets
+      send_to_char(ch, "You have to realod!\r\n");
+      return 0;
+    }
+    GET_AMMO(ch)--;
+  }
+  int dam, w_type, diceroll, crit_roll, thaco;
   int victim_evasion = GET_EVASION(ch);
   bool is_crit = FALSE;
-  struct affected_type *af;
-  struct obj_data *wielded = GET_EQ(ch, WEAR_WIELD);
+  struct affected_type af[1];
   struct obj_data *armor = GET_EQ(ch, WEAR_BODY);
+  struct combat_stats *cs = combat_stats(ch);
   
 
   /* Calculate chance of hit. */
-  thaco = compute_thaco(ch, victim); //look at mob version
+  if (IS_NPC(ch))
+    thaco = compute_thaco(ch, victim); //look at mob version
+  else
+    thaco = cs->thaco;
   //victim_ac = compute_armor_class(victim) / 10;
 
-  /* Find the weapon type (for display purposes only) */
-  if (wielded && GET_OBJ_TYPE(wielded) == ITEM_WEAPON){
-    log("Player has weapon");
-    w_type = GET_OBJ_VAL(wielded, 5);
-  }
-  else {
-    if (IS_NPC(ch) && ch->mob_specials.attack_type != 0)
-      w_type = ch->mob_specials.attack_type + TYPE_HIT;
-    else
-      w_type = TYPE_HIT;
-  }
-  log("%s has weapon type: %d", ch->player.name, w_type);
-  int min_dam = 1, max_dam = 3;
-  if(IS_NPC(ch)) {
-    max_dam = ch->mob_specials.damsizedice;
-  }
-  else {
-    if (wielded){
-      min_dam = GET_OBJ_VAL(wielded, 1);
-      max_dam = GET_OBJ_VAL(wielded, 2);
-    }
-  }
+  w_type = cs->w_type;
   /* roll the die and take your chances... */
   diceroll = rand_number(1, 100);
   if (!AWAKE(victim) || diceroll <= thaco - victim_evasion ){ // HIT
-    dam = dice_roll(min_dam, max_dam);
+    dam = dice_roll(cs->min_dam, cs->max_dam);
     /* Check to see if it's a crit*/
-    if(!IS_NPC(ch) && GET_SKILL(ch, SKILL_CRITICAL) == 100)
-      max_crit = 13;
-    crit_roll = rand_number(1, max_crit);
-    if(crit_roll == max_crit){ // CRITICAL HIT
-      dam *= GET_OBJ_VAL(wielded, 4);
+    crit_roll = rand_number(1, cs->max_crit);
+    if(crit_roll == cs->max_crit){ // CRITICAL HIT
+      dam *= cs->crit_mult;
       is_crit = TRUE;
     }
     /* at least 1 hp damage min per hit */
@@ -940,10 +1023,12 @@ int calc_hits(struct char_data *ch, struct char_data *victim)
         af->modifier = 0;
         af->location = APPLY_NONE;        
         af->bitvector = AFF_BLEED;
-        affect_to_char(ch, &af);
+        affect_to_char(ch, af);
       }
-      if(GET_SKILL(ch, SKILL_HEAL_CRIT))
+      if(GET_SKILL(ch, SKILL_HEAL_CRIT)) {
         GET_HIT(ch) += 5;
+        gmcp_hit_changed(ch);
+      }
     }
     dam += GET_DAMROLL(ch); // Add bonus damage
     if (armor) dam -= GET_OBJ_VAL(armor, 0);
@@ -973,25 +1058,25 @@ void hit(struct char_data *ch, struct char_data *victim, int type)
 
   /* Perform each attack seperately*/
   //dice(ch->mob_specials.damnodice, ch->mob_specials.damsizedice);
-  if (IS_NPC(ch))
-    num_attacks = ch->mob_specials.damnodice;
-  else{
-    if(AFF_FLAGGED(ch, AFF_RELOAD)){
-      send_to_char(ch, "You are reloading....");
-      return;
-    }
-
-    num_attacks = GET_ATTACKS(ch);
-    if(GET_SKILL(ch, SKILL_RAPID_FIRE))
-      num_attacks += num_attacks/2;
+  if (!IS_NPC(ch) && AFF_FLAGGED(ch, AFF_RELOAD)) {
+    send_to_char(ch, "You are reloading....");
+    return;
   }
-  if (num_attacks < 1) num_attacks = 1;
-  while (num_attacks-- > 0){
-    if(calc_hits(ch, victim)){ // Have to reload
-      send_to_char(ch, "You have to reload!\r\n");
-      perform_act("reload", ch, NULL, NULL, NULL); // force reload
+  /*
+   * Every attack the character has in a round (GET_ATTACKS, more with
+   * rapid fire; a mob's bare hand dice), until a player runs out of
+   * ammunition and stops to reload, or one of them is dead or gone.
+   */
+  num_attacks = combat_stats(ch)->attacks;
+  while (num_attacks-- > 0) {
+    if (!calc_hits(ch, victim)) {
+      if (!AFF_FLAGGED(ch, AFF_RELOAD))
+        do_reload(ch, "", 0, 0); // force reload
       break;
     }
+    if (GET_POS(victim) <= POS_DEAD || GET_POS(ch) <= POS_DEAD ||
+	IN_ROOM(ch) != IN_ROOM(victim))
+      break;
   }
 
     /*
@@ -1016,10 +1101,60 @@ void hit(struct char_data *ch, struct char_data *victim, int type)
 
 
 
+/* does anybody in the room hear what goes on there? */
+static bool room_has_listeners(room_rnum room)
+{
+  struct char_data *i;
+
+  for (i = world[room].people; i; i = i->next_in_room)
+    if (i->desc || SCRIPT_CHECK(i, MTRIG_ACT))
+      return (TRUE);
+  return (FALSE);
+}
+
+/*
+ * Merge sorts the combat list by room, keeping the order of fighters in
+ * the same room, so perform_violence() meets each room's fights together.
+ */
+static struct char_data *sort_combat_list(struct char_data *list)
+{
+  struct char_data *a, *b, *slow, *fast, *head = NULL, **tail = &head;
+
+  if (!list || !list->next_fighting)
+    return (list);
+
+  for (slow = list, fast = list->next_fighting; fast && fast->next_fighting;
+       fast = fast->next_fighting->next_fighting)
+    slow = slow->next_fighting;
+  b = slow->next_fighting;
+  slow->next_fighting = NULL;
+
+  a = sort_combat_list(list);
+  b = sort_combat_list(b);
+
+  while (a && b) {
+    if (IN_ROOM(b) < IN_ROOM(a)) {
+      *tail = b;
+      b = b->next_fighting;
+    } else {
+      *tail = a;
+      a = a->next_fighting;
+    }
+    tail = &(*tail)->next_fighting;
+  }
+  *tail = a ? a : b;
+  return (head);
+}
+
 /* control the fights going on.  Called every 2 seconds from comm.c. */
 void perform_violence(void)
 {
   struct char_data *ch;
+  room_rnum room = NOWHERE;
+  int was = rng_use(RNG_COMBAT);
+
+  combat_counts.rounds++;
+  combat_list = sort_combat_list(combat_list);
 
   for (ch = combat_list; ch; ch = next_combat_list) {
     next_combat_list = ch->next_fighting;
@@ -1029,6 +1164,15 @@ void perform_violence(void)
       continue;
     }
 
+    if (IN_ROOM(ch) != room) {
+      room = IN_ROOM(ch);
+      combat_quiet = !combat_bench_loud && !room_has_listeners(room);
+      combat_counts.rooms++;
+      if (combat_quiet)
+        combat_counts.quiet_rooms++;
+    }
+    combat_counts.turns++;
+
     if (IS_NPC(ch)) {
       if (GET_MOB_WAIT(ch) > 0) {
 	GET_MOB_WAIT(ch) -= PULSE_VIOLENCE;
@@ -1052,4 +1196,139 @@ void perform_violence(void)
       (GET_MOB_SPEC(ch)) (ch, ch, 0, actbuf);
     }
   }
+  combat_quiet = FALSE;
+  rng_use(was);
+}
+
+
+/*
+ * show combat bench [<fights>] - time <fights> one on one fights between
+ * copies of a mob for a number of rounds: working the combat numbers out
+ * every hit, keeping them, and keeping them with the messages left out as
+ * they are when nobody is listening.  The combat stream is seeded the
+ * same for every pass, so each pass fights the same fights, and is put
+ * back afterwards.
+ */
+#define COMBAT_BENCH_PASSES	3
+#define COMBAT_BENCH_ROUNDS	20
+#define COMBAT_BENCH_SEED	1993
+
+static void combat_bench(struct char_data *ch, int fights)
+{
+  struct char_data **mobs, *saved_list = combat_list;
+  struct combat_counts saved_counts = combat_counts;
+  struct rng_state saved_rng;
+  struct timeval before, after, spent;
+  unsigned long usecs[COMBAT_BENCH_PASSES], dealt[COMBAT_BENCH_PASSES];
+  const char *pass_names[COMBAT_BENCH_PASSES] = { "Uncached", "Cached", "Cached+quiet" };
+  mob_rnum rnum;
+  room_rnum room;
+  int i, r, pass;
+
+  /* a plain mob, one without scripts or a special procedure */
+  for (rnum = 0; rnum <= top_of_mobt; rnum++)
+    if (!mob_proto[rnum].proto_script && !mob_index[rnum].func)
+      break;
+  /* and an empty room to fight in */
+  for (room = 0; room <= top_of_world; room++)
+    if (!world[room].people && !ROOM_FLAGGED(room, ROOM_PEACEFUL))
+      break;
+  if (rnum > top_of_mobt || room > top_of_world) {
+    send_to_char(ch, "There is no plain mob or empty room to fight with.\r\n");
+    return;
+  }
+
+  combat_list = NULL;
+  rng_save(RNG_COMBAT, &saved_rng);
+  CREATE(mobs, struct char_data *, fights * 2);
+  for (i = 0; i < fights * 2; i++) {
+    mobs[i] = read_mobile(rnum, REAL);
+    REMOVE_BIT(MOB_FLAGS(mobs[i]), MOB_SPEC | MOB_WIMPY | MOB_MEMORY);
+    AFF_FLAGS(mobs[i]) = 0;
+    GET_LEVEL(mobs[i]) = 10;
+    GET_MAX_HIT(mobs[i]) = 30000;
+    GET_EVASION(mobs[i]) = 0;
+    GET_DAMROLL(mobs[i]) = 0;
+    mobs[i]->mob_specials.attack_type = 0;
+    mobs[i]->mob_specials.damnodice = 1;
+    mobs[i]->mob_specials.damsizedice = 4;
+    char_to_room(mobs[i], room);
+  }
+
+  for (pass = 0; pass < COMBAT_BENCH_PASSES; pass++) {
+    combat_cache_on = (pass > 0);
+    combat_bench_loud = (pass < 2);
+    rng_seed(RNG_COMBAT, COMBAT_BENCH_SEED);
+
+    for (i = 0; i < fights * 2; i++) {
+      GET_HIT(mobs[i]) = GET_MAX_HIT(mobs[i]);
+      GET_AMMO(mobs[i]) = 30000;
+      GET_POS(mobs[i]) = POS_STANDING;
+      mobs[i]->combat.valid = FALSE;
+    }
+    for (i = 0; i < fights * 2; i++)
+      set_fighting(mobs[i], mobs[i ^ 1]);
+
+    gettimeofday(&before, (struct timezone *) 0);
+    for (r = 0; r < COMBAT_BENCH_ROUNDS; r++)
+      perform_violence();
+    gettimeofday(&after, (struct timezone *) 0);
+    timediff(&spent, &after, &before);
+    usecs[pass] = spent.tv_sec * 1000000 + spent.tv_usec;
+
+    for (dealt[pass] = 0, i = 0; i < fights * 2; i++) {
+      dealt[pass] += GET_MAX_HIT(mobs[i]) - GET_HIT(mobs[i]);
+      if (FIGHTING(mobs[i]))
+        stop_fighting(mobs[i]);
+    }
+  }
+
+  combat_cache_on = TRUE;
+  combat_bench_loud = FALSE;
+  combat_list = saved_list;
+  combat_counts = saved_counts;
+  rng_restore(RNG_COMBAT, &saved_rng);
+
+  for (i = 0; i < fights * 2; i++)
+    extract_char(mobs[i]);
+  free(mobs);
+
+  send_to_char(ch,
+	"%d fights between copies of mob #%d in room #%d, %d rounds:\r\n"
+	"                  usecs  usecs/round  rounds/sec  damage dealt\r\n",
+	fights, mob_index[rnum].vnum, world[room].number, COMBAT_BENCH_ROUNDS);
+  for (pass = 0; pass < COMBAT_BENCH_PASSES; pass++)
+    send_to_char(ch, "%-13s %9lu %12lu %11lu %13lu\r\n", pass_names[pass],
+	usecs[pass], usecs[pass] / COMBAT_BENCH_ROUNDS,
+	usecs[pass] ? COMBAT_BENCH_ROUNDS * 1000000UL / usecs[pass] : 0, dealt[pass]);
+}
+
+/* show combat [bench [<fights>]] */
+void combat_report(struct char_data *ch, char *value, char *arg)
+{
+  struct char_data *i;
+  int fighting = 0, types = 0, t;
+
+  skip_spaces(&arg);
+  if (*value && is_abbrev(value, "bench")) {
+    combat_bench(ch, *arg && is_number(arg) ? MIN(MAX(atoi(arg), 1), 10000) : 500);
+    return;
+  }
+
+  for (i = combat_list; i; i = i->next_fighting)
+    fighting++;
+  for (t = 0; t <= TYPE_SUFFERING; t++)
+    if (fight_msg_index[t])
+      types++;
+
+  send_to_char(ch,
+	"Fighting now: %d.  Attack types with messages: %d.\r\n"
+	"Rounds: %lu, turns taken: %lu, rooms fought in: %lu, nobody listening: %lu (%lu%%).\r\n"
+	"Combat numbers: %lu worked out, %lu reused (%lu%%).\r\n",
+	fighting, types,
+	combat_counts.rounds, combat_counts.turns, combat_counts.rooms, combat_counts.quiet_rooms,
+	combat_counts.rooms ? combat_counts.quiet_rooms * 100 / combat_counts.rooms : 0,
+	combat_counts.stats_built, combat_counts.stats_cached,
+	(combat_counts.stats_built + combat_counts.stats_cached) ?
+	  combat_counts.stats_cached * 100 / (combat_counts.stats_built + combat_counts.stats_cached) : 0);
 }
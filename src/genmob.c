@@ -19,10 +19,11 @@
 
 int add_mobile(struct char_data *mob, mob_vnum vnum)
 {
-  int rnum, i, found = FALSE, shop, cmd_no;
-  zone_rnum zone;
+  int rnum, found;
   struct char_data *live_mob;
 
+  name_index_stale(NAME_INDEX_MOB);
+
   if ((rnum = real_mobile(vnum)) != NOBODY) {
     /* Copy over the mobile and free() the old strings. */
     copy_mobile(&mob_proto[rnum], mob);
@@ -37,33 +38,23 @@ int add_mobile(struct char_data *mob, mob_vnum vnum)
     return rnum;
   }
 
+  /*
+   * New mobiles go on the end of the table and are found through the vnum
+   * index, so live mobiles, zone commands and shopkeepers keep their rnums.
+   */
   RECREATE(mob_proto, struct char_data, top_of_mobt + 2);
   RECREATE(mob_index, struct index_data, top_of_mobt + 2);
-  top_of_mobt++;
-
-  for (i = top_of_mobt; i > 0; i--) {
-    if (vnum > mob_index[i - 1].vnum) {
-      mob_proto[i] = *mob;
-      mob_proto[i].nr = i;
-      copy_mobile_strings(mob_proto + i, mob);
-      mob_index[i].vnum = vnum;
-      mob_index[i].number = 0;
-      mob_index[i].func = 0;
-      found = i;
-      break;
-    }
-    mob_index[i] = mob_index[i - 1];
-    mob_proto[i] = mob_proto[i - 1];
-    mob_proto[i].nr++;
-  }
-  if (!found) {
-    mob_proto[0] = *mob;
-    mob_proto[0].nr = 0;
-    copy_mobile_strings(&mob_proto[0], mob);
-    mob_index[0].vnum = vnum;
-    mob_index[0].number = 0;
-    mob_index[0].func = 0;
-  }
+  found = ++top_of_mobt;
+
+  mob_proto[found].hot = 0;	/* RECREATE()'d; it gets a hot slot of its own */
+  copy_char(mob_proto + found, mob);
+  mob_proto[found].nr = found;
+  copy_mobile_strings(mob_proto + found, mob);
+  mob_index[found].vnum = vnum;
+  mob_index[found].number = 0;
+  mob_index[found].func = 0;
+  mob_index[found].mobs = NULL;
+  vnum_reindex(DB_BOOT_MOB, found);
 
   log("GenOLC: add_mobile: Added mobile %d at index #%d.", vnum, found);
 
@@ -76,27 +67,6 @@ int add_mobile(struct char_data *mob, mob_vnum vnum)
   }
 #endif
 
-  /*
-   * Update live mobile rnums.
-   */
-  for (live_mob = character_list; live_mob; live_mob = live_mob->next)
-    GET_MOB_RNUM(live_mob) += (GET_MOB_RNUM(live_mob) >= found);
-
-  /*
-   * Update zone table.
-   */
-  for (zone = 0; zone <= top_of_zone_table; zone++)
-    for (cmd_no = 0; ZCMD(zone, cmd_no).command != 'S'; cmd_no++)
-      if (ZCMD(zone, cmd_no).command == 'M')
-	ZCMD(zone, cmd_no).arg1 += (ZCMD(zone, cmd_no).arg1 >= found);
-
-  /*
-   * Update shop keepers.
-   */
-  if (shop_index)
-    for (shop = 0; shop <= top_shop - top_shop_offset; shop++)
-      SHOP_KEEPER(shop) += (SHOP_KEEPER(shop) >= found);
-
   add_to_save_list(zone_table[real_zone_by_thing(vnum)].number, SL_MOB);
   return found;
 }
@@ -104,7 +74,7 @@ int add_mobile(struct char_data *mob, mob_vnum vnum)
 int copy_mobile(struct char_data *to, struct char_data *from)
 {
   free_mobile_strings(to);
-  *to = *from;
+  copy_char(to, from);
   check_mobile_strings(from);
   copy_mobile_strings(to, from);
   return TRUE;
@@ -139,6 +109,7 @@ int delete_mobile(mob_rnum refpt)
 
   vnum = mob_index[refpt].vnum;
   extract_mobile_all(vnum);
+  char_hot_free(mob_proto + refpt);
 
   for (counter = refpt; counter < top_of_mobt; counter++) {
     mob_index[counter] = mob_index[counter + 1];
@@ -149,6 +120,9 @@ int delete_mobile(mob_rnum refpt)
   top_of_mobt--;
   RECREATE(mob_index, struct index_data, top_of_mobt + 1);
   RECREATE(mob_proto, struct char_data, top_of_mobt + 1);
+  vnum_unindex(DB_BOOT_MOB, vnum);
+  name_index_stale(NAME_INDEX_MOB);
+  vnum_reindex(DB_BOOT_MOB, refpt);
 
   /*
    * Update live mobile rnums.
@@ -161,8 +135,12 @@ int delete_mobile(mob_rnum refpt)
    */
   for (zone = 0; zone <= top_of_zone_table; zone++)
     for (cmd_no = 0; ZCMD(zone, cmd_no).command != 'S'; cmd_no++)
-      if (ZCMD(zone, cmd_no).command == 'M' && ZCMD(zone, cmd_no).arg1 == refpt)
-        delete_command(&zone_table[zone], cmd_no);
+      if (ZCMD(zone, cmd_no).command != 'M')
+        continue;
+      else if (ZCMD(zone, cmd_no).arg1 == refpt)
+        delete_command(&zone_table[zone], cmd_no--);
+      else if (ZCMD(zone, cmd_no).arg1 > refpt)
+        ZCMD(zone, cmd_no).arg1--;
 
   /*
    * Update shop keepers.
@@ -171,7 +149,7 @@ int delete_mobile(mob_rnum refpt)
     for (counter = 0; counter <= top_shop - top_shop_offset; counter++)
       SHOP_KEEPER(counter) -= (SHOP_KEEPER(counter) >= refpt);
 
-  save_mobiles(real_zone_by_thing(vnum)); 
+  queue_olc_save(real_zone_by_thing(vnum), SL_MOB);
   
   return refpt;
 }
@@ -261,6 +239,7 @@ int free_mobile(struct char_data *mob)
   if (SCRIPT(mob))
     extract_script(mob, MOB_TRIGGER);
 
+  char_hot_free(mob);
   free(mob);
   return TRUE;
 }
@@ -25,6 +25,8 @@ obj_rnum add_object(struct obj_data *newobj, obj_vnum ovnum)
   int found = NOTHING;
   zone_rnum rznum = real_zone_by_thing(ovnum);
 
+  name_index_stale(NAME_INDEX_OBJ);
+
   /*
    * Write object to internal tables.
    */
@@ -36,7 +38,6 @@ obj_rnum add_object(struct obj_data *newobj, obj_vnum ovnum)
   }
 
   found = insert_object(newobj, ovnum);
-  adjust_objects(found);
   add_to_save_list(zone_table[rznum].number, SL_OBJ);
   return found;
 }
@@ -55,10 +56,7 @@ int update_objects(struct obj_data *refobj)
   struct obj_data *obj, swap;
   int count = 0;
 
-  for (obj = object_list; obj; obj = obj->next) {
-    if (obj->item_number != refobj->item_number)
-      continue;
-
+  for (obj = obj_index[refobj->item_number].objs; obj; obj = obj->next_instance) {
     count++;
 
     /* Update the existing object but save a copy for private information. */
@@ -66,7 +64,7 @@ int update_objects(struct obj_data *refobj)
     *obj = *refobj;
 
     /* Copy game-time dependent variables over. */
-    IN_ROOM(obj) = swap.in_room;
+    OBJ_IN_ROOM(obj) = swap.in_room;
     obj->carried_by = swap.carried_by;
     obj->worn_by = swap.worn_by;
     obj->worn_on = swap.worn_on;
@@ -74,6 +72,12 @@ int update_objects(struct obj_data *refobj)
     obj->contains = swap.contains;
     obj->next_content = swap.next_content;
     obj->next = swap.next;
+    obj->next_instance = swap.next_instance;
+    obj->prev_instance = swap.prev_instance;
+    obj->timer_due = swap.timer_due;
+    obj->timer_next = swap.timer_next;
+    obj->timer_pprev = swap.timer_pprev;
+    set_obj_timer(obj, refobj->obj_flags.timer);
   }
 
   return count;
@@ -145,35 +149,20 @@ obj_rnum adjust_objects(obj_rnum refpt)
 /* ------------------------------------------------------------------------------------------------------------------------------ */
 
 /*
- * Function handle the insertion of an object within the prototype framework.  Note that this does not adjust internal values
- * of other objects, use add_object() for that.
+ * Function handle the insertion of an object within the prototype framework.  New prototypes go on the end of the tables
+ * and are found through the vnum index, so no other object, zone command, board or shop needs renumbering.
  */
 obj_rnum insert_object(struct obj_data *obj, obj_vnum ovnum)
 {
-  obj_rnum i;
+  obj_rnum ornum;
 
   top_of_objt++;
   RECREATE(obj_index, struct index_data, top_of_objt + 1);
   RECREATE(obj_proto, struct obj_data, top_of_objt + 1);
 
-  /*
-   * Start counting through both tables.
-   */
-  for (i = top_of_objt; i > 0; i--) {
-    /*
-     * Check if current virtual is bigger than our virtual number.
-     */
-    if (ovnum > obj_index[i - 1].vnum)
-      return index_object(obj, ovnum, i);
-
-    /* Copy over the object that should be here. */
-    obj_index[i] = obj_index[i - 1];
-    obj_proto[i] = obj_proto[i - 1];
-    obj_proto[i].item_number = i;
-  }
-
-  /* Not found, place at 0. */
-  return index_object(obj, ovnum, 0);
+  if ((ornum = index_object(obj, ovnum, top_of_objt)) != NOTHING)
+    vnum_reindex(DB_BOOT_OBJ, ornum);
+  return ornum;
 }
 
 /* ------------------------------------------------------------------------------------------------------------------------------ */
@@ -191,6 +180,7 @@ obj_rnum index_object(struct obj_data *obj, obj_vnum ovnum, obj_rnum ornum)
   obj_index[ornum].vnum = ovnum;
   obj_index[ornum].number = 0;
   obj_index[ornum].func = NULL;
+  obj_index[ornum].objs = NULL;
 
   copy_object_preserve(&obj_proto[ornum], obj);
   obj_proto[ornum].in_room = NOWHERE;
@@ -399,12 +389,14 @@ int delete_object(obj_rnum rnum)
 { 
   obj_rnum i; 
   struct obj_data *obj, *tmp; 
+  obj_vnum ovnum;
   int shop, j; 
 
   if (rnum == NOWHERE || rnum > top_of_objt) 
     return FALSE; 
 
   obj = &obj_proto[rnum]; 
+  ovnum = GET_OBJ_VNUM(obj);
 
   zone_rnum zrnum = real_zone_by_thing(GET_OBJ_VNUM(obj));
 
@@ -420,10 +412,10 @@ int delete_object(obj_rnum rnum)
       struct obj_data *this_content, *next_content;
       for (this_content = tmp->contains; this_content; this_content = next_content) {
         next_content = this_content->next_content;
-        if (IN_ROOM(tmp)) {
+        if (OBJ_IN_ROOM(tmp)) {
           // transfer stuff from object to room
           obj_from_obj(this_content);
-          obj_to_room(this_content, IN_ROOM(tmp));
+          obj_to_room(this_content, OBJ_IN_ROOM(tmp));
         } else if (tmp->worn_by || tmp->carried_by) {
           // transfer stuff from object to person inventory
           obj_from_char(this_content);
@@ -456,6 +448,9 @@ int delete_object(obj_rnum rnum)
   top_of_objt--;
   RECREATE(obj_index, struct index_data, top_of_objt + 1);
   RECREATE(obj_proto, struct obj_data, top_of_objt + 1);
+  vnum_unindex(DB_BOOT_OBJ, ovnum);
+  name_index_stale(NAME_INDEX_OBJ);
+  vnum_reindex(DB_BOOT_OBJ, rnum);
 
   /* 
    * Renumber notice boards. 
@@ -501,7 +496,7 @@ int delete_object(obj_rnum rnum)
     } 
   } 
 
-  save_objects(zrnum);  
+  queue_olc_save(zrnum, SL_OBJ);
 
   return TRUE; 
 }
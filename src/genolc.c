@@ -66,11 +66,166 @@ char *str_udup(const char *txt)
   return strdup((txt && *txt) ? txt : "undefined");
 }
 
+/*
+ * OLC saves are written in the background.  Asking for a file to be saved
+ * just queues it, once however often it is asked for before it goes out;
+ * each pulse, unless the last lot is still being written, everything queued
+ * is handed to a child process that writes the files from its own copy of
+ * the world, taken at that moment, while the game carries on.  Where there
+ * is no fork() the files are written on the spot as they always were.
+ */
+#define OLC_SAVES_KEPT	10	/* finished saves 'olc' remembers */
+
+struct olc_save {
+  zone_vnum zone;
+  int type;
+  int requests;		/* times it was asked for while queued */
+  time_t queued, finished;
+  int ok;
+  struct olc_save *next;
+};
+
+static struct olc_save *saves_queued = NULL;	/* waiting for the writer */
+static struct olc_save *saves_writing = NULL;	/* with the writer now */
+static struct olc_save saves_done[OLC_SAVES_KEPT];
+static int saves_done_count = 0;
+static time_t writing_since;
+static unsigned long saves_asked = 0, saves_written = 0;
+
+static void queue_save(zone_vnum zone, int type)
+{
+  struct olc_save *item, **tail;
+
+  saves_asked++;
+  for (tail = &saves_queued; *tail; tail = &(*tail)->next)
+    if ((*tail)->zone == zone && (*tail)->type == type) {
+      (*tail)->requests++;
+      return;
+    }
+
+  CREATE(item, struct olc_save, 1);
+  item->zone = zone;
+  item->type = type;
+  item->requests = 1;
+  item->queued = time(0);
+  *tail = item;
+}
+
+void queue_olc_save(zone_rnum rznum, int type)
+{
+#if CIRCLE_UNSIGNED_INDEX
+  if (rznum == NOWHERE || rznum > top_of_zone_table) {
+#else
+  if (rznum < 0 || rznum > top_of_zone_table) {
+#endif
+    log("SYSERR: GenOLC: queue_olc_save: Invalid zone number %d passed! (0-%d)", rznum, top_of_zone_table);
+    return;
+  }
+  queue_save(zone_table[rznum].number, type);
+}
+
+/* what saveall does: queue everything that needs saving */
+void queue_save_all(void)
+{
+  struct save_list_data *item;
+
+  for (item = save_list; item; item = item->next)
+    if (item->type == SL_ACTION)
+      log("Actions not saved - can not autosave. Use 'aedit save'.");
+    else if (item->type >= 0 && item->type <= SL_MAX && save_types[item->type].func)
+      queue_save(item->zone, item->type);
+}
+
+/* the writer's job, in the child process or here */
+static int write_olc_saves(void)
+{
+  struct olc_save *item;
+  int ok = TRUE;
+
+  for (item = saves_writing; item; item = item->next)
+    if ((*save_types[item->type].func)(real_zone(item->zone)) <= 0)
+      ok = FALSE;
+
+  return (ok);
+}
+
+static void olc_saves_written(int ok)
+{
+  struct olc_save *item;
+
+  if (!ok)
+    mudlog(BRF, LVL_BUILDER, TRUE, "SYSERR: OLC: Writing world files failed; they still need saving.");
+
+  while ((item = saves_writing) != NULL) {
+    saves_writing = item->next;
+    item->finished = time(0);
+    item->ok = ok;
+    item->next = NULL;
+    if (!ok)
+      add_to_save_list(item->zone, item->type);
+    else
+      saves_written++;
+    memmove(saves_done + 1, saves_done, sizeof(struct olc_save) * (OLC_SAVES_KEPT - 1));
+    saves_done[0] = *item;
+    saves_done_count = MIN(saves_done_count + 1, OLC_SAVES_KEPT);
+    free(item);
+  }
+}
+
+static void start_olc_saves(void)
+{
+  struct olc_save *item;
+
+  saves_writing = saves_queued;
+  saves_queued = NULL;
+  writing_since = time(0);
+
+  if (!start_background_job(write_olc_saves)) {
+    olc_saves_written(write_olc_saves());
+    return;
+  }
+
+  /* the writer takes them off its copy of the list; take them off ours */
+  for (item = saves_writing; item; item = item->next)
+    if (in_save_list(item->zone, item->type))
+      remove_from_save_list(item->zone, item->type);
+}
+
+void olc_save_pulse(void)
+{
+  int done;
+
+  if (saves_writing) {
+    if ((done = background_job_done(FALSE)) == BG_RUNNING)
+      return;
+    olc_saves_written(done);
+  }
+
+  if (saves_queued)
+    start_olc_saves();
+}
+
+/* wait for the writer and write what is still queued, here and now */
+void flush_olc_saves(void)
+{
+  if (saves_writing)
+    olc_saves_written(background_job_done(TRUE));
+
+  if (saves_queued) {
+    saves_writing = saves_queued;
+    saves_queued = NULL;
+    writing_since = time(0);
+    olc_saves_written(write_olc_saves());
+  }
+}
+
 /*
  * Original use: to be called at shutdown time.
  */
 int save_all(void)
 {
+  flush_olc_saves();
+
   while (save_list) {
     if (save_list->type < 0 || save_list->type > SL_MAX) {
       if (save_list->type == SL_ACTION) {
@@ -209,6 +364,41 @@ int in_save_list(zone_vnum zone, int type)
 /*
  * Used from do_show(), ideally.
  */
+static void show_olc_save(struct char_data *ch, struct olc_save *item, time_t since, int done)
+{
+  if (item->type == SL_CFG)
+    send_to_char(ch, " - Game configuration data");
+  else
+    send_to_char(ch, " - %s data for zone %d", save_types[item->type].message, item->zone);
+  if (item->requests > 1)
+    send_to_char(ch, ", asked for %d times", item->requests);
+  send_to_char(ch, ", %lds ago%s.\r\n", (long) (time(0) - since),
+	done && !item->ok ? ", FAILED" : "");
+}
+
+static void show_olc_saves(struct char_data *ch)
+{
+  struct olc_save *item;
+  int i;
+
+  if (saves_writing) {
+    send_to_char(ch, "Being written, since %lds ago:\r\n", (long) (time(0) - writing_since));
+    for (item = saves_writing; item; item = item->next)
+      show_olc_save(ch, item, item->queued, FALSE);
+  }
+  if (saves_queued) {
+    send_to_char(ch, "Waiting to be written:\r\n");
+    for (item = saves_queued; item; item = item->next)
+      show_olc_save(ch, item, item->queued, FALSE);
+  }
+  if (saves_done_count) {
+    send_to_char(ch, "Written lately:\r\n");
+    for (i = 0; i < saves_done_count; i++)
+      show_olc_save(ch, saves_done + i, saves_done[i].finished, TRUE);
+  }
+  send_to_char(ch, "%lu saves asked for, %lu files written.\r\n", saves_asked, saves_written);
+}
+
 void do_show_save_list(struct char_data *ch)
 {
   if (save_list == NULL)
@@ -224,6 +414,7 @@ void do_show_save_list(struct char_data *ch)
         send_to_char(ch, " - Game configuration data.\r\n");
     }
   }
+  show_olc_saves(ch);
 }
 
 room_vnum genolc_zonep_bottom(struct zone_data *zone)
@@ -27,6 +27,9 @@ int in_save_list(zone_vnum, int type);
 void strip_cr(char *);
 void do_show_save_list(struct char_data *);
 int save_all(void);
+void queue_olc_save(zone_rnum rznum, int type);
+void queue_save_all(void);
+void flush_olc_saves(void);
 char *str_udup(const char *);
 void copy_ex_descriptions(struct extra_descr_data **to, struct extra_descr_data *from);
 void free_ex_descriptions(struct extra_descr_data *head);
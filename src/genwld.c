@@ -23,6 +23,8 @@ extern room_rnum r_mortal_start_room;
 extern room_rnum r_immort_start_room;
 extern room_rnum r_frozen_start_room;
 
+void timediff(struct timeval *diff, struct timeval *a, struct timeval *b);
+
 /*
  * This function will copy the strings so be sure you free your own
  * copies of the description, title, and such.
@@ -31,99 +33,61 @@ room_rnum add_room(struct room_data *room)
 {
   struct char_data *tch;
   struct obj_data *tobj;
-  int j, found = FALSE;
-  room_rnum i;
+  struct speech_index *tspeech;
+  struct room_census tcensus;
+  struct room_data *old_world;
+  room_rnum i, found;
   
   if (room == NULL)
     return NOWHERE;
 
+  name_index_stale(NAME_INDEX_ROOM);
+
   if ((i = real_room(room->number)) != NOWHERE) {
     if (SCRIPT(&world[i]))
       extract_script(&world[i], WLD_TRIGGER);
     tch = world[i].people; 
     tobj = world[i].contents;
+    tspeech = world[i].speech;
+    tcensus = world[i].census;
     copy_room(&world[i], room);
     world[i].people = tch;
     world[i].contents = tobj;
+    world[i].speech = tspeech;
+    world[i].census = tcensus;
+    speech_index_dirty(i);
+    CMD_FILTER_DIRTY(world[i].cmd_filter);
+    path_exits_changed();
     add_to_save_list(zone_table[room->zone].number, SL_WLD);
     log("GenOLC: add_room: Updated existing room #%d.", room->number);
     return i;
   }
 
+  /*
+   * New rooms go on the end of the world, whatever their vnum; real_room()
+   * finds them through the vnum index, and no existing room, exit, zone
+   * command or start room has to be renumbered.  If the array moved, the
+   * wait events of room triggers still point into the old one.
+   */
+  old_world = world;
   RECREATE(world, struct room_data, top_of_world + 2);
   top_of_world++;
+  found = top_of_world;
 
-  for (i = top_of_world; i > 0; i--) {
-    if (room->number > world[i - 1].number) {
-      world[i] = *room;
-      copy_room_strings(&world[i], room);
-      found = i;
-      break;
-    } else {
-      /* Copy the room over now. */
-      world[i] = world[i - 1];
-      update_wait_events(&world[i], &world[i-1]);
-
-      /* People in this room must have their in_rooms moved up one. */
-      for (tch = world[i].people; tch; tch = tch->next_in_room)
-	IN_ROOM(tch) += (IN_ROOM(tch) != NOWHERE);
-
-      /* Move objects too. */
-      for (tobj = world[i].contents; tobj; tobj = tobj->next_content)
-	IN_ROOM(tobj) += (IN_ROOM(tobj) != NOWHERE);
-    }
-  }
-  if (!found) {
-    world[0] = *room;	/* Last place, in front. */
-    copy_room_strings(&world[0], room);
-  }
-
-  log("GenOLC: add_room: Added room %d at index #%d.", room->number, found);
+  if (world != old_world)
+    for (i = 0; i < found; i++)
+      if (SCRIPT(&world[i]))
+        update_wait_events(&world[i], &world[i]);
 
-  /* found is equal to the array index where we added the room. */
+  world[found] = *room;
+  copy_room_strings(&world[found], room);
+  world[found].speech = NULL;
+  memset(&world[found].census, 0, sizeof(struct room_census));
+  CMD_FILTER_DIRTY(world[found].cmd_filter);
+  vnum_reindex(DB_BOOT_WLD, found);
+  path_exits_changed();
 
-  /*
-   * Find what zone that room was in so we can update the loading table.
-   */
-  for (i = room->zone; i <= top_of_zone_table; i++)
-    for (j = 0; ZCMD(i, j).command != 'S'; j++)
-      switch (ZCMD(i, j).command) {
-      case 'M':
-      case 'O':
-      case 'T':
-      case 'V':
-	ZCMD(i, j).arg3 += (ZCMD(i, j).arg3 != NOWHERE && ZCMD(i, j).arg3 >= found);
-	break;
-      case 'D':
-      case 'R':
-	ZCMD(i, j).arg1 += (ZCMD(i, j).arg1 != NOWHERE && ZCMD(i, j).arg1 >= found);
-      case 'G':
-      case 'P':
-      case 'E':
-      case '*':
-	/* Known zone entries we don't care about. */
-        break;
-      default:
-        mudlog(BRF, LVL_GOD, TRUE, "SYSERR: GenOLC: add_room: Unknown zone entry found!");
-      }
-      
-  /*
-   * Update the loadroom table. Adds 1 or 0.
-   */
-  r_mortal_start_room += (r_mortal_start_room >= found);
-  r_immort_start_room += (r_immort_start_room >= found);
-  r_frozen_start_room += (r_frozen_start_room >= found);
-
-  /*
-   * Update world exits.
-   */
-  i = top_of_world + 1;
-  do {
-    i--;
-    for (j = 0; j < NUM_OF_DIRS; j++)
-      if (W_EXIT(i, j) && W_EXIT(i, j)->to_room != NOWHERE)
-	W_EXIT(i, j)->to_room += (W_EXIT(i, j)->to_room >= found);
-  } while (i > 0);
+  log("GenOLC: add_room: Added room %d at index #%d.", room->number, found);
 
   add_to_save_list(zone_table[room->zone].number, SL_WLD);
 
@@ -142,11 +106,13 @@ int delete_room(room_rnum rnum)
   struct char_data *ppl, *next_ppl;
   struct obj_data *obj, *next_obj;
   struct room_data *room;
+  room_vnum vnum;
 
   if (rnum <= 0 || rnum > top_of_world)	/* Can't delete void yet. */
     return FALSE;
 
   room = &world[rnum];
+  vnum = room->number;
 
   add_to_save_list(zone_table[room->zone].number, SL_WLD);
 
@@ -185,6 +151,8 @@ int delete_room(room_rnum rnum)
   if (SCRIPT(room))
     extract_script(room, WLD_TRIGGER);
   free_proto_script(room, WLD_TRIGGER);
+  free_speech_index(room->speech);
+  room->speech = NULL;
 
   /*
    * Change any exit going to this room to go the void.
@@ -267,16 +235,104 @@ int delete_room(room_rnum rnum)
       IN_ROOM(ppl) -= (IN_ROOM(ppl) != NOWHERE);	/* Redundant check? */
 
     for (obj = world[i].contents; obj; obj = obj->next_content)
-      IN_ROOM(obj) -= (IN_ROOM(obj) != NOWHERE);	/* Redundant check? */
+      OBJ_IN_ROOM(obj) -= (OBJ_IN_ROOM(obj) != NOWHERE);	/* Redundant check? */
   }
 
   top_of_world--;
   RECREATE(world, struct room_data, top_of_world + 1);
+  vnum_unindex(DB_BOOT_WLD, vnum);
+  name_index_stale(NAME_INDEX_ROOM);
+  vnum_reindex(DB_BOOT_WLD, rnum);
+  path_exits_changed();
 
   return TRUE;
 }
 
 
+/*
+ * show vnums bench: adds 'count' rooms above the highest vnum in use,
+ * the way redit does, then deletes them again.  For comparison it times
+ * the walk over every exit and zone command that add_room() used to make
+ * for each new room just to renumber them; the shifting it did on top of
+ * that is not counted.
+ */
+void add_room_bench(struct char_data *ch, int count)
+{
+  struct room_data room;
+  struct timeval before, after, spent;
+  unsigned long add_usecs, walk_usecs, del_usecs, touched = 0;
+  room_vnum first = 0;
+  room_rnum r, first_rnum;
+  zone_rnum z;
+  int i, d, c, stable = 0, was_saved;
+
+  for (r = 0; r <= top_of_world; r++)
+    first = MAX(first, world[r].number);
+  first++;
+#if CIRCLE_UNSIGNED_INDEX
+  count = MIN(count, (int) NOWHERE - first);
+#else
+  count = MIN(count, 32767 - first + 1);
+#endif
+  if (count <= 0) {
+    send_to_char(ch, "There are no free room vnums above #%d.\r\n", first - 1);
+    return;
+  }
+
+  memset(&room, 0, sizeof(room));
+  room.name = "A bench room";
+  room.description = "Nothing to see here.\r\n";
+  room.zone = world[IN_ROOM(ch)].zone;
+  was_saved = in_save_list(zone_table[room.zone].number, SL_WLD);
+
+  first_rnum = top_of_world + 1;
+  gettimeofday(&before, (struct timezone *) 0);
+  for (i = 0; i < count; i++) {
+    room.number = first + i;
+    add_room(&room);
+  }
+  gettimeofday(&after, (struct timezone *) 0);
+  timediff(&spent, &after, &before);
+  add_usecs = spent.tv_sec * 1000000 + spent.tv_usec;
+
+  for (i = 0; i < count; i++)
+    stable += (real_room(first + i) == first_rnum + i);
+
+  gettimeofday(&before, (struct timezone *) 0);
+  for (i = 0; i < count; i++) {
+    for (r = 0; r <= top_of_world; r++)
+      for (d = 0; d < NUM_OF_DIRS; d++)
+        if (W_EXIT(r, d) && W_EXIT(r, d)->to_room != NOWHERE)
+          touched += (W_EXIT(r, d)->to_room >= first_rnum + i);
+    for (z = 0; z <= top_of_zone_table; z++)
+      for (c = 0; ZCMD(z, c).command != 'S'; c++)
+        touched += (ZCMD(z, c).arg1 >= first_rnum + i);
+  }
+  gettimeofday(&after, (struct timezone *) 0);
+  timediff(&spent, &after, &before);
+  walk_usecs = spent.tv_sec * 1000000 + spent.tv_usec;
+
+  gettimeofday(&before, (struct timezone *) 0);
+  for (i = count - 1; i >= 0; i--)
+    delete_room(real_room(first + i));
+  gettimeofday(&after, (struct timezone *) 0);
+  timediff(&spent, &after, &before);
+  del_usecs = spent.tv_sec * 1000000 + spent.tv_usec;
+
+  if (!was_saved)
+    remove_from_save_list(zone_table[room.zone].number, SL_WLD);
+
+  send_to_char(ch, "%d rooms, #%d to #%d, on a world of %d:\r\n"
+	"Added            %8lu usecs, %6lu usecs/room, %d/%d at the expected rnum\r\n"
+	"Renumber walk    %8lu usecs, %6lu usecs/room (%lu references seen)\r\n"
+	"Deleted          %8lu usecs, %6lu usecs/room\r\n",
+	count, first, first + count - 1, top_of_world + 1,
+	add_usecs, add_usecs / count, stable, count,
+	walk_usecs, walk_usecs / count, touched,
+	del_usecs, del_usecs / count);
+}
+
+
 int save_rooms(zone_rnum rzone)
 {
   int i;
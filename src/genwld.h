@@ -12,3 +12,4 @@ int copy_room(struct room_data *to, struct room_data *from);
 room_rnum duplicate_room(room_vnum to, room_rnum from);
 int copy_room_strings(struct room_data *dest, struct room_data *source);
 int free_room_strings(struct room_data *);
+void add_room_bench(struct char_data *ch, int count);
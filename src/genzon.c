@@ -187,6 +187,17 @@ rznum = i;
   zone->lifespan = 30;
   zone->age = 0;
   zone->reset_mode = 2;
+  zone->resets = zone->reset_usec = zone->reset_max_usec = 0;
+  zone->auto_resets = zone->reset_lag = zone->reset_max_lag = 0;
+  zone->players = 0;
+  zone->zone_flags = 0;
+  zone->mobs = NULL;
+  zone->hibernating = zone->wake_queued = FALSE;
+  zone->emptied_at = time(0);
+  zone->wakes = 0;
+  zone->reset_waiting = FALSE;
+  zone->reset_heap_pos = -1;
+  zone->last_reset = time(0);
   /*
    * No zone commands, just terminate it with an 'S'
    */
@@ -194,6 +205,10 @@ rznum = i;
   zone->cmd[0].command = 'S';
 
   top_of_zone_table++;
+  vnum_reindex(DB_BOOT_ZON, rznum);
+  path_exits_changed();
+  rebuild_reset_heap();
+  schedule_zone_reset(rznum);
 
   add_to_save_list(zone->number, SL_ZON);
   return rznum;
@@ -345,7 +360,7 @@ int save_zone(zone_rnum zone_num)
   fprintf(zfile, "#%d\n"
                  "%s~\n"
                  "%s~\n"
-                 "%d %d %d %d\n",
+                 "%d %d %d %d %d\n",
 	  zone_table[zone_num].number,
 	  (zone_table[zone_num].builders && *zone_table[zone_num].builders)
 		? zone_table[zone_num].builders : "None.",
@@ -354,7 +369,8 @@ int save_zone(zone_rnum zone_num)
           genolc_zone_bottom(zone_num),
 	  zone_table[zone_num].top,
 	  zone_table[zone_num].lifespan,
-	  zone_table[zone_num].reset_mode
+	  zone_table[zone_num].reset_mode,
+	  zone_table[zone_num].zone_flags
 	  );
 
 	/*
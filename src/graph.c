@@ -21,81 +21,483 @@
 #include "spells.h"
 
 
+/*
+ * Searches run over a compact copy of the exits: every usable exit of
+ * every room, packed into one array in room order, so a search walks a
+ * few contiguous edges per room instead of six exit pointers.  Rooms are
+ * "visited" by stamping them with the number of the current search, so
+ * nothing has to be cleared before a search, and the queue is a ring of
+ * room numbers reused from one search to the next.
+ *
+ * Long searches are routed in two levels.  The exits that cross from one
+ * zone to another are collected into a zone graph; a search for a room in
+ * another zone first finds the next zone on the way there, then searches
+ * only the current zone for the nearest way into it.  If that fails (a
+ * zone in pieces, a closed door) it falls back to searching everything.
+ *
+ * The answers are kept in a small LRU cache keyed by (room, target).  A
+ * search that finds its target also stores the next hop of every room on
+ * the path, so a mob hunting along it finds its next step in the cache.
+ * A search routed by zone only finds the way into the next zone, which
+ * needn't lie on the shortest path to the target; its hops are kept apart,
+ * keyed by (room, zone), so the two kinds never point at each other.
+ * Anything that changes an exit or opens or closes a door must call
+ * path_exits_changed() or path_doors_changed(); both bump the generation
+ * the cached answers are checked against.
+ */
+
 /* external functions */
 ACMD(do_say);
+void timediff(struct timeval *diff, struct timeval *a, struct timeval *b);
 
 /* external variables */
 extern const char *dirs[];
 
 /* local functions */
-int VALID_EDGE(room_rnum x, int y);
-void bfs_enqueue(room_rnum room, int dir);
-void bfs_dequeue(void);
-void bfs_clear_queue(void);
 int find_first_step(room_rnum src, room_rnum target);
+int path_route(room_rnum src, room_rnum target, int *route, int max);
 ACMD(do_track);
+ACMD(do_path);
 void hunt_victim(struct char_data *ch);
 
-struct bfs_queue_struct {
-  room_rnum room;
-  char dir;
-  struct bfs_queue_struct *next;
+/* one usable exit in the adjacency array */
+struct path_edge {
+  room_rnum to;
+  zone_rnum zone;	/* the zone it leads into */
+  sbyte dir;
+  sbyte door;		/* the exit is a door; check whether it is closed */
 };
 
-static struct bfs_queue_struct *queue_head = 0, *queue_tail = 0;
+/* a queue of rooms or zones in a fixed ring, sized for each to fit once */
+struct path_queue {
+  IDXTYPE *items;
+  int size, head, count;
+};
+
+/* a border crossing, from one zone into another */
+struct path_link {
+  zone_rnum from, to;
+};
+
+/* a cached answer to find_first_step(src, target) */
+struct path_hop {
+  room_rnum src, target;	/* target is a zone if zone is set	*/
+  bool zone;			/* the way into zone target		*/
+  int dir;			/* direction, or BFS_NO_PATH		*/
+  unsigned long generation;	/* path_generation when it was found	*/
+  struct path_hop *next_hash;
+  struct path_hop *prev, *next;	/* LRU list, most recent first		*/
+};
 
-/* Utility macros */
-#define MARK(room)	(SET_BIT(ROOM_FLAGS(room), ROOM_BFS_MARK))
-#define UNMARK(room)	(REMOVE_BIT(ROOM_FLAGS(room), ROOM_BFS_MARK))
-#define IS_MARKED(room)	(ROOM_FLAGGED(room, ROOM_BFS_MARK))
-#define TOROOM(x, y)	(world[(x)].dir_option[(y)]->to_room)
+#define PATH_CACHE_SIZE		4096
+#define PATH_HASH_SIZE		1021
+#define PATH_HASH(s, t)		((((unsigned long) (s) * 31) + (t)) % PATH_HASH_SIZE)
+
+/* the adjacency array: room r's edges are path_edges[path_first[r]..path_first[r+1]-1] */
+static struct path_edge *path_edges = NULL;
+static int *path_first = NULL;
+static int path_num_edges = 0;
+static room_rnum path_rooms = 0;	/* rooms the arrays were built for	*/
+static int path_graph_dirty = TRUE;
+
+/* per-room search state; only meaningful where path_seen[r] == path_stamp */
+static unsigned long *path_seen = NULL;
+static unsigned long path_stamp = 0;
+static room_rnum *path_from = NULL;	/* room the search came from	*/
+static sbyte *path_dir = NULL;		/* direction it came in by	*/
+static struct path_queue path_q;
+
+/* the zone graph: zone z borders path_links[path_link_first[z]..path_link_first[z+1]-1] */
+static struct path_link *path_links = NULL;
+static int *path_link_first = NULL;
+static int path_num_links = 0;
+static zone_rnum path_zones = 0;
+static unsigned long *path_zone_seen = NULL;
+static unsigned long path_zone_stamp = 0;
+static zone_rnum *path_zone_from = NULL;
+static struct path_queue path_zq;
+static int path_zones_on = TRUE;
+
+static struct path_hop path_cache[PATH_CACHE_SIZE];
+static struct path_hop *path_hash[PATH_HASH_SIZE];
+static struct path_hop *path_lru_head = NULL, *path_lru_tail = NULL;
+static unsigned long path_generation = 1;
+static int path_cache_on = TRUE;
+
+static struct {
+  unsigned long lookups, hits, searches, expanded, rebuilds, invalidations;
+  unsigned long zone_routes, fallbacks;
+} path_stats;
+
+#define PATH_GRAPH_STALE() (path_graph_dirty || path_rooms != top_of_world + 1 || \
+			    path_zones != top_of_zone_table + 1)
 #define IS_CLOSED(x, y)	(EXIT_FLAGGED(world[(x)].dir_option[(y)], EX_CLOSED))
 
-int VALID_EDGE(room_rnum x, int y)
+static void path_queue_init(struct path_queue *q, int size)
 {
-  if (world[x].dir_option[y] == NULL || TOROOM(x, y) == NOWHERE)
-    return 0;
-  if (CONFIG_TRACK_T_DOORS == FALSE && IS_CLOSED(x, y))
-    return 0;
-  if (ROOM_FLAGGED(TOROOM(x, y), ROOM_NOTRACK) || IS_MARKED(TOROOM(x, y)))
-    return 0;
+  if (q->items)
+    free(q->items);
+  CREATE(q->items, IDXTYPE, MAX(size, 1));
+  q->size = MAX(size, 1);
+  q->head = q->count = 0;
+}
 
-  return 1;
+static void path_enqueue(struct path_queue *q, IDXTYPE item)
+{
+  if (q->count == q->size) {
+    log("SYSERR: path_enqueue: queue full (%d entries).", q->size);
+    return;
+  }
+  q->items[(q->head + q->count++) % q->size] = item;
 }
 
-void bfs_enqueue(room_rnum room, int dir)
+static IDXTYPE path_dequeue(struct path_queue *q)
 {
-  struct bfs_queue_struct *curr;
+  IDXTYPE item = q->items[q->head];
 
-  CREATE(curr, struct bfs_queue_struct, 1);
-  curr->room = room;
-  curr->dir = dir;
-  curr->next = 0;
+  q->head = (q->head + 1) % q->size;
+  q->count--;
+  return (item);
+}
+
+static int path_link_compare(const void *a, const void *b)
+{
+  const struct path_link *la = (const struct path_link *) a;
+  const struct path_link *lb = (const struct path_link *) b;
 
-  if (queue_tail) {
-    queue_tail->next = curr;
-    queue_tail = curr;
-  } else
-    queue_head = queue_tail = curr;
+  if (la->from != lb->from)
+    return (la->from < lb->from) ? -1 : 1;
+  return (la->to < lb->to) ? -1 : (la->to > lb->to) ? 1 : 0;
 }
 
+/* collect the zone-crossing exits into the zone graph, one link per pair */
+static void path_build_zones(void)
+{
+  room_rnum r;
+  zone_rnum z;
+  int i, n;
+
+  if (path_zones != top_of_zone_table + 1) {
+    if (path_link_first) {
+      free(path_link_first);
+      free(path_zone_seen);
+      free(path_zone_from);
+    }
+    path_zones = top_of_zone_table + 1;
+    CREATE(path_link_first, int, path_zones + 1);
+    CREATE(path_zone_seen, unsigned long, path_zones);
+    CREATE(path_zone_from, zone_rnum, path_zones);
+    path_queue_init(&path_zq, path_zones);
+    path_zone_stamp = 0;
+  }
+
+  /* at most one link per exit; duplicates are squeezed out below */
+  if (path_links)
+    free(path_links);
+  CREATE(path_links, struct path_link, MAX(path_num_edges, 1));
+
+  for (n = 0, r = 0; r < path_rooms; r++) {
+    if ((z = world[r].zone) >= path_zones)
+      continue;
+    for (i = path_first[r]; i < path_first[r + 1]; i++)
+      if (path_edges[i].zone != z && path_edges[i].zone < path_zones) {
+	path_links[n].from = z;
+	path_links[n].to = path_edges[i].zone;
+	n++;
+      }
+  }
+
+  qsort(path_links, n, sizeof(struct path_link), path_link_compare);
+  for (path_num_links = 0, i = 0; i < n; i++)
+    if (!path_num_links || path_link_compare(&path_links[i], &path_links[path_num_links - 1]))
+      path_links[path_num_links++] = path_links[i];
 
-void bfs_dequeue(void)
+  for (i = 0, z = 0; z < path_zones; z++) {
+    path_link_first[z] = i;
+    while (i < path_num_links && path_links[i].from == z)
+      i++;
+  }
+  path_link_first[path_zones] = path_num_links;
+}
+
+/* (re)build the adjacency array and the per-room arrays from world[] */
+static void path_build_graph(void)
 {
-  struct bfs_queue_struct *curr;
+  room_rnum r, to;
+  int dir, n = 0;
+
+  if (path_rooms != top_of_world + 1) {
+    if (path_first) {
+      free(path_first);
+      free(path_seen);
+      free(path_from);
+      free(path_dir);
+    }
+    path_rooms = top_of_world + 1;
+    CREATE(path_first, int, path_rooms + 1);
+    CREATE(path_seen, unsigned long, path_rooms);
+    CREATE(path_from, room_rnum, path_rooms);
+    CREATE(path_dir, sbyte, path_rooms);
+    path_queue_init(&path_q, path_rooms);
+    path_stamp = 0;
+  }
+
+  /* count first, so the edges go into one block */
+  for (r = 0; r < path_rooms; r++)
+    for (dir = 0; dir < NUM_OF_DIRS; dir++)
+      if (world[r].dir_option[dir] && (to = world[r].dir_option[dir]->to_room) != NOWHERE &&
+	  to < path_rooms && !ROOM_FLAGGED(to, ROOM_NOTRACK))
+	n++;
+
+  if (path_edges)
+    free(path_edges);
+  CREATE(path_edges, struct path_edge, MAX(n, 1));
+  path_num_edges = n;
+
+  for (n = 0, r = 0; r < path_rooms; r++) {
+    path_first[r] = n;
+    for (dir = 0; dir < NUM_OF_DIRS; dir++)
+      if (world[r].dir_option[dir] && (to = world[r].dir_option[dir]->to_room) != NOWHERE &&
+	  to < path_rooms && !ROOM_FLAGGED(to, ROOM_NOTRACK)) {
+	path_edges[n].to = to;
+	path_edges[n].zone = world[to].zone;
+	path_edges[n].dir = dir;
+	path_edges[n].door = EXIT_FLAGGED(world[r].dir_option[dir], EX_ISDOOR) ? 1 : 0;
+	n++;
+      }
+  }
+  path_first[path_rooms] = n;
+
+  path_build_zones();
 
-  curr = queue_head;
+  path_graph_dirty = FALSE;
+  path_stats.rebuilds++;
+}
 
-  if (!(queue_head = queue_head->next))
-    queue_tail = 0;
-  free(curr);
+/* an exit was added, removed or pointed elsewhere, or rooms renumbered */
+void path_exits_changed(void)
+{
+  path_graph_dirty = TRUE;
+  path_generation++;
+  path_stats.invalidations++;
 }
 
+/* a door was opened or closed */
+void path_doors_changed(void)
+{
+  path_generation++;
+  path_stats.invalidations++;
+}
+
+void path_free(void)
+{
+  if (path_first) {
+    free(path_first);
+    free(path_seen);
+    free(path_from);
+    free(path_dir);
+    free(path_q.items);
+  }
+  if (path_link_first) {
+    free(path_link_first);
+    free(path_zone_seen);
+    free(path_zone_from);
+    free(path_zq.items);
+  }
+  if (path_edges)
+    free(path_edges);
+  if (path_links)
+    free(path_links);
+  path_first = NULL;
+  path_seen = NULL;
+  path_from = NULL;
+  path_dir = NULL;
+  path_q.items = NULL;
+  path_link_first = NULL;
+  path_zone_seen = NULL;
+  path_zone_from = NULL;
+  path_zq.items = NULL;
+  path_edges = NULL;
+  path_links = NULL;
+  path_rooms = 0;
+  path_zones = 0;
+  path_graph_dirty = TRUE;
+}
+
+static void path_lru_unlink(struct path_hop *hop)
+{
+  if (hop->prev)
+    hop->prev->next = hop->next;
+  else
+    path_lru_head = hop->next;
+  if (hop->next)
+    hop->next->prev = hop->prev;
+  else
+    path_lru_tail = hop->prev;
+}
+
+static void path_lru_push(struct path_hop *hop)
+{
+  hop->prev = NULL;
+  hop->next = path_lru_head;
+  if (path_lru_head)
+    path_lru_head->prev = hop;
+  else
+    path_lru_tail = hop;
+  path_lru_head = hop;
+}
+
+static struct path_hop *path_cache_find(room_rnum src, room_rnum target, bool zone)
+{
+  struct path_hop *hop;
+
+  for (hop = path_hash[PATH_HASH(src, target)]; hop; hop = hop->next_hash)
+    if (hop->src == src && hop->target == target && hop->zone == zone)
+      return (hop);
+  return (NULL);
+}
+
+/* a cached hop that is still good, counted and made most recent */
+static struct path_hop *path_cache_lookup(room_rnum src, room_rnum target, bool zone)
+{
+  struct path_hop *hop;
+
+  if (!path_cache_on || !(hop = path_cache_find(src, target, zone)) ||
+      hop->generation != path_generation)
+    return (NULL);
+  path_stats.hits++;
+  path_lru_unlink(hop);
+  path_lru_push(hop);
+  return (hop);
+}
+
+static void path_cache_store(room_rnum src, room_rnum target, bool zone, int dir)
+{
+  struct path_hop *hop, **h;
+  int i;
+
+  if (!path_lru_tail)		/* first use: every entry starts out spare */
+    for (i = 0; i < PATH_CACHE_SIZE; i++) {
+      path_cache[i].src = path_cache[i].target = NOWHERE;
+      path_lru_push(&path_cache[i]);
+    }
+
+  if (!(hop = path_cache_find(src, target, zone))) {
+    /* reuse the least recently used entry */
+    hop = path_lru_tail;
+    if (hop->src != NOWHERE)
+      for (h = &path_hash[PATH_HASH(hop->src, hop->target)]; *h; h = &(*h)->next_hash)
+	if (*h == hop) {
+	  *h = hop->next_hash;
+	  break;
+	}
+    hop->src = src;
+    hop->target = target;
+    hop->zone = zone;
+    h = &path_hash[PATH_HASH(src, target)];
+    hop->next_hash = *h;
+    *h = hop;
+  }
+
+  hop->dir = dir;
+  hop->generation = path_generation;
+  path_lru_unlink(hop);
+  path_lru_push(hop);
+}
+
+/* the next zone on the way from zone src to zone target, or NOWHERE */
+static zone_rnum path_zone_step(zone_rnum src, zone_rnum target)
+{
+  zone_rnum zone, next;
+  int i;
+
+  if (++path_zone_stamp == 0) {
+    memset(path_zone_seen, 0, sizeof(unsigned long) * path_zones);
+    path_zone_stamp = 1;
+  }
+
+  path_zq.head = path_zq.count = 0;
+  path_zone_seen[src] = path_zone_stamp;
+  path_enqueue(&path_zq, src);
+
+  while (path_zq.count) {
+    zone = path_dequeue(&path_zq);
+    for (i = path_link_first[zone]; i < path_link_first[zone + 1]; i++) {
+      next = path_links[i].to;
+      if (path_zone_seen[next] == path_zone_stamp)
+	continue;
+      path_zone_seen[next] = path_zone_stamp;
+      path_zone_from[next] = zone;
+      if (next != target) {
+	path_enqueue(&path_zq, next);
+	continue;
+      }
+      while (path_zone_from[next] != src)
+	next = path_zone_from[next];
+      return (next);
+    }
+  }
+  return (NOWHERE);
+}
 
-void bfs_clear_queue(void)
+/*
+ * breadth-first search from src; caches and returns the first step.  With
+ * a zone to go toward, only rooms in zone within are searched and any room
+ * in zone toward counts as arriving.  The hops are then cached as the way
+ * into that zone, and a miss is not cached, since the caller falls back to
+ * a full search.
+ */
+static int path_search(room_rnum src, room_rnum target, zone_rnum within, zone_rnum toward)
 {
-  while (queue_head)
-    bfs_dequeue();
+  struct path_edge *e, *end;
+  room_rnum room, prev;
+  int dir, check_doors = (CONFIG_TRACK_T_DOORS == FALSE);
+
+  if (++path_stamp == 0) {	/* wrapped; forget every old stamp */
+    memset(path_seen, 0, sizeof(unsigned long) * path_rooms);
+    path_stamp = 1;
+  }
+  path_stats.searches++;
+
+  path_q.head = path_q.count = 0;
+  path_seen[src] = path_stamp;
+  path_enqueue(&path_q, src);
+
+  while (path_q.count) {
+    room = path_dequeue(&path_q);
+    path_stats.expanded++;
+
+    for (e = path_edges + path_first[room], end = path_edges + path_first[room + 1]; e < end; e++) {
+      if (path_seen[e->to] == path_stamp)
+	continue;
+      if (toward != NOWHERE && e->zone != within && e->zone != toward)
+	continue;
+      if (e->door && check_doors && IS_CLOSED(room, e->dir))
+	continue;
+
+      path_seen[e->to] = path_stamp;
+      path_from[e->to] = room;
+      path_dir[e->to] = e->dir;
+
+      if (toward == NOWHERE ? e->to != target : e->zone != toward) {
+	path_enqueue(&path_q, e->to);
+	continue;
+      }
+
+      /* found it: walk back to src, caching the next hop of every room */
+      for (dir = BFS_NO_PATH, room = e->to; room != src; room = prev) {
+	prev = path_from[room];
+	dir = path_dir[room];
+	if (path_cache_on)
+	  path_cache_store(prev, toward == NOWHERE ? target : toward, toward != NOWHERE, dir);
+      }
+      return (dir);
+    }
+  }
+
+  if (path_cache_on && toward == NOWHERE)
+    path_cache_store(src, target, FALSE, BFS_NO_PATH);
+  return (BFS_NO_PATH);
 }
 
 
@@ -108,8 +510,9 @@ void bfs_clear_queue(void)
  */
 int find_first_step(room_rnum src, room_rnum target)
 {
-  int curr_dir;
-  room_rnum curr_room;
+  struct path_hop *hop;
+  zone_rnum from, to, next;
+  int dir;
 
   if (src == NOWHERE || target == NOWHERE || src > top_of_world || target > top_of_world) {
     log("SYSERR: Illegal value %d or %d passed to find_first_step. (%s)", src, target, __FILE__);
@@ -118,36 +521,176 @@ int find_first_step(room_rnum src, room_rnum target)
   if (src == target)
     return (BFS_ALREADY_THERE);
 
-  /* clear marks first, some OLC systems will save the mark. */
-  for (curr_room = 0; curr_room <= top_of_world; curr_room++)
-    UNMARK(curr_room);
+  if (PATH_GRAPH_STALE())
+    path_build_graph();
+
+  path_stats.lookups++;
+  if ((hop = path_cache_lookup(src, target, FALSE)) != NULL)
+    return (hop->dir);
+
+  from = world[src].zone;
+  to = world[target].zone;
+  if (path_zones_on && from != to && from < path_zones && to < path_zones) {
+    if ((next = path_zone_step(from, to)) != NOWHERE) {
+      if ((hop = path_cache_lookup(src, next, TRUE)) != NULL)
+	return (hop->dir);
+      if ((dir = path_search(src, target, from, next)) >= 0) {
+	path_stats.zone_routes++;
+	return (dir);
+      }
+    }
+    path_stats.fallbacks++;
+  }
 
-  MARK(src);
+  return (path_search(src, target, NOWHERE, NOWHERE));
+}
 
-  /* first, enqueue the first steps, saving which direction we're going. */
-  for (curr_dir = 0; curr_dir < NUM_OF_DIRS; curr_dir++)
-    if (VALID_EDGE(src, curr_dir)) {
-      MARK(TOROOM(src, curr_dir));
-      bfs_enqueue(TOROOM(src, curr_dir), curr_dir);
-    }
 
-  /* now, do the classic BFS. */
-  while (queue_head) {
-    if (queue_head->room == target) {
-      curr_dir = queue_head->dir;
-      bfs_clear_queue();
-      return (curr_dir);
-    } else {
-      for (curr_dir = 0; curr_dir < NUM_OF_DIRS; curr_dir++)
-	if (VALID_EDGE(queue_head->room, curr_dir)) {
-	  MARK(TOROOM(queue_head->room, curr_dir));
-	  bfs_enqueue(TOROOM(queue_head->room, curr_dir), queue_head->dir);
-	}
-      bfs_dequeue();
+/*
+ * Follow find_first_step() from src to target, putting the directions in
+ * route.  Returns the number of steps, or a BFS_ code if there is no way
+ * there within max steps.
+ */
+int path_route(room_rnum src, room_rnum target, int *route, int max)
+{
+  int n = 0, dir;
+
+  while (src != target) {
+    if (n >= max)
+      return (BFS_NO_PATH);
+    if ((dir = find_first_step(src, target)) < 0)
+      return (dir);
+    route[n++] = dir;
+    src = world[src].dir_option[dir]->to_room;
+  }
+  return (n);
+}
+
+
+/*
+ * show paths bench [<mobs>] - time <mobs> mobs hunting random targets
+ * across the world for a number of ticks: searching every room, routing
+ * by zone, and routing by zone with the cache.  Nobody actually moves;
+ * the hunters are just room numbers.
+ */
+#define PATH_BENCH_PASSES	3
+#define PATH_BENCH_TICKS	20
+#define PATH_BENCH_PREY		25
+
+static void path_bench_run(room_rnum *start, room_rnum *target, room_rnum *at,
+			int mobs, unsigned long *usecs, unsigned long *expanded,
+			unsigned long *hits, int *arrived)
+{
+  struct timeval before, after, spent;
+  unsigned long exp0 = path_stats.expanded, hits0 = path_stats.hits;
+  int i, t, dir;
+
+  memcpy(at, start, sizeof(room_rnum) * mobs);
+  *arrived = 0;
+
+  gettimeofday(&before, (struct timezone *) 0);
+  for (t = 0; t < PATH_BENCH_TICKS; t++)
+    for (i = 0; i < mobs; i++) {
+      if (at[i] == target[i])
+	continue;
+      if ((dir = find_first_step(at[i], target[i])) >= 0) {
+	at[i] = world[at[i]].dir_option[dir]->to_room;
+	if (at[i] == target[i])
+	  (*arrived)++;
+      }
     }
+  gettimeofday(&after, (struct timezone *) 0);
+  timediff(&spent, &after, &before);
+
+  *usecs = spent.tv_sec * 1000000 + spent.tv_usec;
+  *expanded = path_stats.expanded - exp0;
+  *hits = path_stats.hits - hits0;
+}
+
+static void path_bench(struct char_data *ch, int mobs)
+{
+  room_rnum *start, *target, *at, prey[PATH_BENCH_PREY], r;
+  unsigned long usecs[PATH_BENCH_PASSES], expanded[PATH_BENCH_PASSES], hits[PATH_BENCH_PASSES];
+  int arrived[PATH_BENCH_PASSES], i, pass, tries;
+  int cache_was = path_cache_on, zones_were = path_zones_on;
+  const char *pass_names[PATH_BENCH_PASSES] = { "Flat", "Zones", "Zones+cache" };
+
+  if (PATH_GRAPH_STALE())
+    path_build_graph();
+
+  /* hunters and prey only stand in rooms with a way out */
+  for (i = 0; i < PATH_BENCH_PREY; i++) {
+    for (tries = 0, r = rand_number(0, top_of_world);
+	 path_first[r] == path_first[r + 1] && tries < 100; tries++)
+      r = rand_number(0, top_of_world);
+    prey[i] = r;
   }
 
-  return (BFS_NO_PATH);
+  CREATE(start, room_rnum, mobs);
+  CREATE(target, room_rnum, mobs);
+  CREATE(at, room_rnum, mobs);
+  for (i = 0; i < mobs; i++) {
+    for (tries = 0, r = rand_number(0, top_of_world);
+	 path_first[r] == path_first[r + 1] && tries < 100; tries++)
+      r = rand_number(0, top_of_world);
+    start[i] = r;
+    target[i] = prey[rand_number(0, PATH_BENCH_PREY - 1)];
+  }
+
+  for (pass = 0; pass < PATH_BENCH_PASSES; pass++) {
+    path_zones_on = (pass > 0);
+    path_cache_on = (pass > 1);
+    path_generation++;		/* start each pass with a cold cache */
+    path_bench_run(start, target, at, mobs, &usecs[pass], &expanded[pass],
+		   &hits[pass], &arrived[pass]);
+  }
+  path_cache_on = cache_was;
+  path_zones_on = zones_were;
+
+  send_to_char(ch,
+	"%d hunters, %d prey, %d ticks over %d rooms, %d exits and %d zone links:\r\n"
+	"                usecs  usecs/tick  rooms searched  cache hits  arrived\r\n",
+	mobs, PATH_BENCH_PREY, PATH_BENCH_TICKS, path_rooms, path_num_edges, path_num_links);
+  for (pass = 0; pass < PATH_BENCH_PASSES; pass++)
+    send_to_char(ch, "%-11s %9lu %11lu %15lu %11lu %8d\r\n", pass_names[pass],
+	usecs[pass], usecs[pass] / PATH_BENCH_TICKS, expanded[pass], hits[pass], arrived[pass]);
+
+  free(start);
+  free(target);
+  free(at);
+}
+
+/* show paths [bench [<mobs>]] */
+void path_report(struct char_data *ch, char *value, char *arg)
+{
+  struct path_hop *hop;
+  int used = 0, fresh = 0;
+
+  skip_spaces(&arg);
+  if (*value && is_abbrev(value, "bench")) {
+    path_bench(ch, *arg && is_number(arg) ? MIN(MAX(atoi(arg), 1), 100000) : 1000);
+    return;
+  }
+
+  for (hop = path_lru_head; hop; hop = hop->next)
+    if (hop->src != NOWHERE) {
+      used++;
+      if (hop->generation == path_generation)
+	fresh++;
+    }
+
+  send_to_char(ch,
+	"Graph: %d rooms, %d exits, %d zones, %d zone links, rebuilt %lu times, generation %lu.\r\n"
+	"Cache: %d of %d entries used, %d current, %lu invalidations.\r\n"
+	"Zone routes: %lu, fell back to a full search: %lu.\r\n"
+	"Lookups: %lu, cache hits: %lu (%lu%%), searches: %lu, rooms searched: %lu (%lu per search).\r\n",
+	path_rooms, path_num_edges, path_zones, path_num_links, path_stats.rebuilds, path_generation,
+	used, PATH_CACHE_SIZE, fresh, path_stats.invalidations,
+	path_stats.zone_routes, path_stats.fallbacks,
+	path_stats.lookups, path_stats.hits,
+	path_stats.lookups ? path_stats.hits * 100 / path_stats.lookups : 0,
+	path_stats.searches, path_stats.expanded,
+	path_stats.searches ? path_stats.expanded / path_stats.searches : 0);
 }
 
 
@@ -213,36 +756,106 @@ ACMD(do_track)
 }
 
 
+#define PATH_MAX_ROUTE	1000
+
+/* path <character | room> [<room>] - show the whole route between two places */
+ACMD(do_path)
+{
+  char arg1[MAX_INPUT_LENGTH], arg2[MAX_INPUT_LENGTH], buf[MAX_STRING_LENGTH];
+  int route[PATH_MAX_ROUTE], steps, i, run;
+  room_rnum src = IN_ROOM(ch), target, room;
+  zone_rnum zone;
+  struct char_data *vict;
+  size_t len;
+
+  two_arguments(argument, arg1, arg2);
+  if (!*arg1) {
+    send_to_char(ch, "Usage: path <character | room vnum> [<room vnum>]\r\n");
+    return;
+  }
+
+  if (*arg2) {
+    if (!is_number(arg1) || !is_number(arg2) ||
+	(src = real_room(atoi(arg1))) == NOWHERE ||
+	(target = real_room(atoi(arg2))) == NOWHERE) {
+      send_to_char(ch, "Both ends must be existing room vnums.\r\n");
+      return;
+    }
+  } else if (is_number(arg1)) {
+    if ((target = real_room(atoi(arg1))) == NOWHERE) {
+      send_to_char(ch, "There is no room with that number.\r\n");
+      return;
+    }
+  } else if ((vict = get_char_vis(ch, arg1, NULL, FIND_CHAR_WORLD)) != NULL)
+    target = IN_ROOM(vict);
+  else {
+    send_to_char(ch, "No one is around by that name.\r\n");
+    return;
+  }
+
+  if ((steps = path_route(src, target, route, PATH_MAX_ROUTE)) < 0) {
+    send_to_char(ch, "There is no way from [%d] to [%d].\r\n",
+	GET_ROOM_VNUM(src), GET_ROOM_VNUM(target));
+    return;
+  }
+  if (!steps) {
+    send_to_char(ch, "That is where you start.\r\n");
+    return;
+  }
+
+  len = snprintf(buf, sizeof(buf), "Route from [%d] to [%d], %d step%s, through zone%s %d",
+	GET_ROOM_VNUM(src), GET_ROOM_VNUM(target), steps, steps == 1 ? "" : "s",
+	world[src].zone == world[target].zone ? "" : "s", zone_table[world[src].zone].number);
+  for (zone = world[src].zone, room = src, i = 0; i < steps; i++) {
+    room = world[room].dir_option[route[i]]->to_room;
+    if (world[room].zone != zone && len < sizeof(buf)) {
+      zone = world[room].zone;
+      len += snprintf(buf + len, sizeof(buf) - len, ", %d", zone_table[zone].number);
+    }
+  }
+  if (len < sizeof(buf))
+    len += snprintf(buf + len, sizeof(buf) - len, ":\r\n");
+
+  /* runs of one direction are written as a count and the direction letter */
+  for (i = 0; i < steps && len < sizeof(buf); i += run) {
+    for (run = 1; i + run < steps && route[i + run] == route[i]; run++);
+    if (run > 1)
+      len += snprintf(buf + len, sizeof(buf) - len, "%d%c ", run, *dirs[route[i]]);
+    else
+      len += snprintf(buf + len, sizeof(buf) - len, "%c ", *dirs[route[i]]);
+  }
+  if (len < sizeof(buf))
+    snprintf(buf + len, sizeof(buf) - len, "\r\n");
+
+  page_string(ch->desc, buf, TRUE);
+}
+
+
 void hunt_victim(struct char_data *ch)
 {
   int dir;
-  byte found;
-  struct char_data *tmp;
+  struct char_data *prey;
 
-  if (!ch || !HUNTING(ch) || FIGHTING(ch))
+  if (!ch || !ch->char_specials.hunting.slot || FIGHTING(ch))
     return;
 
-  /* make sure the char still exists */
-  for (found = FALSE, tmp = character_list; tmp && !found; tmp = tmp->next)
-    if (HUNTING(ch) == tmp)
-      found = TRUE;
-
-  if (!found) {
+  /* the reference goes stale when the prey leaves the game */
+  if (!(prey = HUNTING(ch))) {
     char actbuf[MAX_INPUT_LENGTH] = "Damn!  My prey is gone!!";
 
     do_say(ch, actbuf, 0, 0);
-    HUNTING(ch) = NULL;
+    SET_HUNTING(ch, NULL);
     return;
   }
-  if ((dir = find_first_step(IN_ROOM(ch), IN_ROOM(HUNTING(ch)))) < 0) {
+  if ((dir = find_first_step(IN_ROOM(ch), IN_ROOM(prey))) < 0) {
     char buf[MAX_INPUT_LENGTH];
 
-    snprintf(buf, sizeof(buf), "Damn!  I lost %s!", HMHR(HUNTING(ch)));
+    snprintf(buf, sizeof(buf), "Damn!  I lost %s!", HMHR(prey));
     do_say(ch, buf, 0, 0);
-    HUNTING(ch) = NULL;
+    SET_HUNTING(ch, NULL);
   } else {
     perform_move(ch, dir, 1);
-    if (IN_ROOM(ch) == IN_ROOM(HUNTING(ch)))
-      hit(ch, HUNTING(ch), TYPE_UNDEFINED);
+    if (IN_ROOM(ch) == IN_ROOM(prey))
+      hit(ch, prey, TYPE_UNDEFINED);
   }
 }
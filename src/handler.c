@@ -37,6 +37,8 @@ int invalid_class(struct char_data *ch, struct obj_data *obj);
 void remove_follower(struct char_data *ch);
 void clearMemory(struct char_data *ch);
 ACMD(do_return);
+void mob_ai_char_to_room(struct char_data *ch);
+void mob_ai_char_from_room(struct char_data *ch);
 
 char *fname(const char *namelist)
 {
@@ -119,6 +121,8 @@ void affect_modify(struct char_data *ch, byte loc, sbyte mod,
     REMOVE_BIT(AFF_FLAGS(ch), bitv);
     mod = -mod;
   }
+  if (IS_SET(bitv, AFF_HIDE | AFF_INVISIBLE))
+    room_census_dirty(IN_ROOM(ch));
 
   switch (loc) {
   case APPLY_NONE:
@@ -275,6 +279,10 @@ void affect_total(struct char_data *ch)
   for (af = ch->affected; af; af = af->next)
     affect_modify(ch, af->location, af->modifier, af->bitvector, TRUE);
 
+  /* equipment or affects changed, so work the combat numbers out again */
+  ch->combat.valid = FALSE;
+  GMCP_DIRTY(ch, GMCP_VITALS);
+
   /* Make certain values are between 0..25, not < 0 and not > 25! */
 
   i = (IS_NPC(ch) || GET_LEVEL(ch) >= LVL_GRGOD) ? 25 : 18;
@@ -305,11 +313,12 @@ void affect_to_char(struct char_data *ch, struct affected_type *af)
 {
   struct affected_type *affected_alloc;
 
-  CREATE(affected_alloc, struct affected_type, 1);
+  SLAB_CREATE(affected_alloc, struct affected_type, SLAB_AFFECT);
 
   *affected_alloc = *af;
   affected_alloc->next = ch->affected;
   ch->affected = affected_alloc;
+  affect_wheel_add(ch, affected_alloc);
 
   affect_modify(ch, af->location, af->modifier, af->bitvector, TRUE);
   affect_total(ch);
@@ -333,7 +342,8 @@ void affect_remove(struct char_data *ch, struct affected_type *af)
 
   affect_modify(ch, af->location, af->modifier, af->bitvector, FALSE);
   REMOVE_FROM_LIST(af, ch->affected, next);
-  free(af);
+  affect_wheel_remove(af);
+  SLAB_FREE(af);
   affect_total(ch);
 }
 
@@ -381,7 +391,7 @@ void affect_join(struct char_data *ch, struct affected_type *af,
 
     if ((hjp->type == af->type) && (hjp->location == af->location)) {
       if (add_dur)
-	af->duration += hjp->duration;
+	af->duration += affect_duration(hjp);
       if (avg_dur)
 	af->duration /= 2;
 
@@ -400,6 +410,70 @@ void affect_join(struct char_data *ch, struct affected_type *af,
 }
 
 
+/*
+ * Room census.  A room counts the players, mobiles and objects in it, so
+ * asking whether anybody is there doesn't mean walking world[].people.
+ * Its summary of who they are (OCC_ bits) is a union, which can't be
+ * taken apart when one of them leaves; room_occupants() builds it again
+ * the next time it is asked for.  Someone coming in only adds to it.
+ * Whatever gives a character one of the bits while it is in a room must
+ * call room_census_dirty() for the room, or room_census_changed() when
+ * it can't tell which room that is.
+ */
+static unsigned long room_census_stamp = 1;
+
+static bitvector_t census_bits(struct char_data *ch)
+{
+  bitvector_t bits = 0;
+
+  if (IS_NPC(ch)) {
+    if (MOB_FLAGGED(ch, MOB_ATTACKS_ON_SIGHT))
+      bits |= OCC_AGGRESSIVE;
+    if ((SCRIPT(ch) && TRIGGERS(SCRIPT(ch))) || SCRIPT_MEM(ch))
+      bits |= OCC_SCRIPTED;
+    if (ch->desc)
+      bits |= OCC_SWITCHED;
+  }
+  if (AFF_FLAGGED(ch, AFF_HIDE | AFF_INVISIBLE))
+    bits |= OCC_HIDDEN;
+
+  return (bits);
+}
+
+/* the OCC_ bits of everyone in the room; may have a bit nobody has now */
+bitvector_t room_occupants(room_rnum room)
+{
+  struct room_census *c = &world[room].census;
+  struct char_data *ch;
+  bitvector_t bits;
+
+  if (c->stamp != room_census_stamp) {
+    c->occupants = 0;
+    c->hidden = 0;
+    for (ch = world[room].people; ch; ch = ch->next_in_room) {
+      c->occupants |= (bits = census_bits(ch));
+      if (IS_SET(bits, OCC_HIDDEN))
+	c->hidden++;
+    }
+    c->stamp = room_census_stamp;
+  }
+  return (c->occupants);
+}
+
+void room_census_dirty(room_rnum room)
+{
+  if (room != NOWHERE && room <= top_of_world)
+    world[room].census.stamp = 0;
+}
+
+/* every room's summary is stale */
+void room_census_changed(void)
+{
+  if (++room_census_stamp == 0)
+    room_census_stamp = 1;
+}
+
+
 /* move a player out of a room */
 void char_from_room(struct char_data *ch)
 {
@@ -418,6 +492,22 @@ void char_from_room(struct char_data *ch)
       if (GET_OBJ_VAL(GET_EQ(ch, WEAR_LIGHT), 2))	/* Light is ON */
 	world[IN_ROOM(ch)].light--;
 
+  if (SCRIPT_CHECK(ch, MTRIG_SPEECH | MTRIG_ACT))
+    speech_index_dirty(IN_ROOM(ch));
+  if (SCRIPT_CHECK(ch, MTRIG_COMMAND))
+    CMD_FILTER_DIRTY(world[IN_ROOM(ch)].cmd_filter);
+
+  if (!IS_NPC(ch) && !--zone_table[world[IN_ROOM(ch)].zone].players)
+    zone_emptied(world[IN_ROOM(ch)].zone);
+  mob_ai_char_from_room(ch);
+
+  if (IS_NPC(ch))
+    world[IN_ROOM(ch)].census.npcs--;
+  else
+    world[IN_ROOM(ch)].census.pcs--;
+  if (census_bits(ch))
+    world[IN_ROOM(ch)].census.stamp = 0;
+
   REMOVE_FROM_LIST(ch, world[IN_ROOM(ch)].people, next_in_room);
   IN_ROOM(ch) = NOWHERE;
   ch->next_in_room = NULL;
@@ -427,19 +517,50 @@ void char_from_room(struct char_data *ch)
 /* place a character in a room */
 void char_to_room(struct char_data *ch, room_rnum room)
 {
+  struct room_census *c;
+  bitvector_t bits;
+
   if (ch == NULL || room == NOWHERE || room > top_of_world)
     log("SYSERR: Illegal value(s) passed to char_to_room. (Room: %d/%d Ch: %p",
 		room, top_of_world, ch);
   else {
+    /*
+     * Catching a hibernating zone up can run triggers and extract things,
+     * which the mover may still hold, so it is only queued for next pulse.
+     */
+    if (!IS_NPC(ch) && !zone_table[world[room].zone].players)
+      queue_zone_wake(world[room].zone);
+
     ch->next_in_room = world[room].people;
     world[room].people = ch;
     IN_ROOM(ch) = room;
 
+    c = &world[room].census;
+    if (IS_NPC(ch))
+      c->npcs++;
+    else
+      c->pcs++;
+    if (c->stamp == room_census_stamp && (bits = census_bits(ch)) != 0) {
+      c->occupants |= bits;
+      if (IS_SET(bits, OCC_HIDDEN))
+	c->hidden++;
+    }
+
+    if (!IS_NPC(ch))
+      zone_table[world[room].zone].players++;
+    mob_ai_char_to_room(ch);
+
     if (GET_EQ(ch, WEAR_LIGHT))
       if (GET_OBJ_TYPE(GET_EQ(ch, WEAR_LIGHT)) == ITEM_LIGHT)
 	if (GET_OBJ_VAL(GET_EQ(ch, WEAR_LIGHT), 2))	/* Light ON */
 	  world[room].light++;
 
+    if (SCRIPT_CHECK(ch, MTRIG_SPEECH | MTRIG_ACT))
+      speech_index_dirty(room);
+    if (SCRIPT_CHECK(ch, MTRIG_COMMAND))
+      CMD_FILTER_DIRTY(world[room].cmd_filter);
+    GMCP_DIRTY(ch, GMCP_ROOM);
+
     /* Stop fighting now, if we left. */
     if (FIGHTING(ch) && IN_ROOM(ch) != IN_ROOM(FIGHTING(ch))) {
       stop_fighting(FIGHTING(ch));
@@ -456,10 +577,13 @@ void obj_to_char(struct obj_data *object, struct char_data *ch)
     object->next_content = ch->carrying;
     ch->carrying = object;
     object->carried_by = ch;
-    IN_ROOM(object) = NOWHERE;
+    OBJ_IN_ROOM(object) = NOWHERE;
     IS_CARRYING_W(ch) += GET_OBJ_WEIGHT(object);
     IS_CARRYING_N(ch)++;
 
+    if (SCRIPT_CHECK(object, OTRIG_COMMAND))
+      CMD_FILTER_DIRTY(ch->cmd_filter);
+
     /* set flag for crash-save system, but not on mobs! */
     if (!IS_NPC(ch))
       SET_BIT(PLR_FLAGS(ch), PLR_CRASH);
@@ -479,6 +603,9 @@ void obj_from_char(struct obj_data *object)
   }
   REMOVE_FROM_LIST(object, object->carried_by->carrying, next_content);
 
+  if (SCRIPT_CHECK(object, OTRIG_COMMAND))
+    CMD_FILTER_DIRTY(object->carried_by->cmd_filter);
+
   /* set flag for crash-save system, but not on mobs! */
   if (!IS_NPC(object->carried_by))
     SET_BIT(PLR_FLAGS(object->carried_by), PLR_CRASH);
@@ -552,7 +679,7 @@ void equip_char(struct char_data *ch, struct obj_data *obj, int pos)
     log("SYSERR: EQUIP: Obj is carried_by when equip.");
     return;
   }
-  if (IN_ROOM(obj) != NOWHERE) {
+  if (OBJ_IN_ROOM(obj) != NOWHERE) {
     log("SYSERR: EQUIP: Obj is in_room when equip.");
     return;
   }
@@ -568,6 +695,9 @@ void equip_char(struct char_data *ch, struct obj_data *obj, int pos)
   obj->worn_by = ch;
   obj->worn_on = pos;
 
+  if (SCRIPT_CHECK(obj, OTRIG_COMMAND))
+    CMD_FILTER_DIRTY(ch->cmd_filter);
+
   if (GET_OBJ_TYPE(obj) == ITEM_ARMOR)
     GET_AC(ch) -= apply_ac(ch, pos);
 
@@ -602,6 +732,9 @@ struct obj_data *unequip_char(struct char_data *ch, int pos)
   obj->worn_by = NULL;
   obj->worn_on = -1;
 
+  if (SCRIPT_CHECK(obj, OTRIG_COMMAND))
+    CMD_FILTER_DIRTY(ch->cmd_filter);
+
   if (GET_OBJ_TYPE(obj) == ITEM_ARMOR)
     GET_AC(ch) += apply_ac(ch, pos);
 
@@ -663,16 +796,72 @@ struct obj_data *get_obj_in_list_num(int num, struct obj_data *list)
 
 
 
-/* search the entire world for an object number, and return a pointer  */
-struct obj_data *get_obj_num(obj_rnum nr)
+/*
+ * Every mob and object made from a prototype is also on a list hanging
+ * off its index entry, newest first like character_list and object_list,
+ * so finding the live copies of one prototype doesn't mean walking
+ * everything in the game.
+ */
+void add_mob_instance(struct char_data *mob)
 {
-  struct obj_data *i;
+  struct index_data *idx;
 
-  for (i = object_list; i; i = i->next)
-    if (GET_OBJ_RNUM(i) == nr)
-      return (i);
+  mob->prev_instance = mob->next_instance = NULL;
+  if (GET_MOB_RNUM(mob) == NOBODY || GET_MOB_RNUM(mob) > top_of_mobt)
+    return;
 
-  return (NULL);
+  idx = &mob_index[GET_MOB_RNUM(mob)];
+  if ((mob->next_instance = idx->mobs) != NULL)
+    idx->mobs->prev_instance = mob;
+  idx->mobs = mob;
+}
+
+void remove_mob_instance(struct char_data *mob)
+{
+  if (mob->prev_instance)
+    mob->prev_instance->next_instance = mob->next_instance;
+  else if (GET_MOB_RNUM(mob) != NOBODY && GET_MOB_RNUM(mob) <= top_of_mobt &&
+	   mob_index[GET_MOB_RNUM(mob)].mobs == mob)
+    mob_index[GET_MOB_RNUM(mob)].mobs = mob->next_instance;
+  if (mob->next_instance)
+    mob->next_instance->prev_instance = mob->prev_instance;
+  mob->prev_instance = mob->next_instance = NULL;
+}
+
+void add_obj_instance(struct obj_data *obj)
+{
+  struct index_data *idx;
+
+  obj->prev_instance = obj->next_instance = NULL;
+  if (GET_OBJ_RNUM(obj) == NOTHING || GET_OBJ_RNUM(obj) > top_of_objt)
+    return;
+
+  idx = &obj_index[GET_OBJ_RNUM(obj)];
+  if ((obj->next_instance = idx->objs) != NULL)
+    idx->objs->prev_instance = obj;
+  idx->objs = obj;
+}
+
+void remove_obj_instance(struct obj_data *obj)
+{
+  if (obj->prev_instance)
+    obj->prev_instance->next_instance = obj->next_instance;
+  else if (GET_OBJ_RNUM(obj) != NOTHING && GET_OBJ_RNUM(obj) <= top_of_objt &&
+	   obj_index[GET_OBJ_RNUM(obj)].objs == obj)
+    obj_index[GET_OBJ_RNUM(obj)].objs = obj->next_instance;
+  if (obj->next_instance)
+    obj->next_instance->prev_instance = obj->prev_instance;
+  obj->prev_instance = obj->next_instance = NULL;
+}
+
+
+/* the newest object in the world with this object number, or NULL */
+struct obj_data *get_obj_num(obj_rnum nr)
+{
+  if (nr == NOTHING || nr > top_of_objt)
+    return (NULL);
+
+  return (obj_index[nr].objs);
 }
 
 
@@ -701,16 +890,13 @@ struct char_data *get_char_room(char *name, int *number, room_rnum room)
 
 
 
-/* search all over the world for a char num, and return a pointer if found */
+/* the newest mob in the world with this mob number, or NULL */
 struct char_data *get_char_num(mob_rnum nr)
 {
-  struct char_data *i;
-
-  for (i = character_list; i; i = i->next)
-    if (GET_MOB_RNUM(i) == nr)
-      return (i);
+  if (nr == NOBODY || nr > top_of_mobt)
+    return (NULL);
 
-  return (NULL);
+  return (mob_index[nr].mobs);
 }
 
 
@@ -724,8 +910,11 @@ void obj_to_room(struct obj_data *object, room_rnum room)
   else {
     object->next_content = world[room].contents;
     world[room].contents = object;
-    IN_ROOM(object) = room;
+    world[room].census.objs++;
+    OBJ_IN_ROOM(object) = room;
     object->carried_by = NULL;
+    if (SCRIPT_CHECK(object, OTRIG_COMMAND))
+      CMD_FILTER_DIRTY(world[room].cmd_filter);
     if (ROOM_FLAGGED(room, ROOM_HOUSE))
       SET_BIT(ROOM_FLAGS(room), ROOM_HOUSE_CRASH);
   }
@@ -737,17 +926,21 @@ void obj_from_room(struct obj_data *object)
 {
   struct obj_data *temp;
 
-  if (!object || IN_ROOM(object) == NOWHERE) {
+  if (!object || OBJ_IN_ROOM(object) == NOWHERE) {
     log("SYSERR: NULL object (%p) or obj not in a room (%d) passed to obj_from_room",
-	object, IN_ROOM(object));
+	object, OBJ_IN_ROOM(object));
     return;
   }
 
-  REMOVE_FROM_LIST(object, world[IN_ROOM(object)].contents, next_content);
+  REMOVE_FROM_LIST(object, world[OBJ_IN_ROOM(object)].contents, next_content);
+  world[OBJ_IN_ROOM(object)].census.objs--;
+
+  if (SCRIPT_CHECK(object, OTRIG_COMMAND))
+    CMD_FILTER_DIRTY(world[OBJ_IN_ROOM(object)].cmd_filter);
 
-  if (ROOM_FLAGGED(IN_ROOM(object), ROOM_HOUSE))
-    SET_BIT(ROOM_FLAGS(IN_ROOM(object)), ROOM_HOUSE_CRASH);
-  IN_ROOM(object) = NOWHERE;
+  if (ROOM_FLAGGED(OBJ_IN_ROOM(object), ROOM_HOUSE))
+    SET_BIT(ROOM_FLAGS(OBJ_IN_ROOM(object)), ROOM_HOUSE_CRASH);
+  OBJ_IN_ROOM(object) = NOWHERE;
   object->next_content = NULL;
 }
 
@@ -822,7 +1015,7 @@ void extract_obj(struct obj_data *obj)
   if (obj->worn_by != NULL)
     if (unequip_char(obj->worn_by, obj->worn_on) != obj)
       log("SYSERR: Inconsistent worn_by and worn_on pointers!!");
-  if (IN_ROOM(obj) != NOWHERE)
+  if (OBJ_IN_ROOM(obj) != NOWHERE)
     obj_from_room(obj);
   else if (obj->carried_by)
     obj_from_char(obj);
@@ -833,7 +1026,10 @@ void extract_obj(struct obj_data *obj)
   while (obj->contains)
     extract_obj(obj->contains);
 
+  script_sweep_remove_obj(obj);
+  obj_timer_clear(obj);
   REMOVE_FROM_LIST(obj, object_list, next);
+  remove_obj_instance(obj);
 
   if (GET_OBJ_RNUM(obj) != NOTHING)
     (obj_index[GET_OBJ_RNUM(obj)].number)--;
@@ -853,7 +1049,7 @@ void update_object(struct obj_data *obj, int use)
 {
   /* dont update objects with a timer trigger */
   if (!SCRIPT_CHECK(obj, OTRIG_TIMER) && (GET_OBJ_TIMER(obj) > 0))
-    GET_OBJ_TIMER(obj) -= use;
+    set_obj_timer(obj, GET_OBJ_TIMER(obj) - use);
   if (obj->contains)
     update_object(obj->contains, use);
   if (obj->next_content)
@@ -888,6 +1084,178 @@ void update_char_objects(struct char_data *ch)
 }
 
 
+/*
+ * Character references.  A struct char_ref names a character by its slot
+ * in a table plus the generation the slot had when the reference was
+ * taken.  When the character leaves the game, unref_char() bumps the
+ * generation, and every reference to it goes invalid at once without
+ * anyone having to hunt them down; deref_char() is a bounds check and a
+ * compare.  Slots are handed out the first time a reference is taken.
+ */
+struct char_slot {
+  struct char_data *ch;
+  unsigned int gen;
+  int next_free;
+};
+
+static struct char_slot *char_slots = NULL;
+static int num_char_slots = 0;		/* allocated			*/
+static int top_char_slot = 0;		/* highest ever handed out	*/
+static int free_char_slot = 0;		/* head of the free list, 0 = none */
+
+struct char_ref ref_char(struct char_data *ch)
+{
+  struct char_ref ref = { 0, 0 };
+  struct char_slot *s;
+  int slot;
+
+  if (!ch)
+    return (ref);
+
+  if (!(slot = ch->ref_slot)) {
+    if ((slot = free_char_slot) != 0)
+      free_char_slot = char_slots[slot].next_free;
+    else {
+      if (top_char_slot + 1 >= num_char_slots) {	/* slot 0 is never used */
+	num_char_slots = num_char_slots ? num_char_slots * 2 : 256;
+	RECREATE(char_slots, struct char_slot, num_char_slots);
+	memset(char_slots + top_char_slot + 1, 0,
+		sizeof(struct char_slot) * (num_char_slots - top_char_slot - 1));
+      }
+      slot = ++top_char_slot;
+      char_slots[slot].gen = 1;
+    }
+    char_slots[slot].ch = ch;
+    ch->ref_slot = slot;
+  }
+
+  s = &char_slots[slot];
+  ref.slot = slot;
+  ref.gen = s->gen;
+  return (ref);
+}
+
+/* the character a reference names, or NULL if it has left the game */
+struct char_data *deref_char(struct char_ref ref)
+{
+  if (ref.slot <= 0 || ref.slot > top_char_slot || char_slots[ref.slot].gen != ref.gen)
+    return (NULL);
+  return (char_slots[ref.slot].ch);
+}
+
+/* invalidate every reference to ch; called as it leaves the game */
+void unref_char(struct char_data *ch)
+{
+  struct char_slot *s;
+
+  if (!ch->ref_slot)
+    return;
+
+  s = &char_slots[ch->ref_slot];
+  s->ch = NULL;
+  if (++s->gen == 0)
+    s->gen = 1;
+  s->next_free = free_char_slot;
+  free_char_slot = ch->ref_slot;
+  ch->ref_slot = 0;
+}
+
+
+/*
+ * Hot fields.  What the sweeps over the characters look at every tick --
+ * where a character is, its position, hit points and mana, wait state and
+ * flags -- is kept outside struct char_data, in parallel arrays indexed by
+ * the character's hot slot (ch->hot).  A pass that only needs those reads
+ * a few dense arrays instead of pulling a whole char_data through the
+ * cache for each character; point_update() goes over the slots directly.
+ * IN_ROOM(), GET_POS(), GET_HIT() and the rest in utils.h hide this.
+ *
+ * clear_char() gives every character a slot, mob prototypes included, and
+ * free_char() gives it back.  A character must not be copied with '=':
+ * copy_char() copies one without sharing the slot.  hot_owner[] is only
+ * kept up for characters that are in a room.  Slot 0 is never used.
+ */
+room_rnum *hot_in_room = NULL;
+byte *hot_position = NULL;
+sh_int *hot_hit = NULL, *hot_mana = NULL;
+int *hot_wait = NULL;
+long *hot_act = NULL, *hot_affected_by = NULL;
+struct char_data **hot_owner = NULL;
+
+static int *hot_next_free = NULL;
+static int num_hot_slots = 0;		/* allocated			*/
+int top_hot_slot = 0;			/* highest ever handed out	*/
+static int free_hot_slot = 0;		/* head of the free list, 0 = none */
+
+void char_hot_alloc(struct char_data *ch)
+{
+  int slot;
+
+  if ((slot = free_hot_slot) != 0)
+    free_hot_slot = hot_next_free[slot];
+  else {
+    if (top_hot_slot + 1 >= num_hot_slots) {
+      num_hot_slots = num_hot_slots ? num_hot_slots * 2 : 1024;
+      RECREATE(hot_in_room, room_rnum, num_hot_slots);
+      RECREATE(hot_position, byte, num_hot_slots);
+      RECREATE(hot_hit, sh_int, num_hot_slots);
+      RECREATE(hot_mana, sh_int, num_hot_slots);
+      RECREATE(hot_wait, int, num_hot_slots);
+      RECREATE(hot_act, long, num_hot_slots);
+      RECREATE(hot_affected_by, long, num_hot_slots);
+      RECREATE(hot_owner, struct char_data *, num_hot_slots);
+      RECREATE(hot_next_free, int, num_hot_slots);
+      if (!top_hot_slot) {		/* what a slot of 0 reads	*/
+	hot_in_room[0] = NOWHERE;
+	hot_owner[0] = NULL;
+      }
+    }
+    slot = ++top_hot_slot;
+  }
+
+  ch->hot = slot;
+  hot_in_room[slot] = NOWHERE;
+  hot_position[slot] = POS_STANDING;
+  hot_hit[slot] = hot_mana[slot] = 0;
+  hot_wait[slot] = 0;
+  hot_act[slot] = hot_affected_by[slot] = 0;
+  hot_owner[slot] = ch;
+}
+
+void char_hot_free(struct char_data *ch)
+{
+  if (ch->hot <= 0)
+    return;
+
+  hot_in_room[ch->hot] = NOWHERE;
+  hot_owner[ch->hot] = NULL;
+  hot_next_free[ch->hot] = free_hot_slot;
+  free_hot_slot = ch->hot;
+  ch->hot = 0;
+}
+
+/* *to = *from, but 'to' keeps its own hot slot, or gets one */
+void copy_char(struct char_data *to, struct char_data *from)
+{
+  int slot = to->hot;
+
+  *to = *from;
+  to->hot = slot;
+  if (!to->hot)
+    char_hot_alloc(to);
+  else
+    hot_owner[to->hot] = to;
+
+  IN_ROOM(to) = IN_ROOM(from);
+  GET_POS(to) = GET_POS(from);
+  GET_HIT(to) = GET_HIT(from);
+  GET_MANA(to) = GET_MANA(from);
+  GET_WAIT_STATE(to) = GET_WAIT_STATE(from);
+  MOB_FLAGS(to) = MOB_FLAGS(from);
+  AFF_FLAGS(to) = AFF_FLAGS(from);
+}
+
+
 /* Extract a ch completely from the world, and leave his stuff behind */
 void extract_char_final(struct char_data *ch)
 {
@@ -970,14 +1338,14 @@ void extract_char_final(struct char_data *ch)
     if (FIGHTING(k) == ch)
       stop_fighting(k);
   }
-  /* we can't forget the hunters either... */
-  for (temp = character_list; temp; temp = temp->next)
-    if (HUNTING(temp) == ch)
-      HUNTING(temp) = NULL;
+  /* anyone hunting or otherwise holding on to ch loses the trail */
+  unref_char(ch);
 
   char_from_room(ch);
+  script_sweep_remove_char(ch);
 
   if (IS_NPC(ch)) {
+    remove_mob_instance(ch);
     if (GET_MOB_RNUM(ch) != NOTHING)	/* prototyped */
       mob_index[GET_MOB_RNUM(ch)].number--;
     clearMemory(ch);
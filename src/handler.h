@@ -18,6 +18,11 @@ bool	affected_by_spell(struct char_data *ch, int type);
 void	affect_join(struct char_data *ch, struct affected_type *af,
 bool add_dur, bool avg_dur, bool add_mod, bool avg_mod);
 
+/* when affects wear off, in magic.c */
+void	affect_wheel_add(struct char_data *ch, struct affected_type *af);
+void	affect_wheel_remove(struct affected_type *af);
+int	affect_duration(struct affected_type *af);
+
 
 /* utility */
 const char *money_desc(int amount);
@@ -48,13 +53,28 @@ void	extract_obj(struct obj_data *obj);
 
 struct char_data *get_char_room(char *name, int *num, room_rnum room);
 struct char_data *get_char_num(mob_rnum nr);
+void	add_mob_instance(struct char_data *mob);
+void	remove_mob_instance(struct char_data *mob);
+void	add_obj_instance(struct obj_data *obj);
+void	remove_obj_instance(struct obj_data *obj);
 
 void	char_from_room(struct char_data *ch);
 void	char_to_room(struct char_data *ch, room_rnum room);
+bitvector_t room_occupants(room_rnum room);
+void	room_census_dirty(room_rnum room);
+void	room_census_changed(void);
 void	extract_char(struct char_data *ch);
 void	extract_char_final(struct char_data *ch);
 void	extract_pending_chars(void);
 
+struct char_ref ref_char(struct char_data *ch);
+struct char_data *deref_char(struct char_ref ref);
+void	unref_char(struct char_data *ch);
+
+void	char_hot_alloc(struct char_data *ch);
+void	char_hot_free(struct char_data *ch);
+void	copy_char(struct char_data *to, struct char_data *from);
+
 /* find if character can see */
 struct char_data *get_player_vis(struct char_data *ch, char *name, int *number, int inroom);
 struct char_data *get_char_vis(struct char_data *ch, char *name, int *number, int where);
@@ -139,6 +139,7 @@ ACMD(do_not_here);
 ACMD(do_olc);
 ACMD(do_order);
 ACMD(do_page);
+ACMD(do_path);
 ACMD(do_pagelength);
 ACMD(do_peace);
 ACMD(do_pour);
@@ -410,6 +411,7 @@ cpp_extern const struct command_info cmd_info[] = {
   { "practice" , "pr"     , POS_RESTING , do_practice , 1, 0 },
   { "page"     , "pag"     , POS_DEAD    , do_page     , LVL_IMMORT, 0 },
   { "pagelength", "pagel"  , POS_DEAD   , do_pagelength, 0, 0 },
+  { "path"     , "path"    , POS_DEAD    , do_path     , LVL_IMMORT, 0 },
   { "pardon"   , "pardon"  , POS_DEAD    , do_wizutil  , LVL_GOD, SCMD_PARDON },
   { "policy"   , "pol"     , POS_DEAD    , do_gen_ps   , 0, SCMD_POLICIES },
   { "pour"     , "pour"    , POS_STANDING, do_pour     , 0, SCMD_POUR },
@@ -618,13 +620,8 @@ void command_interpreter(struct char_data *ch, char *argument)
    * here has been removed. 
    */
   /* otherwise, find the command */
-  {
-    int cont;                                            /* continue the command checks */
-    cont = command_wtrigger(ch, arg, line);              /* any world triggers ? */
-    if (!cont) cont = command_mtrigger(ch, arg, line);   /* any mobile triggers ? */
-    if (!cont) cont = command_otrigger(ch, arg, line);   /* any object triggers ? */
-    if (cont) return;                                    /* yes, command trigger took over */
-  }
+  if (command_trigger(ch, arg, line))   /* world, mobile or object triggers ? */
+    return;                             /* yes, command trigger took over */
           
   for (length = strlen(arg), cmd = 0; *complete_cmd_info[cmd].command != '\n'; cmd++) 
     if(complete_cmd_info[cmd].command_pointer != do_action && 
@@ -1409,7 +1406,7 @@ void nanny(struct descriptor_data *d, char *arg)
   switch (STATE(d)) {
   case CON_GET_NAME:		/* wait for input of name */
     if (d->character == NULL) {
-      CREATE(d->character, struct char_data, 1);
+      SLAB_CREATE(d->character, struct char_data, SLAB_CHAR);
       clear_char(d->character);
       CREATE(d->character->player_specials, struct player_special_data, 1);
       d->character->desc = d;
@@ -1443,7 +1440,7 @@ void nanny(struct descriptor_data *d, char *arg)
 	    write_to_output(d, "Invalid name, please try another.\r\nName: ");
 	    return;
 	  }
-	  CREATE(d->character, struct char_data, 1);
+	  SLAB_CREATE(d->character, struct char_data, SLAB_CHAR);
 	  clear_char(d->character);
 	  CREATE(d->character->player_specials, struct player_special_data, 1);
 	  d->character->desc = d;
@@ -20,6 +20,12 @@
 #include "interpreter.h"
 #include "dg_scripts.h"
 
+#ifdef __linux__		/* 'show sweep' counts cache misses */
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
+#endif
+
 /* local functions */
 int graf(int grafage, int p0, int p1, int p2, int p3, int p4, int p5, int p6);
 void run_autowiz(void);
@@ -30,6 +36,18 @@ char *title_male(int chclass, int level);
 char *title_female(int chclass, int level);
 void update_char_objects(struct char_data *ch);	/* handler.c */
 void reboot_wizlists(void);
+void char_catch_up(struct char_data *ch, int ticks);
+void run_held_obj_timer(struct obj_data *obj);
+void obj_timer_update(void);
+int affect_wheel_due(unsigned long hour);	/* magic.c */
+void timediff(struct timeval *diff, struct timeval *a, struct timeval *b);
+static void obj_timer_expire(struct obj_data *j);
+
+extern unsigned long affect_wheel_entries, affect_wheel_expired;
+extern struct char_data **hot_owner;
+extern int top_hot_slot;
+
+unsigned long timer_hours = 0;	/* MUD hours the game has been up */
 
 /* When age < 15 return the value p0 */
 /* When age in 15..29 calculate the line between p1 & p2 */
@@ -339,18 +357,26 @@ void check_idling(struct char_data *ch)
 /* Update PCs, NPCs, and objects */
 void point_update(void)
 {
-  struct char_data *i, *next_char;
-  struct obj_data *j, *next_thing, *jj, *next_thing2;
+  struct char_data *i;
+  int slot, top = top_hot_slot;
+
+  /*
+   * characters: go over the hot slots (see handler.c) instead of
+   * character_list, so those that are nowhere or in a hibernating room
+   * are passed over without touching them.  Slots are only given back
+   * by extract_pending_chars(), so none is reused while this runs.
+   */
+  for (slot = 1; slot <= top; slot++) {
+    if (hot_in_room[slot] == NOWHERE || ROOM_HIBERNATING(hot_in_room[slot]))
+      continue;
+    i = hot_owner[slot];
 
-  /* characters */
-  for (i = character_list; i; i = next_char) {
-    next_char = i->next;
-	
     gain_condition(i, DRUNK, -1);
 	
     if (GET_POS(i) >= POS_STUNNED) {
       GET_HIT(i) = MIN(GET_HIT(i) + hit_gain(i), GET_MAX_HIT(i));
       GET_MANA(i) = MIN(GET_MANA(i) + mana_gain(i), GET_MAX_MANA(i));
+      GMCP_DIRTY(i, GMCP_VITALS);
       if (AFF_FLAGGED(i, AFF_POISON) || AFF_FLAGGED(i, AFF_BLEED))
         if (damage(i, i, 2, SPELL_POISON) == -1)
           continue;	/* Oops, they died. -gg 6/24/98 */
@@ -370,48 +396,414 @@ void point_update(void)
     }
   }
 
-  /* objects */
-  for (j = object_list; j; j = next_thing) {
-    next_thing = j->next;	/* Next in object list */
-
-    /* If this is a corpse */
-    if (IS_CORPSE(j)) {
-      /* timer count down */
-      if (GET_OBJ_TIMER(j) > 0)
-	GET_OBJ_TIMER(j)--;
-
-      if (!GET_OBJ_TIMER(j)) {
-
-	if (j->carried_by)
-	  act("$p decays in your hands.", FALSE, j->carried_by, j, 0, TO_CHAR);
-	else if ((IN_ROOM(j) != NOWHERE) && (world[IN_ROOM(j)].people)) {
-	  act("A quivering horde of maggots consumes $p.",
-	      TRUE, world[IN_ROOM(j)].people, j, 0, TO_ROOM);
-	  act("A quivering horde of maggots consumes $p.",
-	      TRUE, world[IN_ROOM(j)].people, j, 0, TO_CHAR);
-	}
-	for (jj = j->contains; jj; jj = next_thing2) {
-	  next_thing2 = jj->next_content;	/* Next in inventory */
-	  obj_from_obj(jj);
-
-	  if (j->in_obj)
-	    obj_to_obj(jj, j->in_obj);
-	  else if (j->carried_by)
-	    obj_to_room(jj, IN_ROOM(j->carried_by));
-	  else if (IN_ROOM(j) != NOWHERE)
-	    obj_to_room(jj, IN_ROOM(j));
-	  else
-	    core_dump();
-	}
-	extract_obj(j);
-      }
+  obj_timer_update();
+}
+
+
+/*
+ * 'show sweep' times the two ways of going over every character in a room
+ * and reading what point_update() reads: following character_list, and
+ * scanning the hot slots.  Scratch characters, linked in a shuffled order
+ * the way a list that has been running for a while is, are put in random
+ * rooms (not on the rooms' people lists) to give both something to chew
+ * on.  Where the kernel lets us, the cache misses of each are counted too.
+ */
+#define SWEEP_PASSES	5
+
+static int sweep_counter_open(void)
+{
+#if defined(__linux__) && defined(__NR_perf_event_open)
+  struct perf_event_attr pe;
+
+  memset(&pe, 0, sizeof(pe));
+  pe.type = PERF_TYPE_HARDWARE;
+  pe.size = sizeof(pe);
+  pe.config = PERF_COUNT_HW_CACHE_MISSES;
+  pe.disabled = 1;
+  pe.exclude_kernel = 1;
+  pe.exclude_hv = 1;
+  return (syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0));
+#else
+  errno = ENOSYS;
+  return (-1);
+#endif
+}
+
+static void sweep_counter_start(int fd)
+{
+#if defined(__linux__) && defined(__NR_perf_event_open)
+  if (fd >= 0) {
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+#endif
+}
+
+static long long sweep_counter_stop(int fd)
+{
+  long long count = 0;
+
+#if defined(__linux__) && defined(__NR_perf_event_open)
+  if (fd >= 0) {
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &count, sizeof(count)) != sizeof(count))
+      count = 0;
+  }
+#endif
+  return (count);
+}
+
+/* what point_update() looks at before it does anything to a character */
+#define SWEEP_SUM(sum, ch)	do { \
+	if (!ROOM_HIBERNATING(IN_ROOM(ch)) && GET_POS(ch) >= POS_STUNNED) \
+	  (sum) += GET_HIT(ch) + GET_MANA(ch) + GET_WAIT_STATE(ch) + \
+		(AFF_FLAGS(ch) & (AFF_POISON | AFF_BLEED) ? 1 : 0); } while (0)
+
+static void sweep_bench(struct char_data *ch, int count)
+{
+  struct char_data **scratch, *list = NULL, *i;
+  struct timeval before, after, spent;
+  unsigned long usecs[2] = { 0, 0 }, sum[2] = { 0, 0 };
+  long long misses[2] = { 0, 0 };
+  const char *pass_names[2] = { "character_list", "hot slots" };
+  int n, j, pass, fd, in_game = 0, slot, top;
+
+  if (top_of_world < 0)
+    return;
+
+  CREATE(scratch, struct char_data *, count);
+  for (n = 0; n < count; n++) {
+    SLAB_CREATE(scratch[n], struct char_data, SLAB_CHAR);
+    clear_char(scratch[n]);
+    SET_BIT(MOB_FLAGS(scratch[n]), MOB_ISNPC);
+    scratch[n]->player_specials = &dummy_mob;
+    IN_ROOM(scratch[n]) = rand_number(0, top_of_world);
+    GET_POS(scratch[n]) = rand_number(POS_DEAD, POS_STANDING);
+    GET_HIT(scratch[n]) = rand_number(1, 100);
+    GET_MANA(scratch[n]) = rand_number(1, 100);
+  }
+  for (n = count - 1; n > 0; n--) {
+    j = rand_number(0, n);
+    i = scratch[n];
+    scratch[n] = scratch[j];
+    scratch[j] = i;
+  }
+  for (n = 0; n < count; n++) {
+    scratch[n]->next = list;
+    list = scratch[n];
+  }
+  for (i = character_list; i; i = i->next)
+    if (IN_ROOM(i) != NOWHERE)
+      in_game++;
+
+  if ((fd = sweep_counter_open()) < 0)
+    send_to_char(ch, "Cache misses can't be counted here (perf_event_open: %s).\r\n", strerror(errno));
+
+  for (pass = 0; pass < SWEEP_PASSES * 2; pass++) {
+    sweep_counter_start(fd);
+    gettimeofday(&before, (struct timezone *) 0);
+    if (pass % 2 == 0) {
+      for (i = list; i; i = i->next)
+	SWEEP_SUM(sum[0], i);
+      for (i = character_list; i; i = i->next)
+	if (IN_ROOM(i) != NOWHERE)
+	  SWEEP_SUM(sum[0], i);
+    } else {
+      for (slot = 1, top = top_hot_slot; slot <= top; slot++)
+	if (hot_in_room[slot] != NOWHERE && !ROOM_HIBERNATING(hot_in_room[slot]) &&
+		hot_position[slot] >= POS_STUNNED)
+	  sum[1] += hot_hit[slot] + hot_mana[slot] + hot_wait[slot] +
+		(hot_affected_by[slot] & (AFF_POISON | AFF_BLEED) ? 1 : 0);
+    }
+    gettimeofday(&after, (struct timezone *) 0);
+    misses[pass % 2] += sweep_counter_stop(fd);
+    timediff(&spent, &after, &before);
+    usecs[pass % 2] += spent.tv_sec * 1000000 + spent.tv_usec;
+  }
+  if (fd >= 0)
+    close(fd);
+
+  for (n = 0; n < count; n++) {
+    IN_ROOM(scratch[n]) = NOWHERE;
+    free_char(scratch[n]);
+  }
+  free(scratch);
+
+  send_to_char(ch,
+	"%d scratch characters and %d in the game, %d passes each.\r\n"
+	"A struct char_data is %d bytes; its hot slot is %d.\r\n"
+	"                 usecs/pass  misses/pass  checksum\r\n",
+	count, in_game, SWEEP_PASSES, (int) sizeof(struct char_data),
+	(int) (sizeof(room_rnum) + sizeof(byte) + 2 * sizeof(sh_int) + sizeof(int) +
+		2 * sizeof(long) + sizeof(struct char_data *)));
+  for (pass = 0; pass < 2; pass++) {
+    if (fd >= 0)
+      send_to_char(ch, "%-16s %10lu %12lld %9lu\r\n", pass_names[pass],
+	usecs[pass] / SWEEP_PASSES, misses[pass] / SWEEP_PASSES, sum[pass] / SWEEP_PASSES);
+    else
+      send_to_char(ch, "%-16s %10lu %12s %9lu\r\n", pass_names[pass],
+	usecs[pass] / SWEEP_PASSES, "n/a", sum[pass] / SWEEP_PASSES);
+  }
+}
+
+/* show sweep [<characters>] */
+void sweep_report(struct char_data *ch, char *value, char *arg)
+{
+  sweep_bench(ch, *value && is_number(value) ? MIN(MAX(atoi(value), 1), 200000) : 20000);
+}
+
+
+/*
+ * Object timers run out on a timer wheel, like affects (see magic.c):
+ * an object whose timer runs out at timer_hours H is kept in list
+ * H % OBJ_WHEEL_SLOTS, and point_update() only looks at this hour's list.
+ * GET_OBJ_TIMER() works the hours left out from obj->timer_due, and
+ * everything that sets a timer goes through set_obj_timer().
+ */
+#define OBJ_WHEEL_SLOTS		256
+#define OBJ_TIMER_HELD		((unsigned long) -1)
+
+static struct obj_data *obj_wheel[OBJ_WHEEL_SLOTS];
+static unsigned long obj_wheel_entries = 0;	/* timers running	*/
+static unsigned long obj_timers_run = 0;	/* timers run out, ever	*/
+static unsigned long obj_timers_held = 0;	/* waiting for a zone	*/
+
+static void obj_wheel_link(struct obj_data **head, struct obj_data *obj)
+{
+  if ((obj->timer_next = *head) != NULL)
+    obj->timer_next->timer_pprev = &obj->timer_next;
+  obj->timer_pprev = head;
+  *head = obj;
+}
+
+static void obj_wheel_unlink(struct obj_data *obj)
+{
+  if ((*obj->timer_pprev = obj->timer_next) != NULL)
+    obj->timer_next->timer_pprev = obj->timer_pprev;
+  obj->timer_next = NULL;
+  obj->timer_pprev = NULL;
+}
+
+/* stops obj's timer, if it has one running; extract_obj() calls this */
+void obj_timer_clear(struct obj_data *obj)
+{
+  if (obj->timer_pprev) {
+    obj_wheel_unlink(obj);
+    obj_wheel_entries--;
+  } else if (obj->timer_due == OBJ_TIMER_HELD)
+    obj_timers_held--;
+  obj->timer_due = 0;
+}
+
+/*
+ * Starts obj's timer running out in 'hours'.  Corpses decay however
+ * little is left, at the next hour if nothing is; other objects only
+ * time out if there is something on the timer.
+ */
+void set_obj_timer(struct obj_data *obj, int hours)
+{
+  obj_timer_clear(obj);
+  obj->obj_flags.timer = hours;
+
+  if (hours <= 0 && !IS_CORPSE(obj))
+    return;
+  obj->timer_due = timer_hours + MAX(hours, 1);
+  obj_wheel_link(&obj_wheel[obj->timer_due % OBJ_WHEEL_SLOTS], obj);
+  obj_wheel_entries++;
+}
+
+/* GET_OBJ_TIMER(): hours left, or what was set if the timer isn't running */
+int obj_timer_left(struct obj_data *obj)
+{
+  if (obj->timer_due == OBJ_TIMER_HELD)
+    return (0);
+  if (!obj->timer_due)
+    return (obj->obj_flags.timer);
+  return ((int) (obj->timer_due - timer_hours));
+}
+
+/* run out this hour's timers; called from point_update() */
+void obj_timer_update(void)
+{
+  struct obj_data *obj, *firing;
+  int slot = timer_hours % OBJ_WHEEL_SLOTS;
+
+  /* as affect_update() does, in case a timer takes others out with it */
+  if ((firing = obj_wheel[slot]) != NULL)
+    firing->timer_pprev = &firing;
+  obj_wheel[slot] = NULL;
+
+  while ((obj = firing) != NULL) {
+    obj_wheel_unlink(obj);
+    if (obj->timer_due != timer_hours) {	/* a lap or more to go */
+      obj_wheel_link(&obj_wheel[slot], obj);
+      continue;
     }
-    /* If the timer is set, count it down and at 0, try the trigger */
-    /* note to .rej hand-patchers: make this last in your point-update() */
-    else if (GET_OBJ_TIMER(j)>0) {
-      GET_OBJ_TIMER(j)--; 
-      if (!GET_OBJ_TIMER(j))
-        timer_otrigger(j);
+    obj_wheel_entries--;
+    obj->timer_due = 0;
+    obj->obj_flags.timer = 0;
+    obj_timer_expire(obj);
+  }
+}
+
+
+/*
+ * An object's timer has run out: corpses decay and other objects fire
+ * their timer triggers.  Triggers in a hibernating zone wait for
+ * wake_zone() to call run_held_obj_timer().
+ */
+static void obj_timer_expire(struct obj_data *j)
+{
+  struct obj_data *jj, *next_thing2;
+
+  /* If this is a corpse */
+  if (IS_CORPSE(j)) {
+    if (j->carried_by)
+      act("$p decays in your hands.", FALSE, j->carried_by, j, 0, TO_CHAR);
+    else if ((OBJ_IN_ROOM(j) != NOWHERE) && (world[OBJ_IN_ROOM(j)].people)) {
+      act("A quivering horde of maggots consumes $p.",
+	  TRUE, world[OBJ_IN_ROOM(j)].people, j, 0, TO_ROOM);
+      act("A quivering horde of maggots consumes $p.",
+	  TRUE, world[OBJ_IN_ROOM(j)].people, j, 0, TO_CHAR);
+    }
+    for (jj = j->contains; jj; jj = next_thing2) {
+      next_thing2 = jj->next_content;	/* Next in inventory */
+      obj_from_obj(jj);
+
+      if (j->in_obj)
+	obj_to_obj(jj, j->in_obj);
+      else if (j->carried_by)
+	obj_to_room(jj, IN_ROOM(j->carried_by));
+      else if (OBJ_IN_ROOM(j) != NOWHERE)
+	obj_to_room(jj, OBJ_IN_ROOM(j));
+      else
+	core_dump();
     }
+    extract_obj(j);
+  } else if (ROOM_HIBERNATING(obj_room(j)) && SCRIPT_CHECK(j, OTRIG_TIMER)) {
+    j->timer_due = OBJ_TIMER_HELD;
+    obj_timers_held++;
+  } else {
+    obj_timers_run++;
+    timer_otrigger(j);
+  }
+}
+
+void run_held_obj_timer(struct obj_data *obj)
+{
+  if (obj->timer_due != OBJ_TIMER_HELD)
+    return;
+  obj->timer_due = 0;
+  obj_timers_held--;
+  obj_timers_run++;
+  timer_otrigger(obj);
+}
+
+
+/*
+ * show timers bench [<chars>] - put two affects each on <chars> copies
+ * of a mob (10000 by default), lasting from 0 to 47 hours, and time
+ * finding what wears off in each of the next TIMER_BENCH_HOURS hours:
+ * by walking every character's affects, as affect_update() did, and by
+ * looking in the wheel.  Taking off what is found costs the same either
+ * way, so nothing is taken off; the mobs go when the bench is done.
+ */
+#define TIMER_BENCH_HOURS	48
+
+static void timer_bench(struct char_data *ch, int count)
+{
+  struct char_data **mobs, *k;
+  struct affected_type af, *a;
+  struct timeval before, after, spent;
+  unsigned long sweep_usecs, wheel_usecs, sweep_seen = 0;
+  int sweep_due = 0, wheel_due = 0, i, h;
+  mob_rnum rnum;
+  room_rnum room;
+
+  /* a plain mob, one without scripts or a special procedure */
+  for (rnum = 0; rnum <= top_of_mobt; rnum++)
+    if (!mob_proto[rnum].proto_script && !mob_index[rnum].func)
+      break;
+  for (room = 0; room <= top_of_world; room++)
+    if (!world[room].people)
+      break;
+  if (rnum > top_of_mobt || room > top_of_world) {
+    send_to_char(ch, "There is no plain mob or empty room to use.\r\n");
+    return;
+  }
+
+  memset(&af, 0, sizeof(af));
+  af.type = SPELL_ARMOR;
+  af.location = APPLY_NONE;
+  CREATE(mobs, struct char_data *, count);
+  for (i = 0; i < count; i++) {
+    mobs[i] = read_mobile(rnum, REAL);
+    char_to_room(mobs[i], room);
+    af.duration = i % TIMER_BENCH_HOURS;
+    affect_to_char(mobs[i], &af);
+    af.duration = (i * 7) % TIMER_BENCH_HOURS;
+    affect_to_char(mobs[i], &af);
+  }
+
+  gettimeofday(&before, (struct timezone *) 0);
+  for (h = 1; h <= TIMER_BENCH_HOURS; h++)
+    for (k = character_list; k; k = k->next)
+      for (a = k->affected; a; a = a->next) {
+        sweep_seen++;
+        if (a->expires == timer_hours + h)
+          sweep_due++;
+      }
+  gettimeofday(&after, (struct timezone *) 0);
+  timediff(&spent, &after, &before);
+  sweep_usecs = spent.tv_sec * 1000000 + spent.tv_usec;
+
+  gettimeofday(&before, (struct timezone *) 0);
+  for (h = 1; h <= TIMER_BENCH_HOURS; h++)
+    wheel_due += affect_wheel_due(timer_hours + h);
+  gettimeofday(&after, (struct timezone *) 0);
+  timediff(&spent, &after, &before);
+  wheel_usecs = spent.tv_sec * 1000000 + spent.tv_usec;
+
+  for (i = 0; i < count; i++)
+    extract_char(mobs[i]);
+  free(mobs);
+
+  send_to_char(ch, "%d mobs with two affects each, %d hours:\r\n"
+	"         usecs  usecs/hour  affects/hour  wearing off\r\n"
+	"Sweep %8lu %11lu %13lu %12d\r\n"
+	"Wheel %8lu %11lu %13lu %12d\r\n", count, TIMER_BENCH_HOURS,
+	sweep_usecs, sweep_usecs / TIMER_BENCH_HOURS,
+	sweep_seen / TIMER_BENCH_HOURS, sweep_due,
+	wheel_usecs, wheel_usecs / TIMER_BENCH_HOURS,
+	(unsigned long) wheel_due / TIMER_BENCH_HOURS, wheel_due);
+}
+
+/* show timers [bench [<chars>]] */
+void timer_report(struct char_data *ch, char *value, char *arg)
+{
+  if (*value && is_abbrev(value, "bench")) {
+    skip_spaces(&arg);
+    timer_bench(ch, *arg && is_number(arg) ? MIN(MAX(atoi(arg), 1), 100000) : 10000);
+    return;
+  }
+
+  send_to_char(ch, "Hour %lu.\r\n"
+	"Affects:       %8lu running, %10lu worn off.\r\n"
+	"Object timers: %8lu running, %10lu run out, %lu waiting for a zone to wake.\r\n",
+	timer_hours, affect_wheel_entries, affect_wheel_expired,
+	obj_wheel_entries, obj_timers_run, obj_timers_held);
+}
+
+
+/*
+ * Catches a mob in a waking zone up on the hours it slept through: it
+ * heals as it would have.  Its affects wore off on time, poison and
+ * bleeding with them, but those didn't hurt it while nobody was about.
+ */
+void char_catch_up(struct char_data *ch, int ticks)
+{
+  if (GET_POS(ch) >= POS_STUNNED) {
+    GET_HIT(ch) = MIN(GET_HIT(ch) + ticks * hit_gain(ch), GET_MAX_HIT(ch));
+    GET_MANA(ch) = MIN(GET_MANA(ch) + ticks * mana_gain(ch), GET_MAX_MANA(ch));
   }
 }
@@ -25,6 +25,7 @@
 /* external variables */
 extern int mini_mud;
 extern struct spell_info_type spell_info[];
+extern unsigned long timer_hours;
 
 /* external functions */
 byte saving_throws(int class_num, int type, int level); /* class.c */
@@ -71,36 +72,131 @@ int mag_savingthrow(struct char_data *ch, int type, int modifier)
 }
 
 
+/*
+ * Affects that wear off are kept in a timer wheel: an array of lists,
+ * one per hour, where an affect that wears off at timer_hours H sits in
+ * list H % AFFECT_WHEEL_SLOTS.  Each hour affect_update() looks at one
+ * list instead of every affect on every character, and leaves alone the
+ * few in it due a lap or more later.  af->duration keeps what the affect
+ * was given; affect_duration() says how long it has left.
+ */
+#define AFFECT_WHEEL_SLOTS	256
+
+static struct affected_type *affect_wheel[AFFECT_WHEEL_SLOTS];
+unsigned long affect_wheel_entries = 0;		/* affects in the wheel	*/
+unsigned long affect_wheel_expired = 0;		/* worn off, ever	*/
+
+static void affect_wheel_link(struct affected_type **head, struct affected_type *af)
+{
+  if ((af->wheel_next = *head) != NULL)
+    af->wheel_next->wheel_pprev = &af->wheel_next;
+  af->wheel_pprev = head;
+  *head = af;
+}
+
+static void affect_wheel_unlink(struct affected_type *af)
+{
+  if ((*af->wheel_pprev = af->wheel_next) != NULL)
+    af->wheel_next->wheel_pprev = af->wheel_pprev;
+  af->wheel_next = NULL;
+  af->wheel_pprev = NULL;
+}
+
+/* called by affect_to_char() for the copy it has just put on ch */
+void affect_wheel_add(struct char_data *ch, struct affected_type *af)
+{
+  af->holder = ch;
+  af->wheel_next = NULL;
+  af->wheel_pprev = NULL;
+
+  if (af->duration < 0) {	/* GODs only! unlimited */
+    af->expires = 0;
+    return;
+  }
+  /* it used to count down to 0 and wear off the hour after */
+  af->expires = timer_hours + af->duration + 1;
+  affect_wheel_link(&affect_wheel[af->expires % AFFECT_WHEEL_SLOTS], af);
+  affect_wheel_entries++;
+}
+
+/* called by affect_remove() */
+void affect_wheel_remove(struct affected_type *af)
+{
+  if (!af->wheel_pprev)
+    return;
+  affect_wheel_unlink(af);
+  affect_wheel_entries--;
+}
+
+/* hours left before af wears off, as af->duration used to count them */
+int affect_duration(struct affected_type *af)
+{
+  if (!af->expires)
+    return (-1);
+  return (MAX(0, (int) (af->expires - timer_hours) - 1));
+}
+
+/* how many affects wear off at 'hour'; for the timer bench */
+int affect_wheel_due(unsigned long hour)
+{
+  struct affected_type *af;
+  int due = 0;
+
+  for (af = affect_wheel[hour % AFFECT_WHEEL_SLOTS]; af; af = af->wheel_next)
+    if (af->expires == hour)
+      due++;
+  return (due);
+}
+
+static void affect_wear_off(struct char_data *i, struct affected_type *af)
+{
+  struct affected_type fatigue;
+  int type = af->type;
+
+  /* one message for spells of several parts, when the last part goes */
+  if ((af->type > 0) && (af->type <= MAX_SPELLS))
+    if (!af->next || (af->next->type != af->type) ||
+	(af->next->expires > timer_hours))
+      if (spell_info[af->type].wear_off_msg)
+        send_to_char(i, "%s\r\n", spell_info[af->type].wear_off_msg);
+  affect_remove(i, af);
+  affect_wheel_expired++;
+
+  /** Add Fatigue if coming down from berserk */
+  if (type == SKILL_BERSERK) { //|| af->type == adrenaline shot){
+    memset(&fatigue, 0, sizeof(fatigue));
+    fatigue.type = 1;
+    fatigue.duration = 10;
+    fatigue.modifier = -10;
+    fatigue.location = APPLY_EVASION;        //APPLY_NONE?
+    fatigue.bitvector = AFF_FATIGUED;
+    affect_to_char(i, &fatigue);
+  }
+}
+
 /* affect_update: called from comm.c (causes spells to wear off) */
 void affect_update(void)
 {
-  struct affected_type *af, *next;
-  struct char_data *i;
-
-  for (i = character_list; i; i = i->next) {
-    for (af = i->affected; af; af = next) {
-      next = af->next;
-      if (af->duration >= 1)
-        af->duration--;
-      else if (af->duration == -1)	/* No action */
-        af->duration = -1;	/* GODs only! unlimited */
-      else {
-        if ((af->type > 0) && (af->type <= MAX_SPELLS))
-          if (!af->next || (af->next->type != af->type) || (af->next->duration > 0))
-            if (spell_info[af->type].wear_off_msg)
-              send_to_char(i, "%s\r\n", spell_info[af->type].wear_off_msg);
-        affect_remove(i, af);
-        /** Add Fatigue if coming down from berserk */
-        if(af->type == SKILL_BERSERK){ //|| af->type == adrenaline shot){
-          af->type = 1; //Banankick: not sure if this works.
-          af->duration = 10;
-          af->modifier = -10;
-          af->location = APPLY_EVASION;        //APPLY_NONE?
-          af->bitvector = AFF_FATIGUED;
-          affect_to_char(i, &af);
-        }
-      }
+  struct affected_type *af, *firing;
+  int slot = timer_hours % AFFECT_WHEEL_SLOTS;
+
+  /*
+   * Take the hour's list off the wheel first: wearing one affect off can
+   * take others with it, and puts fatigue back on.  What is taken out
+   * unlinks itself from 'firing' as it would from the wheel.
+   */
+  if ((firing = affect_wheel[slot]) != NULL)
+    firing->wheel_pprev = &firing;
+  affect_wheel[slot] = NULL;
+
+  while ((af = firing) != NULL) {
+    affect_wheel_unlink(af);
+    if (af->expires != timer_hours) {	/* a lap or more to go */
+      affect_wheel_link(&affect_wheel[slot], af);
+      continue;
     }
+    affect_wheel_entries--;
+    affect_wear_off(af->holder, af);
   }
 }
 
@@ -824,6 +920,7 @@ void mag_points(int level, struct char_data *ch, struct char_data *victim,
     break;
   }
   GET_HIT(victim) = MIN(GET_MAX_HIT(victim), GET_HIT(victim) + healing);
+  gmcp_hit_changed(victim);
   update_pos(victim);
 }
 
@@ -168,7 +168,7 @@ mudlog(BRF, LVL_IMPL, TRUE, "OLC: %s tried to edit zone %d allowed zone %d",
     /**************************************************************************/
     /** Save the mobiles.                                                    **/
     /**************************************************************************/
-    save_mobiles(OLC_ZNUM(d));
+    queue_olc_save(OLC_ZNUM(d), SL_MOB);
     
     /**************************************************************************/
     /** Free the olc structure stored in the descriptor.                     **/
@@ -204,7 +204,7 @@ mudlog(BRF, LVL_IMPL, TRUE, "OLC: %s tried to edit zone %d allowed zone %d",
 
 void medit_save_to_disk(zone_vnum foo)
 {
-  save_mobiles(real_zone(foo));
+  queue_olc_save(real_zone(foo), SL_MOB);
 }
 
 void medit_setup_new(struct descriptor_data *d)
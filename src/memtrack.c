@@ -0,0 +1,291 @@
+/* ************************************************************************
+*   File: memtrack.c                                    Part of CircleMUD *
+*  Usage: sampling allocation tracker behind CREATE, RECREATE and free    *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+*                                                                         *
+*  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+*  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+************************************************************************ */
+
+/*
+ * CREATE, RECREATE, strdup() and free() all pass through here (see the
+ * memory utils in utils.h).  Every call site, a file and line, has a
+ * record counting the calls and bytes asked for there.  CREATE and
+ * RECREATE look their record up once and keep it in a static pointer;
+ * strdup() looks it up in a hash table each time.
+ *
+ * Live memory is estimated by sampling rather than by tracking every
+ * block: about once every CONFIG_MEM_SAMPLE_RATE bytes allocated, the
+ * allocation is remembered in a table keyed by address and charged to
+ * its site as MAX(size, rate) bytes until it is freed.  So an unsampled
+ * allocation costs a few counter updates and a free one hash probe,
+ * cheap enough to leave on all the time.  A sample rate of 0 turns the
+ * sampling off and leaves only the per-site counters.
+ */
+
+#include "conf.h"
+#include "sysdep.h"
+
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "interpreter.h"
+#include "db.h"
+
+/* this file hands out the real memory, so it mustn't go through itself */
+#undef free
+#undef strdup
+
+#define SITE_HASH_SIZE		1024
+#define SAMPLE_HASH_SIZE	4096
+
+struct alloc_site {
+  const char *file;
+  int line;
+  unsigned long calls;		/* allocations made here		*/
+  unsigned long bytes;		/* bytes asked for here, ever		*/
+  unsigned long live_samples;	/* sampled blocks not yet freed		*/
+  unsigned long live_bytes;	/* bytes those samples stand for	*/
+  struct alloc_site *next;
+};
+
+struct alloc_sample {
+  void *ptr;
+  unsigned long weight;		/* bytes this sample stands for		*/
+  struct alloc_site *site;
+  struct alloc_sample *next;
+};
+
+static struct alloc_site *site_hash[SITE_HASH_SIZE];
+static struct alloc_sample *sample_hash[SAMPLE_HASH_SIZE];
+static struct alloc_sample *spare_samples;
+static int num_sites = 0;
+
+static long sample_left = 0;		/* bytes until the next sample	*/
+static unsigned long sample_seed = 1;
+unsigned long mem_live_samples = 0;	/* checked by mem_untrack()	*/
+
+#define SAMPLE_BUCKET(p) \
+	((((unsigned long) (p)) >> 4) % SAMPLE_HASH_SIZE)
+
+static int site_bucket(const char *file, int line)
+{
+  unsigned long h = line;
+  const char *p;
+
+  /* hash the name, not the pointer; one file may have several copies */
+  for (p = file; *p; p++)
+    h = h * 31 + (unsigned char) *p;
+  return (h % SITE_HASH_SIZE);
+}
+
+static struct alloc_site *mem_site(const char *file, int line)
+{
+  struct alloc_site *site;
+  int b = site_bucket(file, line);
+
+  for (site = site_hash[b]; site; site = site->next)
+    if (site->line == line && (site->file == file || !strcmp(site->file, file)))
+      return (site);
+
+  if (!(site = (struct alloc_site *) calloc(1, sizeof(struct alloc_site)))) {
+    perror("SYSERR: mem_site");
+    abort();
+  }
+  site->file = file;
+  site->line = line;
+  site->next = site_hash[b];
+  site_hash[b] = site;
+  num_sites++;
+
+  return (site);
+}
+
+/*
+ * Distance to the next sample, spread between half and one and a half
+ * times the rate so periodic allocation patterns are not always missed.
+ * Uses its own generator to leave the game's random numbers alone.
+ */
+static long next_sample_distance(int rate)
+{
+  sample_seed = sample_seed * 1103515245 + 12345;
+  return (rate / 2 + (long) ((sample_seed >> 16) % (rate + 1)));
+}
+
+static void mem_sample(void *ptr, size_t size, struct alloc_site *site)
+{
+  struct alloc_sample *s;
+  int b = SAMPLE_BUCKET(ptr);
+
+  if ((s = spare_samples) != NULL)
+    spare_samples = s->next;
+  else if (!(s = (struct alloc_sample *) malloc(sizeof(struct alloc_sample))))
+    return;	/* out of memory; just don't sample it */
+
+  s->ptr = ptr;
+  s->weight = MAX(size, CONFIG_MEM_SAMPLE_RATE);
+  s->site = site;
+  s->next = sample_hash[b];
+  sample_hash[b] = s;
+
+  site->live_samples++;
+  site->live_bytes += s->weight;
+  mem_live_samples++;
+}
+
+/* count an allocation against its site, and maybe sample it */
+void mem_track(void *ptr, size_t size, struct alloc_site **cache,
+	       const char *file, int line)
+{
+  struct alloc_site *site;
+  int rate = CONFIG_MEM_SAMPLE_RATE;
+
+  if (!(site = *cache))
+    site = *cache = mem_site(file, line);
+
+  site->calls++;
+  site->bytes += size;
+
+  if (rate <= 0 || (sample_left -= (long) size) > 0)
+    return;
+
+  sample_left = next_sample_distance(rate);
+  mem_sample(ptr, size, site);
+}
+
+/* forget ptr if it was sampled; called before it is freed or moved */
+void mem_untrack(void *ptr)
+{
+  struct alloc_sample *s, *prev = NULL;
+  int b;
+
+  if (!ptr || !mem_live_samples)
+    return;
+
+  b = SAMPLE_BUCKET(ptr);
+  for (s = sample_hash[b]; s; prev = s, s = s->next)
+    if (s->ptr == ptr)
+      break;
+  if (!s)
+    return;
+
+  if (prev)
+    prev->next = s->next;
+  else
+    sample_hash[b] = s->next;
+
+  s->site->live_samples--;
+  s->site->live_bytes -= s->weight;
+  mem_live_samples--;
+
+  s->next = spare_samples;
+  spare_samples = s;
+}
+
+void mem_track_free(void *ptr)
+{
+  mem_untrack(ptr);
+  free(ptr);
+}
+
+char *mem_track_strdup(const char *str, const char *file, int line)
+{
+  struct alloc_site *site = NULL;
+  size_t len = strlen(str) + 1;
+  char *copy;
+
+  if (!(copy = (char *) malloc(len))) {
+    perror("SYSERR: strdup failure");
+    abort();
+  }
+  memcpy(copy, str, len);
+
+  mem_track(copy, len, &site, file, line);
+  return (copy);
+}
+
+/* largest estimated live bytes first, then the busiest sites */
+static int site_compare(const void *a, const void *b)
+{
+  const struct alloc_site *sa = *(struct alloc_site * const *) a;
+  const struct alloc_site *sb = *(struct alloc_site * const *) b;
+
+  if (sa->live_bytes != sb->live_bytes)
+    return (sa->live_bytes < sb->live_bytes) ? 1 : -1;
+  return (sa->bytes < sb->bytes) ? 1 : (sa->bytes > sb->bytes) ? -1 : 0;
+}
+
+static struct alloc_site **sorted_sites(int *count)
+{
+  struct alloc_site **list, *site;
+  int i, n = 0;
+
+  if (!(list = (struct alloc_site **) malloc(sizeof(*list) * (num_sites + 1))))
+    return (NULL);
+
+  for (i = 0; i < SITE_HASH_SIZE; i++)
+    for (site = site_hash[i]; site; site = site->next)
+      list[n++] = site;
+
+  qsort(list, n, sizeof(*list), site_compare);
+  *count = n;
+  return (list);
+}
+
+/* show memory [<count>] - call sites by estimated live bytes */
+void mem_report(struct char_data *ch, char *arg)
+{
+  struct alloc_site **list, *site;
+  unsigned long live = 0;
+  char buf[MAX_STRING_LENGTH], where[64];
+  int count, shown = 25, i;
+  size_t len, nlen;
+
+  if (*arg && is_number(arg))
+    shown = MAX(1, atoi(arg));
+
+  if (!(list = sorted_sites(&count))) {
+    send_to_char(ch, "Out of memory.\r\n");
+    return;
+  }
+  for (i = 0; i < count; i++)
+    live += list[i]->live_bytes;
+
+  len = snprintf(buf, sizeof(buf),
+	"Sample rate: %d bytes, %lu samples live, about %luk live, %d call sites.\r\n"
+	"File:Line                          Calls     Bytes asked  Samples  ~Live bytes\r\n"
+	"------------------------------ ---------- --------------- ------- ------------\r\n",
+	CONFIG_MEM_SAMPLE_RATE, mem_live_samples, live / 1024, count);
+
+  for (i = 0; i < count && i < shown; i++) {
+    site = list[i];
+    snprintf(where, sizeof(where), "%s:%d", site->file, site->line);
+    nlen = snprintf(buf + len, sizeof(buf) - len,
+	"%-30.30s %10lu %15lu %7lu %12lu\r\n",
+	where, site->calls, site->bytes, site->live_samples, site->live_bytes);
+    if (len + nlen >= sizeof(buf))
+      break;
+    len += nlen;
+  }
+
+  free(list);
+  page_string(ch->desc, buf, TRUE);
+}
+
+/* at shutdown, after everything should be freed: log what is left */
+void mem_check(void)
+{
+  struct alloc_site **list;
+  int count, i;
+
+  if (!mem_live_samples || !(list = sorted_sites(&count)))
+    return;
+
+  log("Memory still allocated at shutdown (sampled):");
+  for (i = 0; i < count && list[i]->live_samples; i++)
+    log("  %s:%d: %lu samples, about %lu bytes.", list[i]->file,
+	list[i]->line, list[i]->live_samples, list[i]->live_bytes);
+
+  free(list);
+}
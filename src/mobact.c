@@ -34,155 +34,297 @@ void hunt_victim(struct char_data *ch);
 void mobile_activity(void);
 void clearMemory(struct char_data *ch);
 bool aggressive_mob_on_a_leash(struct char_data *slave, struct char_data *master, struct char_data *attack);
+void mob_ai_char_to_room(struct char_data *ch);
+void mob_ai_char_from_room(struct char_data *ch);
+void queue_aggro_check(room_rnum room);
+static void mobile_act(struct char_data *ch);
+static void mob_attack_on_sight(struct char_data *ch);
+static void run_aggro_checks(void);
 
-#define MOB_AGGR_TO_ALIGN (MOB_AGGR_EVIL | MOB_AGGR_NEUTRAL | MOB_AGGR_GOOD)
+/*
+ * Mobs are kept on a list for the zone they are in (zone_table[].mobs),
+ * so each pass only visits the zones worth visiting.  A zone with no
+ * players in it is dormant: its mobs only get a turn every
+ * CONFIG_DORMANT_MOB_PULSES passes, zones taking turns so they don't all
+ * wake at once, unless the zone is flagged ZONE_ALWAYS_ACTIVE.
+ *
+ * Hibernating zones (see hibernate_zones()) are skipped altogether.
+ *
+ * Aggressive mobs and mobs with memories don't look around every pass.
+ * A room is queued for them to look over when a player comes into it,
+ * when one of them does, and when one of them stops fighting.  Anything
+ * else that can set one off -- a mob waking or standing, a player's
+ * invisibility or hiding wearing off, a change of alignment or light --
+ * is caught by the zone pass, which queues the room of every such mob
+ * that shares it with a player, so it is looked over on the next pass.
+ */
+static struct char_data *mob_ai_next = NULL;	/* the zone pass's cursor */
+static room_rnum *aggro_rooms = NULL;
+static int num_aggro_rooms = 0, max_aggro_rooms = 0;
+static unsigned long mob_ai_passes = 0;
 
 void mobile_activity(void)
 {
-  struct char_data *ch, *next_ch, *vict;
+  struct char_data *ch;
+  zone_rnum zone;
+  int rate = CONFIG_DORMANT_MOB_PULSES, was = rng_use(RNG_AI);
+
+  run_aggro_checks();
+  mob_ai_passes++;
+
+  for (zone = 0; zone <= top_of_zone_table; zone++) {
+    if (zone_table[zone].hibernating)
+      continue;
+    if (!zone_table[zone].players && !ZONE_FLAGGED(zone, ZONE_ALWAYS_ACTIVE) &&
+	(rate <= 0 || (mob_ai_passes + zone) % rate))
+      continue;
+
+    for (ch = zone_table[zone].mobs; ch; ch = mob_ai_next) {
+      mob_ai_next = ch->next_in_zone;
+      if (!IS_MOB(ch) || MOB_FLAGGED(ch, MOB_NOTDEADYET))
+        continue;
+      if (MOB_FLAGGED(ch, MOB_ATTACKS_ON_SIGHT) && zone_table[zone].players &&
+          world[IN_ROOM(ch)].census.pcs)
+        queue_aggro_check(IN_ROOM(ch));
+      mobile_act(ch);
+    }
+  }
+  mob_ai_next = NULL;
+  rng_use(was);
+}
+
+static void mobile_act(struct char_data *ch)
+{
+  struct char_data *vict;
   struct obj_data *obj, *best_obj;
   int door, found, max;
-  memory_rec *names;
 
-  for (ch = character_list; ch; ch = next_ch) {
-    next_ch = ch->next;
+  /* Examine call for special procedure */
+  if (MOB_FLAGGED(ch, MOB_SPEC) && !no_specials) {
+    if (mob_index[GET_MOB_RNUM(ch)].func == NULL) {
+      log("SYSERR: %s (#%d): Attempting to call non-existing mob function.",
+	      GET_NAME(ch), GET_MOB_VNUM(ch));
+      REMOVE_BIT(MOB_FLAGS(ch), MOB_SPEC);
+    } else {
+      char actbuf[MAX_INPUT_LENGTH] = "";
+      if ((mob_index[GET_MOB_RNUM(ch)].func) (ch, ch, 0, actbuf))
+        return;		/* go to next char */
+    }
+  }
 
-    if (!IS_MOB(ch))
-      continue;
+  /* If the mob has no specproc, do the default actions */
+  if (FIGHTING(ch) || !AWAKE(ch))
+    return;
 
-    /* Examine call for special procedure */
-    if (MOB_FLAGGED(ch, MOB_SPEC) && !no_specials) {
-      if (mob_index[GET_MOB_RNUM(ch)].func == NULL) {
-	log("SYSERR: %s (#%d): Attempting to call non-existing mob function.",
-		GET_NAME(ch), GET_MOB_VNUM(ch));
-	REMOVE_BIT(MOB_FLAGS(ch), MOB_SPEC);
-      } else {
-        char actbuf[MAX_INPUT_LENGTH] = "";
-	if ((mob_index[GET_MOB_RNUM(ch)].func) (ch, ch, 0, actbuf))
-	  continue;		/* go to next char */
+  /* hunt a victim, if applicable */
+  hunt_victim(ch);
+
+  /* Scavenger (picking up objects) */
+  if (MOB_FLAGGED(ch, MOB_SCAVENGER))
+    if (world[IN_ROOM(ch)].census.objs && !rand_number(0, 10)) {
+      max = 1;
+      best_obj = NULL;
+      for (obj = world[IN_ROOM(ch)].contents; obj; obj = obj->next_content)
+        if (CAN_GET_OBJ(ch, obj) && GET_OBJ_COST(obj) > max) {
+          best_obj = obj;
+          max = GET_OBJ_COST(obj);
+        }
+      if (best_obj != NULL) {
+        obj_from_room(best_obj);
+        obj_to_char(best_obj, ch);
+        act("$n gets $p.", FALSE, ch, best_obj, 0, TO_ROOM);
       }
     }
 
-    /* If the mob has no specproc, do the default actions */
-    if (FIGHTING(ch) || !AWAKE(ch))
-      continue;
+  /* Mob Movement */
+  if (!MOB_FLAGGED(ch, MOB_SENTINEL) && (GET_POS(ch) == POS_STANDING) &&
+      ((door = rand_number(0, 18)) < NUM_OF_DIRS) && CAN_GO(ch, door) &&
+      !ROOM_FLAGGED(EXIT(ch, door)->to_room, ROOM_NOMOB | ROOM_DEATH) &&
+      (!MOB_FLAGGED(ch, MOB_STAY_ZONE) ||
+       (world[EXIT(ch, door)->to_room].zone == world[IN_ROOM(ch)].zone))) {
+    perform_move(ch, door, 1);
+  }
 
-    /* hunt a victim, if applicable */
-    hunt_victim(ch);
-
-    /* Scavenger (picking up objects) */
-    if (MOB_FLAGGED(ch, MOB_SCAVENGER))
-      if (world[IN_ROOM(ch)].contents && !rand_number(0, 10)) {
-	max = 1;
-	best_obj = NULL;
-	for (obj = world[IN_ROOM(ch)].contents; obj; obj = obj->next_content)
-	  if (CAN_GET_OBJ(ch, obj) && GET_OBJ_COST(obj) > max) {
-	    best_obj = obj;
-	    max = GET_OBJ_COST(obj);
-	  }
-	if (best_obj != NULL) {
-	  obj_from_room(best_obj);
-	  obj_to_char(best_obj, ch);
-	  act("$n gets $p.", FALSE, ch, best_obj, 0, TO_ROOM);
-	}
-      }
+  /*
+   * Charmed Mob Rebellion
+   *
+   * In order to rebel, there need to be more charmed monsters
+   * than the person can feasibly control at a time.  Then the
+   * mobiles have a chance based on the charisma of their leader.
+   *
+   * 1-4 = 0, 5-7 = 1, 8-10 = 2, 11-13 = 3, 14-16 = 4, 17-19 = 5, etc.
+   */
+  if (AFF_FLAGGED(ch, AFF_CHARM) && ch->master && num_followers_charmed(ch->master) > (GET_CHA(ch->master) - 2) / 3) {
+    if (!aggressive_mob_on_a_leash(ch, ch->master, ch->master)) {
+      if (CAN_SEE(ch, ch->master) && !PRF_FLAGGED(ch->master, PRF_NOHASSLE))
+        hit(ch, ch->master, TYPE_UNDEFINED);
+      stop_follower(ch);
+    }
+  }
 
-    /* Mob Movement */
-    if (!MOB_FLAGGED(ch, MOB_SENTINEL) && (GET_POS(ch) == POS_STANDING) &&
-	((door = rand_number(0, 18)) < NUM_OF_DIRS) && CAN_GO(ch, door) &&
-	!ROOM_FLAGGED(EXIT(ch, door)->to_room, ROOM_NOMOB | ROOM_DEATH) &&
-	(!MOB_FLAGGED(ch, MOB_STAY_ZONE) ||
-	 (world[EXIT(ch, door)->to_room].zone == world[IN_ROOM(ch)].zone))) {
-      perform_move(ch, door, 1);
+  /* Helper Mobs */
+  if (MOB_FLAGGED(ch, MOB_HELPER) && !AFF_FLAGGED(ch, AFF_BLIND | AFF_CHARM) &&
+      world[IN_ROOM(ch)].census.pcs) {	/* someone to be fighting */
+    found = FALSE;
+    for (vict = world[IN_ROOM(ch)].people; vict && !found; vict = vict->next_in_room) {
+      if (ch == vict || !IS_NPC(vict) || !FIGHTING(vict))
+        continue;
+      if (IS_NPC(FIGHTING(vict)) || ch == FIGHTING(vict))
+        continue;
+
+      act("$n jumps to the aid of $N!", FALSE, ch, 0, vict, TO_ROOM);
+      hit(ch, FIGHTING(vict), TYPE_UNDEFINED);
+      found = TRUE;
     }
+  }
 
-    /* Aggressive Mobs */
-    if (MOB_FLAGGED(ch, MOB_AGGRESSIVE | MOB_AGGR_TO_ALIGN)) {
-      found = FALSE;
-      for (vict = world[IN_ROOM(ch)].people; vict && !found; vict = vict->next_in_room) {
-	if (IS_NPC(vict) || !CAN_SEE(ch, vict) || PRF_FLAGGED(vict, PRF_NOHASSLE))
-	  continue;
+  /* Add new mobile actions here */
+}
+
+/* an aggressive mob, or one with a memory, looks over its room */
+static void mob_attack_on_sight(struct char_data *ch)
+{
+  struct char_data *vict;
+  memory_rec *names;
+  int found;
 
-	if (MOB_FLAGGED(ch, MOB_WIMPY) && AWAKE(vict))
-	  continue;
+  /* Aggressive Mobs */
+  if (MOB_FLAGGED(ch, MOB_AGGRESSIVE | MOB_AGGR_TO_ALIGN)) {
+    found = FALSE;
+    for (vict = world[IN_ROOM(ch)].people; vict && !found; vict = vict->next_in_room) {
+      if (IS_NPC(vict) || !CAN_SEE(ch, vict) || PRF_FLAGGED(vict, PRF_NOHASSLE))
+        continue;
 
-	if (MOB_FLAGGED(ch, MOB_AGGRESSIVE  ) ||
-	   (MOB_FLAGGED(ch, MOB_AGGR_EVIL   ) && IS_EVIL(vict)) ||
-	   (MOB_FLAGGED(ch, MOB_AGGR_NEUTRAL) && IS_NEUTRAL(vict)) ||
-	   (MOB_FLAGGED(ch, MOB_AGGR_GOOD   ) && IS_GOOD(vict))) {
+      if (MOB_FLAGGED(ch, MOB_WIMPY) && AWAKE(vict))
+        continue;
 
-          /* Can a master successfully control the charmed monster? */
-          if (aggressive_mob_on_a_leash(ch, ch->master, vict))
-            continue;
+      if (MOB_FLAGGED(ch, MOB_AGGRESSIVE  ) ||
+         (MOB_FLAGGED(ch, MOB_AGGR_EVIL   ) && IS_EVIL(vict)) ||
+         (MOB_FLAGGED(ch, MOB_AGGR_NEUTRAL) && IS_NEUTRAL(vict)) ||
+         (MOB_FLAGGED(ch, MOB_AGGR_GOOD   ) && IS_GOOD(vict))) {
 
-	  hit(ch, vict, TYPE_UNDEFINED);
-	  found = TRUE;
-	}
+        /* Can a master successfully control the charmed monster? */
+        if (aggressive_mob_on_a_leash(ch, ch->master, vict))
+          continue;
+
+        hit(ch, vict, TYPE_UNDEFINED);
+        found = TRUE;
       }
     }
+  }
 
-    /* Mob Memory */
-    if (MOB_FLAGGED(ch, MOB_MEMORY) && MEMORY(ch)) {
-      found = FALSE;
-      for (vict = world[IN_ROOM(ch)].people; vict && !found; vict = vict->next_in_room) {
-	if (IS_NPC(vict) || !CAN_SEE(ch, vict) || PRF_FLAGGED(vict, PRF_NOHASSLE))
-	  continue;
+  /* Mob Memory */
+  if (MOB_FLAGGED(ch, MOB_MEMORY) && MEMORY(ch)) {
+    found = FALSE;
+    for (vict = world[IN_ROOM(ch)].people; vict && !found; vict = vict->next_in_room) {
+      if (IS_NPC(vict) || !CAN_SEE(ch, vict) || PRF_FLAGGED(vict, PRF_NOHASSLE))
+        continue;
 
-	for (names = MEMORY(ch); names && !found; names = names->next) {
-	  if (names->id != GET_IDNUM(vict))
-            continue;
+      for (names = MEMORY(ch); names && !found; names = names->next) {
+        if (names->id != GET_IDNUM(vict))
+          continue;
 
-          /* Can a master successfully control the charmed monster? */
-          if (aggressive_mob_on_a_leash(ch, ch->master, vict))
-            continue;
+        /* Can a master successfully control the charmed monster? */
+        if (aggressive_mob_on_a_leash(ch, ch->master, vict))
+          continue;
 
-          found = TRUE;
-          act("'Hey!  You're the fiend that attacked me!!!', exclaims $n.", FALSE, ch, 0, 0, TO_ROOM);
-          hit(ch, vict, TYPE_UNDEFINED);
-        }
+        found = TRUE;
+        act("'Hey!  You're the fiend that attacked me!!!', exclaims $n.", FALSE, ch, 0, 0, TO_ROOM);
+        hit(ch, vict, TYPE_UNDEFINED);
       }
     }
+  }
+}
 
-    /*
-     * Charmed Mob Rebellion
-     *
-     * In order to rebel, there need to be more charmed monsters
-     * than the person can feasibly control at a time.  Then the
-     * mobiles have a chance based on the charisma of their leader.
-     *
-     * 1-4 = 0, 5-7 = 1, 8-10 = 2, 11-13 = 3, 14-16 = 4, 17-19 = 5, etc.
-     */
-    if (AFF_FLAGGED(ch, AFF_CHARM) && ch->master && num_followers_charmed(ch->master) > (GET_CHA(ch->master) - 2) / 3) {
-      if (!aggressive_mob_on_a_leash(ch, ch->master, ch->master)) {
-        if (CAN_SEE(ch, ch->master) && !PRF_FLAGGED(ch->master, PRF_NOHASSLE))
-          hit(ch, ch->master, TYPE_UNDEFINED);
-        stop_follower(ch);
-      }
-    }
+/*
+ * Rooms are queued by rnum.  Should rooms be added or deleted before the
+ * queue is run, an entry may name a different room than it was queued
+ * for, which only costs looking that room over for nothing.
+ */
+void queue_aggro_check(room_rnum room)
+{
+  if (room == NOWHERE)
+    return;
+  if (num_aggro_rooms && aggro_rooms[num_aggro_rooms - 1] == room)
+    return;
 
-    /* Helper Mobs */
-    if (MOB_FLAGGED(ch, MOB_HELPER) && !AFF_FLAGGED(ch, AFF_BLIND | AFF_CHARM)) {
-      found = FALSE;
-      for (vict = world[IN_ROOM(ch)].people; vict && !found; vict = vict->next_in_room) {
-	if (ch == vict || !IS_NPC(vict) || !FIGHTING(vict))
-	  continue;
-	if (IS_NPC(FIGHTING(vict)) || ch == FIGHTING(vict))
-	  continue;
-
-	act("$n jumps to the aid of $N!", FALSE, ch, 0, vict, TO_ROOM);
-	hit(ch, FIGHTING(vict), TYPE_UNDEFINED);
-	found = TRUE;
-      }
+  if (num_aggro_rooms >= max_aggro_rooms) {
+    max_aggro_rooms = MAX(64, max_aggro_rooms * 2);
+    RECREATE(aggro_rooms, room_rnum, max_aggro_rooms);
+  }
+  aggro_rooms[num_aggro_rooms++] = room;
+}
+
+static void run_aggro_checks(void)
+{
+  struct char_data *ch, *next_ch;
+  room_rnum room;
+  int i;
+
+  /* hit() can queue more rooms; those wait for the next pass */
+  for (i = 0; i < num_aggro_rooms; i++) {
+    if ((room = aggro_rooms[i]) > top_of_world || !world[room].census.pcs ||
+	!(room_occupants(room) & OCC_AGGRESSIVE))
+      continue;
+
+    for (ch = world[room].people; ch; ch = next_ch) {
+      next_ch = ch->next_in_room;
+      if (IS_MOB(ch) && MOB_FLAGGED(ch, MOB_ATTACKS_ON_SIGHT) &&
+          !MOB_FLAGGED(ch, MOB_NOTDEADYET) && !FIGHTING(ch) && AWAKE(ch))
+        mob_attack_on_sight(ch);
     }
+  }
+  num_aggro_rooms = 0;
+}
+
+/* called by char_to_room(), after ch is in the room */
+void mob_ai_char_to_room(struct char_data *ch)
+{
+  struct zone_data *zone = &zone_table[world[IN_ROOM(ch)].zone];
 
-    /* Add new mobile actions here */
+  if (!IS_NPC(ch)) {
+    if (room_occupants(IN_ROOM(ch)) & OCC_AGGRESSIVE)
+      queue_aggro_check(IN_ROOM(ch));
+    return;
+  }
 
-  }				/* end for() */
+  ch->prev_in_zone = NULL;
+  if ((ch->next_in_zone = zone->mobs) != NULL)
+    zone->mobs->prev_in_zone = ch;
+  zone->mobs = ch;
+
+  if (MOB_FLAGGED(ch, MOB_ATTACKS_ON_SIGHT) && world[IN_ROOM(ch)].census.pcs)
+    queue_aggro_check(IN_ROOM(ch));
 }
 
+/* called by char_from_room(), while ch is still in the room */
+void mob_ai_char_from_room(struct char_data *ch)
+{
+  if (!IS_NPC(ch))
+    return;
+
+  if (mob_ai_next == ch)
+    mob_ai_next = ch->next_in_zone;
+
+  if (ch->prev_in_zone)
+    ch->prev_in_zone->next_in_zone = ch->next_in_zone;
+  else if (zone_table[world[IN_ROOM(ch)].zone].mobs == ch)
+    zone_table[world[IN_ROOM(ch)].zone].mobs = ch->next_in_zone;
+  if (ch->next_in_zone)
+    ch->next_in_zone->prev_in_zone = ch->prev_in_zone;
+  ch->next_in_zone = ch->prev_in_zone = NULL;
+}
 
 
-/* Mob Memory Routines */
+
+/*
+ * Mob Memory Routines
+ *
+ * A memory names the player by GET_IDNUM(), not by a char_ref: the idnum
+ * is never a pointer, so it cannot dangle, and it outlives the character
+ * -- a mob still knows the player who attacked it after they quit and
+ * come back, which a char_ref, invalidated on extraction, would forget.
+ */
 
 /* make ch remember victim */
 void remember(struct char_data *ch, struct char_data *victim)
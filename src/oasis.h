@@ -429,6 +429,15 @@ extern const char *nrm, *grn, *cyn, *yel;
 #define CEDIT_NAMESERVER_IS_SLOW	51
 #define CEDIT_USE_AUTOWIZ		52
 #define CEDIT_MIN_WIZLIST_LEV		53
+#define CEDIT_SCRIPT_BUDGET		54
+#define CEDIT_MEM_SAMPLE_RATE		55
+#define CEDIT_ZONE_RESET_BUDGET		56
+#define CEDIT_DORMANT_MOB_PULSES	57
+#define CEDIT_HIBERNATE_MINUTES		58
+#define CEDIT_INPUT_BYTE_RATE		59
+#define CEDIT_INPUT_LINE_RATE		60
+#define CEDIT_INPUT_QUEUE_LINES		61
+#define CEDIT_INPUT_OVERFLOW		62
 
 /* Hedit Submodes of connectedness. */
 #define HEDIT_MAIN_MENU                0
@@ -187,6 +187,7 @@ ACMD(do_dig)
     W_EXIT(rrnum, rev_dir[dir])->to_room = IN_ROOM(ch);
     add_to_save_list(zone_table[world[rrnum].zone].number, SL_WLD);
   }
+  path_exits_changed();
 
 }
 
@@ -310,18 +311,16 @@ ACMD(do_room_copy)
 room_vnum redit_find_new_vnum(zone_rnum zone) 
 {
   room_vnum vnum = genolc_zone_bottom(zone);
-  room_rnum rnum = real_room(vnum);
 
-  if (rnum == NOWHERE) 
+  if (real_room(vnum) == NOWHERE) 
     return NOWHERE;
 
+  /* new rooms are appended to the world, so walk the vnums, not the rnums */
   for(;;) {
-    if (vnum > zone_table[zone].top)
+    if (vnum >= zone_table[zone].top)
       return(NOWHERE);
-    if (rnum > top_of_world || world[rnum].number > vnum)
+    if (real_room(++vnum) == NOWHERE)
       break;
-    rnum++;
-    vnum++;
   }
   return(vnum);
 }
@@ -376,6 +375,7 @@ int buildwalk(struct char_data *ch, int dir)
       EXIT(ch, dir)->to_room = rnum;
       CREATE(world[rnum].dir_option[rev_dir[dir]], struct room_direction_data, 1);
       world[rnum].dir_option[rev_dir[dir]]->to_room = IN_ROOM(ch);
+      path_exits_changed();
 
       /* Report room creation to user */
       send_to_char(ch, "%sRoom #%d created by BuildWalk.%s\r\n", yel, vnum, nrm);
@@ -76,7 +76,7 @@ ACMD(do_oasis_links)
   zone_vnum zvnum;
   room_rnum nr, to_room;
   room_vnum first, last;
-  int j;
+  int v, j;
   char arg[MAX_INPUT_LENGTH];
 
   skip_spaces(&argument);
@@ -105,8 +105,8 @@ ACMD(do_oasis_links)
   first = zone_table[zrnum].bot;
 
   send_to_char(ch, "Zone %d is linked to the following zones:\r\n", zvnum);
-  for (nr = 0; nr <= top_of_world && (GET_ROOM_VNUM(nr) <= last); nr++) {
-    if (GET_ROOM_VNUM(nr) >= first) {
+  for (v = first; v <= last; v++) {
+    if ((nr = real_room(v)) != NOWHERE) {
       for (j = 0; j < NUM_OF_DIRS; j++) {
 	if (world[nr].dir_option[j]) {
 	  to_room = world[nr].dir_option[j]->to_room;
@@ -132,7 +132,7 @@ void list_rooms(struct char_data *ch, zone_rnum rnum, room_vnum vmin, room_vnum
 {
   room_rnum i;
   room_vnum bottom, top;
-  int j, counter = 0;
+  int v, j, counter = 0;
 
   /*
    * Expect a minimum / maximum number if the rnum for the zone is NOWHERE. 
@@ -149,10 +149,11 @@ void list_rooms(struct char_data *ch, zone_rnum rnum, room_vnum vmin, room_vnum
   "Index VNum    Room Name                                Exits\r\n"
   "----- ------- ---------------------------------------- -----\r\n");
   
-  for (i = 0; i <= top_of_world; i++) {
+  /* rooms made in redit sit at the end of the world, so go by vnum */
+  for (v = bottom; v <= top; v++) {
     
     /** Check to see if this room is one of the ones needed to be listed.    **/
-    if ((world[i].number >= bottom) && (world[i].number <= top)) {
+    if ((i = real_room(v)) != NOWHERE) {
       counter++;
 
         send_to_char(ch, "%4d) [%s%-5d%s] %s%-*s%s %s",
@@ -188,7 +189,7 @@ void list_mobiles(struct char_data *ch, zone_rnum rnum, mob_vnum vmin, mob_vnum
 {
   mob_rnum i;
   mob_vnum bottom, top;
-  int counter = 0;
+  int v, counter = 0;
   
   if (rnum != NOWHERE) {
     bottom = zone_table[rnum].bot;
@@ -202,8 +203,8 @@ void list_mobiles(struct char_data *ch, zone_rnum rnum, mob_vnum vmin, mob_vnum
   "Index VNum    Mobile Name                                   Level\r\n"
   "----- ------- --------------------------------------------- -----\r\n");
   
-  for (i = 0; i <= top_of_mobt; i++) {
-    if (mob_index[i].vnum >= bottom && mob_index[i].vnum <= top) {
+  for (v = bottom; v <= top; v++) {
+    if ((i = real_mobile(v)) != NOBODY) {
       counter++;
  
       send_to_char(ch, "%s%4d%s) [%s%-5d%s] %s%-*s %s[%4d]%s%s\r\n",
@@ -226,7 +227,7 @@ void list_objects(struct char_data *ch, zone_rnum rnum, room_vnum vmin, room_vnu
 {
   obj_rnum i;
   obj_vnum bottom, top;
-  int counter = 0;
+  int v, counter = 0;
   
   if (rnum != NOWHERE) {
     bottom = zone_table[rnum].bot;
@@ -240,8 +241,8 @@ void list_objects(struct char_data *ch, zone_rnum rnum, room_vnum vmin, room_vnu
   "Index VNum    Object Name                                  Object Type\r\n"
   "----- ------- -------------------------------------------- ----------------\r\n");
   
-  for (i = 0; i <= top_of_objt; i++) {
-    if (obj_index[i].vnum >= bottom && obj_index[i].vnum <= top) {
+  for (v = bottom; v <= top; v++) {
+    if ((i = real_object(v)) != NOTHING) {
       counter++;
       
       send_to_char(ch, "%s%4d%s) [%s%-5d%s] %s%-*s %s[%s]%s%s\r\n",
@@ -348,9 +349,7 @@ void list_zones(struct char_data *ch, zone_rnum rnum, zone_vnum vmin, zone_vnum
 void print_zone(struct char_data *ch, zone_vnum vnum)
 {
   zone_rnum rnum;
-  int size_rooms, size_objects, size_mobiles, i;
-  room_vnum top, bottom;
-  int largest_table;
+  int size_rooms, size_objects, size_mobiles, size_trigs;
 
   if ((rnum = real_zone(vnum)) == NOWHERE) {
     send_to_char(ch, "Zone #%d does not exist in the database.\r\n", vnum);
@@ -358,38 +357,9 @@ void print_zone(struct char_data *ch, zone_vnum vnum)
   }
 
   /****************************************************************************/
-  /** Locate the largest of the three, top_of_world, top_of_mobt, or         **/
-  /** top_of_objt.                                                           **/
+  /** Count what lies in the zone's range through the vnum indexes.         **/
   /****************************************************************************/
-  if (top_of_world >= top_of_objt && top_of_world >= top_of_mobt)
-    largest_table = top_of_world;
-  else if (top_of_objt >= top_of_mobt && top_of_objt >= top_of_world)
-    largest_table = top_of_objt;
-  else
-    largest_table = top_of_mobt;
-  
-  /****************************************************************************/
-  /** Initialize some of the variables.                                      **/
-  /****************************************************************************/
-  size_rooms   = 0;
-  size_objects = 0;
-  size_mobiles = 0;
-  top          = zone_table[rnum].top;
-  bottom       = zone_table[rnum].bot;
-  
-  for (i = 0; i <= largest_table; i++) {
-    if (i <= top_of_world)
-      if (world[i].zone == rnum)
-        size_rooms++;
-    
-    if (i <= top_of_objt)
-      if (obj_index[i].vnum >= bottom && obj_index[i].vnum <= top)
-        size_objects++;
-    
-    if (i <= top_of_mobt)
-      if (mob_index[i].vnum >= bottom && mob_index[i].vnum <= top)
-        size_mobiles++;
-  }
+  count_zone_contents(rnum, &size_rooms, &size_mobiles, &size_objects, &size_trigs);
   
   /****************************************************************************/
   /** Display all of the zone information at once.                           **/
@@ -406,12 +376,13 @@ void print_zone(struct char_data *ch, zone_vnum vnum)
     "%sSize\r\n"
     "%s   Rooms       = %s%d\r\n"
     "%s   Objects     = %s%d\r\n"
-    "%s   Mobiles     = %s%d%s\r\n",
+    "%s   Mobiles     = %s%d\r\n"
+    "%s   Triggers    = %s%d%s\r\n",
     QGRN, QCYN, zone_table[rnum].number,
     QGRN, QCYN, zone_table[rnum].name,
     QGRN, QCYN, zone_table[rnum].builders,
     QGRN, QCYN, zone_table[rnum].lifespan,
-    QGRN, QCYN, zone_table[rnum].age,
+    QGRN, QCYN, zone_age(rnum),
     QGRN, QCYN, zone_table[rnum].bot, 
     QGRN, QCYN, zone_table[rnum].top,
     QGRN, QCYN, zone_table[rnum].reset_mode ? ((zone_table[rnum].reset_mode == 1) ?
@@ -419,7 +390,8 @@ void print_zone(struct char_data *ch, zone_vnum vnum)
     QGRN,
     QGRN, QCYN, size_rooms,
     QGRN, QCYN, size_objects,
-    QGRN, QCYN, size_mobiles, QNRM);
+    QGRN, QCYN, size_mobiles,
+    QGRN, QCYN, size_trigs, QNRM);
 }
 
 /* List code by Ronald Evers - dlanor@xs4all.nl */
@@ -444,26 +416,23 @@ void list_triggers(struct char_data *ch, zone_rnum rnum, trig_vnum vmin, trig_vn
   "----- ------- -------------------------------------------------------\r\n");
 
 
-  /** Loop through the world and find each room. **/
-  for (i = 0; i < top_of_trigt; i++) {
-    /** Check to see if this room is one of the ones needed to be listed.    **/
-    if ((trig_index[i]->vnum >= bottom) && (trig_index[i]->vnum <= top)) {
-      counter++;
+  /** The index is sorted, so start at the bottom of the range and stop   **/
+  /** at the first trigger past the top of it.                            **/
+  for (i = first_trigger_from(bottom); i < top_of_trigt && trig_index[i]->vnum <= top; i++) {
+    counter++;
 
-      send_to_char(ch, "%4d) [%s%5d%s] %s%-45.45s%s ",
-        counter, QGRN, trig_index[i]->vnum, QNRM, QCYN, trig_index[i]->proto->name, QNRM);
-
-      if (trig_index[i]->proto->attach_type == OBJ_TRIGGER) {
-        sprintbit(GET_TRIG_TYPE(trig_index[i]->proto), otrig_types, trgtypes, sizeof(trgtypes));
-        send_to_char(ch, "obj %s%s%s\r\n", QYEL, trgtypes, QNRM);
-      } else if (trig_index[i]->proto->attach_type==WLD_TRIGGER) {
-        sprintbit(GET_TRIG_TYPE(trig_index[i]->proto), wtrig_types, trgtypes, sizeof(trgtypes));
-        send_to_char(ch, "wld %s%s%s\r\n", QYEL, trgtypes, QNRM);
-      } else {
-        sprintbit(GET_TRIG_TYPE(trig_index[i]->proto), trig_types, trgtypes, sizeof(trgtypes));
-        send_to_char(ch, "mob %s%s%s\r\n", QYEL, trgtypes, QNRM);
-      }
+    send_to_char(ch, "%4d) [%s%5d%s] %s%-45.45s%s ",
+      counter, QGRN, trig_index[i]->vnum, QNRM, QCYN, trig_index[i]->proto->name, QNRM);
 
+    if (trig_index[i]->proto->attach_type == OBJ_TRIGGER) {
+      sprintbit(GET_TRIG_TYPE(trig_index[i]->proto), otrig_types, trgtypes, sizeof(trgtypes));
+      send_to_char(ch, "obj %s%s%s\r\n", QYEL, trgtypes, QNRM);
+    } else if (trig_index[i]->proto->attach_type==WLD_TRIGGER) {
+      sprintbit(GET_TRIG_TYPE(trig_index[i]->proto), wtrig_types, trgtypes, sizeof(trgtypes));
+      send_to_char(ch, "wld %s%s%s\r\n", QYEL, trgtypes, QNRM);
+    } else {
+      sprintbit(GET_TRIG_TYPE(trig_index[i]->proto), trig_types, trgtypes, sizeof(trgtypes));
+      send_to_char(ch, "mob %s%s%s\r\n", QYEL, trgtypes, QNRM);
     }
   }
 
@@ -105,7 +105,7 @@ struct obj_data *Obj_from_store(struct obj_file_elem object, int *location)
     GET_OBJ_VAL(obj, 3) = object.value[3];
     GET_OBJ_EXTRA(obj) = object.extra_flags;
     GET_OBJ_WEIGHT(obj) = object.weight;
-    GET_OBJ_TIMER(obj) = object.timer;
+    set_obj_timer(obj, object.timer);
     obj->obj_flags.bitvector = object.bitvector;
 
     for (j = 0; j < MAX_OBJ_AFFECT; j++)
@@ -165,7 +165,7 @@ mudlog(BRF, LVL_IMPL, TRUE, "OLC: %s tried to edit zone %d allowed zone %d",
     /**************************************************************************/
     /** Save the objects in this zone.                                       **/
     /**************************************************************************/
-    save_objects(OLC_ZNUM(d));
+    queue_olc_save(OLC_ZNUM(d), SL_OBJ);
     
     /**************************************************************************/
     /** Free the descriptor's OLC structure.                                 **/
@@ -324,7 +324,7 @@ void oedit_save_internally(struct descriptor_data *d)
 
 void oedit_save_to_disk(int zone_num)
 {
-  save_objects(zone_num);
+  queue_olc_save(zone_num, SL_OBJ);
 }
 
 /**************************************************************************
@@ -1020,7 +1020,7 @@ void oedit_parse(struct descriptor_data *d, char *arg)
     break;
 
   case OEDIT_TIMER:
-    GET_OBJ_TIMER(OLC_OBJ(d)) = LIMIT(atoi(arg), 0, MAX_OBJ_TIMER);
+    OLC_OBJ(d)->obj_flags.timer = LIMIT(atoi(arg), 0, MAX_OBJ_TIMER);
     break;
 
   case OEDIT_LEVEL:
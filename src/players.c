@@ -510,6 +510,7 @@ void save_char(struct char_data * ch)
   for (aff = ch->affected, i = 0; i < MAX_AFFECT; i++) {
     if (aff) {
       tmp_aff[i] = *aff;
+      tmp_aff[i].duration = affect_duration(aff);
       tmp_aff[i].next = 0;
       aff = aff->next;
     } else {
@@ -0,0 +1,705 @@
+/* ************************************************************************
+*   File: protocol.c                                    Part of CircleMUD *
+*  Usage: the telnet protocol: commands and options in a client's input   *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+*                                                                         *
+*  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+*  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+************************************************************************ */
+
+/*
+ * Everything a client sends goes through telnet_filter() on its way from
+ * the socket to the line assembler in comm.c.  It takes out the telnet
+ * commands (IAC ...) and answers them, and leaves the text behind.  It
+ * keeps where it is in a command in the descriptor, so a command split
+ * between two reads is picked up where it left off.
+ *
+ * On connecting we ask the client for its window size (NAWS) and terminal
+ * type (TTYPE), and offer to agree a character set (CHARSET) and to send
+ * GMCP.  Clients that don't understand just refuse or say nothing; a
+ * client that offers something we don't do is refused.  The answers go
+ * into the descriptor, to be looked at with "show input", and go across
+ * a copyover with it (telnet_save(), telnet_restore()).
+ *
+ * GMCP (the Generic Mud Communication Protocol) carries "Package.Message
+ * <json>" in IAC SB GMCP ... IAC SE, out of band of the text.  A client
+ * that takes it is sent Char.Vitals, Char.Combat and Room.Info, each only
+ * when something in it has changed, and then only the fields that did.
+ * Code that changes hit points, fights or moves someone marks the message
+ * with GMCP_DIRTY() (comm.h); once a pass gmcp_update() looks at what was
+ * marked, against what the client was last told.
+ */
+
+#include "conf.h"
+#include "sysdep.h"
+
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "db.h"
+
+#ifdef HAVE_ARPA_TELNET_H
+#include <arpa/telnet.h>
+#else
+#include "telnet.h"
+#endif
+
+#ifndef TELOPT_CHARSET
+#define TELOPT_CHARSET		42	/* RFC 2066 */
+#endif
+#define CHARSET_REQUEST		1
+#define CHARSET_ACCEPTED	2
+#define CHARSET_REJECTED	3
+
+#ifndef TELOPT_GMCP
+#define TELOPT_GMCP		201
+#endif
+#define GMCP_STRING_LENGTH	128	/* longest string in a message	*/
+
+/* external functions */
+ssize_t perform_socket_write(socket_t desc, const char *txt, size_t length);
+
+/* external globals */
+extern const char *dirs[];
+
+/* local functions */
+static void gmcp_receive(struct descriptor_data *d);
+static void gmcp_forget(struct gmcp_data *g, int bits);
+
+/* telnet_data.state: how much of a command we have seen */
+#define TS_DATA			0	/* plain text			*/
+#define TS_IAC			1	/* IAC				*/
+#define TS_OPTION		2	/* IAC WILL/WONT/DO/DONT	*/
+#define TS_SB_OPTION		3	/* IAC SB			*/
+#define TS_SB			4	/* IAC SB <option> ...		*/
+#define TS_SB_IAC		5	/* IAC SB <option> ... IAC	*/
+
+/* the character sets we offer, best first */
+#define CHARSETS		";UTF-8;ISO-8859-1;US-ASCII"
+
+static int gmcp_queue_raw(struct descriptor_data *d, const char *seq, int len);
+
+/*
+ * Send a telnet sequence: it may not hold a NUL.  Behind a GMCP message
+ * the socket only took part of, it waits its turn in the same queue.
+ */
+static void telnet_send(struct descriptor_data *d, const char *seq)
+{
+  if (GMCP_WAITING(d))
+    gmcp_queue_raw(d, seq, strlen(seq));
+  else
+    write_to_descriptor(d->descriptor, seq);
+}
+
+static void telnet_command(struct descriptor_data *d, int command, int option)
+{
+  char seq[4];
+
+  seq[0] = (char) IAC;
+  seq[1] = (char) command;
+  seq[2] = (char) option;
+  seq[3] = '\0';
+  telnet_send(d, seq);
+}
+
+/* which TELNET_x an option is; 0 for one we don't do */
+static bitvector_t telnet_bit(int option)
+{
+  switch (option) {
+  case TELOPT_NAWS:	return (TELNET_NAWS);
+  case TELOPT_TTYPE:	return (TELNET_TTYPE);
+  case TELOPT_CHARSET:	return (TELNET_CHARSET);
+  case TELOPT_GMCP:	return (TELNET_GMCP);
+  default:		return (0);
+  }
+}
+
+/* the option has just been agreed to */
+static void telnet_start(struct descriptor_data *d, int option)
+{
+  char seq[64];
+
+  switch (option) {
+  case TELOPT_TTYPE:
+    snprintf(seq, sizeof(seq), "%c%c%c%c%c%c", IAC, SB, TELOPT_TTYPE,
+	TELQUAL_SEND, IAC, SE);
+    telnet_send(d, seq);
+    break;
+  case TELOPT_CHARSET:
+    snprintf(seq, sizeof(seq), "%c%c%c%c%s%c%c", IAC, SB, TELOPT_CHARSET,
+	CHARSET_REQUEST, CHARSETS, IAC, SE);
+    telnet_send(d, seq);
+    break;
+  case TELOPT_GMCP:
+    d->gmcp.modules = 0;
+    d->gmcp.supports = FALSE;
+    gmcp_forget(&d->gmcp, GMCP_ALL);
+    break;
+  }
+}
+
+/*
+ * IAC WILL/WONT/DO/DONT <option>.  The client does NAWS and TTYPE (it
+ * says WILL), we do CHARSET and GMCP (it says DO).  We only answer when it
+ * changes something, or when refusing, so the two sides can't loop.
+ */
+static void telnet_option(struct descriptor_data *d, int command, int option)
+{
+  struct telnet_data *t = &d->telnet;
+  bitvector_t bit = telnet_bit(option);
+  int ours = (option == TELOPT_CHARSET || option == TELOPT_GMCP);
+
+  switch (command) {
+  case WILL:
+  case DO:
+    if (!bit || ours != (command == DO)) {
+      /* our own WILL ECHO from echo_off() coming back */
+      if (command == DO && option == TELOPT_ECHO)
+	break;
+      telnet_command(d, command == WILL ? DONT : WONT, option);
+      break;
+    }
+    if (IS_SET(t->opts, bit))
+      break;
+    SET_BIT(t->opts, bit);
+    if (!IS_SET(t->asked, bit))
+      telnet_command(d, command == WILL ? DO : WILL, option);
+    REMOVE_BIT(t->asked, bit);
+    telnet_start(d, option);
+    break;
+
+  case WONT:
+  case DONT:
+    if (!bit || !IS_SET(t->opts | t->asked, bit))
+      break;
+    if (IS_SET(t->opts, bit) && !IS_SET(t->asked, bit))
+      telnet_command(d, command == WONT ? DONT : WONT, option);
+    REMOVE_BIT(t->opts, bit);
+    REMOVE_BIT(t->asked, bit);
+    break;
+  }
+}
+
+/* copy a name out of a subnegotiation, keeping the printable part */
+static void telnet_name(char *dest, const unsigned char *src, int length)
+{
+  int i, j;
+
+  for (i = j = 0; i < length && j < TELNET_NAME_LENGTH - 1; i++)
+    if (isascii(src[i]) && isprint(src[i]))
+      dest[j++] = src[i];
+  dest[j] = '\0';
+}
+
+/* IAC SB <option> ... IAC SE */
+static void telnet_subnegotiation(struct descriptor_data *d)
+{
+  struct telnet_data *t = &d->telnet;
+
+  switch (t->option) {
+  case TELOPT_NAWS:
+    if (t->sb_length >= 4) {
+      t->cols = (t->sb[0] << 8) | t->sb[1];
+      t->rows = (t->sb[2] << 8) | t->sb[3];
+    }
+    break;
+  case TELOPT_TTYPE:
+    if (t->sb_length > 0 && t->sb[0] == TELQUAL_IS)
+      telnet_name(t->ttype, t->sb + 1, t->sb_length - 1);
+    break;
+  case TELOPT_CHARSET:
+    if (t->sb_length > 0 && t->sb[0] == CHARSET_ACCEPTED)
+      telnet_name(t->charset, t->sb + 1, t->sb_length - 1);
+    else if (t->sb_length > 0 && t->sb[0] == CHARSET_REJECTED)
+      *t->charset = '\0';
+    break;
+  case TELOPT_GMCP:
+    if (IS_SET(t->opts, TELNET_GMCP))
+      gmcp_receive(d);
+    break;
+  }
+}
+
+/* ask a new client about the options we'd like */
+void telnet_negotiate(struct descriptor_data *d)
+{
+  char seq[16];
+
+  snprintf(seq, sizeof(seq), "%c%c%c%c%c%c%c%c%c%c%c%c", IAC, DO, TELOPT_NAWS,
+	IAC, DO, TELOPT_TTYPE, IAC, WILL, TELOPT_CHARSET, IAC, WILL, TELOPT_GMCP);
+  telnet_send(d, seq);
+  d->telnet.asked = TELNET_NAWS | TELNET_TTYPE | TELNET_CHARSET | TELNET_GMCP;
+}
+
+/* a name as one word for telnet_save(): spaces as '_', "-" for none */
+static void telnet_word(char *dest, const char *name)
+{
+  if (!*name)
+    strcpy(dest, "-");	/* strcpy: OK (dest:TELNET_NAME_LENGTH) */
+  else
+    for (; (*dest = (*name == ' ' ? '_' : *name)) != '\0'; dest++, name++)
+      ;
+}
+
+/*
+ * What a client has agreed to, as a line of text for a copyover to take
+ * to the new process.  That carries on with it rather than asking again:
+ * a client that has already said yes needn't answer a second time, and
+ * GMCP would go quiet.
+ */
+void telnet_save(struct descriptor_data *d, char *buf, size_t size)
+{
+  char ttype[TELNET_NAME_LENGTH], charset[TELNET_NAME_LENGTH];
+
+  telnet_word(ttype, d->telnet.ttype);
+  telnet_word(charset, d->telnet.charset);
+  snprintf(buf, size, "%lu %d %d %d %d %s %s", d->telnet.opts,
+	d->telnet.cols, d->telnet.rows, d->gmcp.modules, d->gmcp.supports,
+	ttype, charset);
+}
+
+/* the other end of telnet_save(); with no state, negotiate afresh */
+void telnet_restore(struct descriptor_data *d, const char *state)
+{
+  struct telnet_data *t = &d->telnet;
+  char ttype[TELNET_NAME_LENGTH], charset[TELNET_NAME_LENGTH], *p;
+  bitvector_t opts;
+  int cols, rows, modules, supports;
+
+  if (!state || sscanf(state, "%lu %d %d %d %d %39s %39s", &opts, &cols,
+	&rows, &modules, &supports, ttype, charset) != 7) {
+    telnet_negotiate(d);
+    return;
+  }
+
+  t->opts = opts & (TELNET_NAWS | TELNET_TTYPE | TELNET_CHARSET | TELNET_GMCP);
+  t->asked = 0;
+  t->cols = cols;
+  t->rows = rows;
+  for (p = ttype; *p; p++)
+    if (*p == '_')
+      *p = ' ';
+  for (p = charset; *p; p++)
+    if (*p == '_')
+      *p = ' ';
+  strlcpy(t->ttype, strcmp(ttype, "-") ? ttype : "", sizeof(t->ttype));
+  strlcpy(t->charset, strcmp(charset, "-") ? charset : "", sizeof(t->charset));
+
+  /* the new process has told it nothing yet: everything goes again */
+  if (IS_SET(t->opts, TELNET_GMCP)) {
+    d->gmcp.modules = modules & GMCP_ALL;
+    d->gmcp.supports = (supports != 0);
+    gmcp_forget(&d->gmcp, GMCP_ALL);
+  }
+}
+
+/*
+ * Take the telnet commands out of len bytes of input in buf, acting on
+ * them, and return how many bytes of text are left at the front of buf.
+ * An erase character or erase line command becomes a backspace or a ^U
+ * in the text, for the line assembler to act on.
+ */
+size_t telnet_filter(struct descriptor_data *d, char *buf, size_t len)
+{
+  struct telnet_data *t = &d->telnet;
+  unsigned char *in = (unsigned char *) buf, *end = in + len;
+  char *out = buf;
+  int c;
+
+  /* the usual case: text with no command in it or under way */
+  if (t->state == TS_DATA && !memchr(buf, IAC, len))
+    return (len);
+
+  for (; in < end; in++) {
+    c = *in;
+    switch (t->state) {
+    case TS_DATA:
+      if (c == IAC)
+	t->state = TS_IAC;
+      else
+	*(out++) = c;
+      break;
+
+    case TS_IAC:
+      t->state = TS_DATA;
+      if (c == IAC) {		/* a quoted 255 */
+	*(out++) = c;
+	break;
+      }
+      d->in_stats.telnet++;
+      switch (c) {
+      case WILL:
+      case WONT:
+      case DO:
+      case DONT:
+	t->command = c;
+	t->state = TS_OPTION;
+	break;
+      case SB:
+	t->state = TS_SB_OPTION;
+	break;
+      case EC:
+	*(out++) = '\b';
+	break;
+      case EL:
+	*(out++) = '\025';	/* ^U */
+	break;
+      }
+      break;
+
+    case TS_OPTION:
+      telnet_option(d, t->command, c);
+      t->state = TS_DATA;
+      break;
+
+    case TS_SB_OPTION:
+      t->option = c;
+      t->sb_length = 0;
+      t->state = TS_SB;
+      break;
+
+    case TS_SB:
+      if (c == IAC)
+	t->state = TS_SB_IAC;
+      else if (t->sb_length < TELNET_SB_LENGTH)
+	t->sb[t->sb_length++] = c;
+      break;
+
+    case TS_SB_IAC:
+      if (c == IAC) {		/* a quoted 255 inside it */
+	if (t->sb_length < TELNET_SB_LENGTH)
+	  t->sb[t->sb_length++] = c;
+	t->state = TS_SB;
+	break;
+      }
+      /* IAC SE ends it; anything else is a broken client: end it anyway */
+      if (c == SE)
+	telnet_subnegotiation(d);
+      t->state = TS_DATA;
+      break;
+    }
+  }
+
+  return (out - buf);
+}
+
+
+/* ******************************************************************
+*  GMCP                                                             *
+****************************************************************** */
+
+/* the client is to be told all of these afresh */
+static void gmcp_forget(struct gmcp_data *g, int bits)
+{
+  if (IS_SET(bits, GMCP_VITALS))
+    g->hit = g->max_hit = g->mana = g->max_mana = -1;
+  if (IS_SET(bits, GMCP_COMBAT)) {
+    g->enemy = -1;
+    g->enemy_hit = -1;
+  }
+  if (IS_SET(bits, GMCP_ROOM))
+    g->room = NOWHERE;
+  SET_BIT(g->dirty, bits);
+}
+
+
+/* the GMCP_x for the modules named in a Core.Supports list */
+static int gmcp_modules(const char *list)
+{
+  char name[TELNET_NAME_LENGTH];
+  int bits = 0, i;
+
+  while ((list = strchr(list, '"')) != NULL) {
+    for (list++, i = 0; *list && *list != '"'; list++)
+      if (i < TELNET_NAME_LENGTH - 1)
+	name[i++] = *list;
+    name[i] = '\0';
+    if (*list)
+      list++;
+
+    /* "Char 1", "Char.Vitals 1": we only go by the top package */
+    name[strcspn(name, " .")] = '\0';
+    if (!str_cmp(name, "Char"))
+      bits |= GMCP_VITALS | GMCP_COMBAT;
+    else if (!str_cmp(name, "Room"))
+      bits |= GMCP_ROOM;
+  }
+  return (bits);
+}
+
+
+/*
+ * IAC SB GMCP <message> IAC SE from the client.  All we listen to is
+ * Core.Supports, saying which packages it wants; one that never says is
+ * sent them all.  What it has just taken up is sent in full.
+ */
+static void gmcp_receive(struct descriptor_data *d)
+{
+  struct gmcp_data *g = &d->gmcp;
+  char msg[TELNET_SB_LENGTH + 1], *data;
+  int before = g->supports ? g->modules : GMCP_ALL, bits;
+
+  memcpy(msg, d->telnet.sb, d->telnet.sb_length);
+  msg[d->telnet.sb_length] = '\0';
+  data = msg + strcspn(msg, " ");
+  if (*data)
+    *(data++) = '\0';
+  bits = gmcp_modules(data);
+
+  if (!str_cmp(msg, "Core.Supports.Set"))
+    g->modules = bits;
+  else if (!str_cmp(msg, "Core.Supports.Add"))
+    g->modules |= bits;
+  else if (!str_cmp(msg, "Core.Supports.Remove"))
+    g->modules &= ~bits;
+  else
+    return;
+
+  g->supports = TRUE;
+  gmcp_forget(g, g->modules & ~before);
+}
+
+
+/*
+ * Put src into dest as a JSON string, quotes and all.  Colour codes come
+ * out as they would for a player with colour off, and anything that isn't
+ * printable ASCII is left out, which also keeps IAC out of the message.
+ */
+static size_t gmcp_string(char *dest, size_t size, const char *src)
+{
+  size_t len = 0;
+
+  dest[len++] = '"';
+  for (; src && *src && len + 3 < size; src++) {
+    if (*src == '@' && *(++src) != '@') {
+      if (!*src)
+	break;
+      continue;
+    }
+    if (!isascii(*src) || !isprint(*src))
+      continue;
+    if (*src == '"' || *src == '\\') {
+      if (len + 4 >= size)
+	break;
+      dest[len++] = '\\';
+    }
+    dest[len++] = *src;
+  }
+  dest[len++] = '"';
+  dest[len] = '\0';
+
+  return (len);
+}
+
+
+/* add "key":value to the object being built in msg */
+static void gmcp_int(char *msg, size_t size, const char *key, int value)
+{
+  size_t len = strlen(msg);
+
+  snprintf(msg + len, size - len, "%s\"%s\":%d",
+	msg[len - 1] == '{' ? "" : ",", key, value);
+}
+
+
+/* queue len bytes to be written: all of them, or none */
+static int gmcp_queue_raw(struct descriptor_data *d, const char *seq, int len)
+{
+  struct gmcp_data *g = &d->gmcp;
+
+  if (g->pending + len > GMCP_BUFSIZE)
+    return (FALSE);
+  memcpy(g->out + g->pending, seq, len);
+  g->pending += len;
+
+  return (TRUE);
+}
+
+/* queue IAC SB GMCP <msg> IAC SE to be written: all of it, or none */
+static int gmcp_queue(struct descriptor_data *d, const char *msg)
+{
+  char seq[GMCP_BUFSIZE];
+  int len = strlen(msg);
+
+  if (len + 5 > GMCP_BUFSIZE)
+    return (FALSE);
+
+  seq[0] = (char) IAC;
+  seq[1] = (char) SB;
+  seq[2] = (char) TELOPT_GMCP;
+  memcpy(seq + 3, msg, len);
+  seq[len + 3] = (char) IAC;
+  seq[len + 4] = (char) SE;
+
+  return (gmcp_queue_raw(d, seq, len + 5));
+}
+
+
+/*
+ * Each of these sends what has changed in its message since the client
+ * was last told, if anything.  They return FALSE if there was no room to
+ * queue it; what the client was told isn't updated then, so the same
+ * changes are looked for again next time.
+ */
+static int gmcp_vitals(struct descriptor_data *d, struct char_data *ch)
+{
+  struct gmcp_data *g = &d->gmcp;
+  char msg[MAX_INPUT_LENGTH];
+
+  strcpy(msg, "Char.Vitals {");	/* strcpy: OK */
+  if (GET_HIT(ch) != g->hit)
+    gmcp_int(msg, sizeof(msg), "hp", GET_HIT(ch));
+  if (GET_MAX_HIT(ch) != g->max_hit)
+    gmcp_int(msg, sizeof(msg), "maxhp", GET_MAX_HIT(ch));
+  if (GET_MANA(ch) != g->mana)
+    gmcp_int(msg, sizeof(msg), "mana", GET_MANA(ch));
+  if (GET_MAX_MANA(ch) != g->max_mana)
+    gmcp_int(msg, sizeof(msg), "maxmana", GET_MAX_MANA(ch));
+
+  if (msg[strlen(msg) - 1] == '{')
+    return (TRUE);
+  strcat(msg, "}");	/* strcat: OK */
+  if (!gmcp_queue(d, msg))
+    return (FALSE);
+
+  g->hit = GET_HIT(ch);
+  g->max_hit = GET_MAX_HIT(ch);
+  g->mana = GET_MANA(ch);
+  g->max_mana = GET_MAX_MANA(ch);
+  return (TRUE);
+}
+
+
+static int gmcp_combat(struct descriptor_data *d, struct char_data *ch)
+{
+  struct gmcp_data *g = &d->gmcp;
+  struct char_data *enemy = FIGHTING(ch);
+  char msg[MAX_INPUT_LENGTH];
+  long id = 0;
+  int hit = 0;
+  size_t len;
+
+  if (enemy) {
+    id = GET_ID(enemy);
+    if (GET_MAX_HIT(enemy) > 0)
+      hit = MIN(100, MAX(0, 100 * GET_HIT(enemy) / GET_MAX_HIT(enemy)));
+  }
+  if (id == g->enemy && hit == g->enemy_hit)
+    return (TRUE);
+
+  strcpy(msg, "Char.Combat {");	/* strcpy: OK */
+  if (id != g->enemy) {
+    len = strlen(msg);
+    len += snprintf(msg + len, sizeof(msg) - len, "\"enemy\":");
+    gmcp_string(msg + len, sizeof(msg) - len, enemy ? GET_NAME(enemy) : "");
+  }
+  if (enemy)
+    gmcp_int(msg, sizeof(msg), "enemyhp", hit);
+  strcat(msg, "}");	/* strcat: OK */
+  if (!gmcp_queue(d, msg))
+    return (FALSE);
+
+  g->enemy = id;
+  g->enemy_hit = hit;
+  return (TRUE);
+}
+
+
+/*
+ * Every exit with a room behind it is listed, closed or not, so the
+ * message only changes with the room.  The names are cut short enough
+ * that all of it fits in msg.
+ */
+static int gmcp_room(struct descriptor_data *d, struct char_data *ch)
+{
+  struct gmcp_data *g = &d->gmcp;
+  struct room_direction_data *exit;
+  room_rnum room = IN_ROOM(ch);
+  char msg[GMCP_BUFSIZE];
+  size_t len;
+  int door, any = FALSE;
+
+  if (room == NOWHERE || world[room].number == g->room)
+    return (TRUE);
+
+  len = snprintf(msg, sizeof(msg), "Room.Info {\"num\":%d,\"name\":",
+	world[room].number);
+  len += gmcp_string(msg + len, GMCP_STRING_LENGTH, world[room].name);
+  len += snprintf(msg + len, sizeof(msg) - len, ",\"zone\":");
+  len += gmcp_string(msg + len, GMCP_STRING_LENGTH, zone_table[world[room].zone].name);
+  len += snprintf(msg + len, sizeof(msg) - len, ",\"exits\":{");
+  for (door = 0; door < NUM_OF_DIRS; door++) {
+    if (!(exit = world[room].dir_option[door]) || exit->to_room == NOWHERE)
+      continue;
+    len += snprintf(msg + len, sizeof(msg) - len, "%s\"%s\":%d", any ? "," : "",
+	dirs[door], world[exit->to_room].number);
+    any = TRUE;
+  }
+  strcat(msg, "}}");	/* strcat: OK */
+  if (!gmcp_queue(d, msg))
+    return (FALSE);
+
+  g->room = world[room].number;
+  return (TRUE);
+}
+
+
+/*
+ * ch's hit points have changed: that goes to its own client, and to the
+ * clients of those fighting it, whose Char.Combat shows how it's doing.
+ */
+void gmcp_hit_changed(struct char_data *ch)
+{
+  struct char_data *tch;
+
+  GMCP_DIRTY(ch, GMCP_VITALS);
+  if (IN_ROOM(ch) != NOWHERE)
+    for (tch = world[IN_ROOM(ch)].people; tch; tch = tch->next_in_room)
+      if (FIGHTING(tch) == ch)
+	GMCP_DIRTY(tch, GMCP_COMBAT);
+}
+
+
+/*
+ * Run once a pass for a descriptor with GMCP messages marked or waiting
+ * to be written: queue what has changed in those marked, then write as
+ * much as the socket will take.  Returns -1 if the socket has failed.
+ */
+int gmcp_update(struct descriptor_data *d)
+{
+  struct gmcp_data *g = &d->gmcp;
+  struct char_data *ch = d->character;
+  ssize_t written;
+
+  /* what's queued still goes if it was turned off: there may be replies */
+  if (!IS_SET(d->telnet.opts, TELNET_GMCP))
+    g->dirty = 0;
+
+  if (g->written) {
+    memmove(g->out, g->out + g->written, g->pending - g->written);
+    g->pending -= g->written;
+    g->written = 0;
+  }
+
+  g->dirty &= g->supports ? g->modules : GMCP_ALL;
+  if (g->dirty && ch && STATE(d) == CON_PLAYING) {
+    if (IS_SET(g->dirty, GMCP_VITALS) && gmcp_vitals(d, ch))
+      REMOVE_BIT(g->dirty, GMCP_VITALS);
+    if (IS_SET(g->dirty, GMCP_COMBAT) && gmcp_combat(d, ch))
+      REMOVE_BIT(g->dirty, GMCP_COMBAT);
+    if (IS_SET(g->dirty, GMCP_ROOM) && gmcp_room(d, ch))
+      REMOVE_BIT(g->dirty, GMCP_ROOM);
+  }
+
+  if (!g->pending)
+    return (0);
+  if ((written = perform_socket_write(d->descriptor, g->out, g->pending)) < 0) {
+    perror("SYSERR: Write to socket");
+    return (-1);
+  }
+  if ((g->written = written) == g->pending)
+    g->pending = g->written = 0;
+
+  return (0);
+}
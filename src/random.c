@@ -26,66 +26,139 @@
 /***************************************************************************/
 
 /*
+ * The Park and Miller generator that used to live here has given way to
+ * xoshiro128** (David Blackman and Sebastiano Vigna, 2018, public domain):
+ * four 32-bit words of state, a few shifts and xors a number, and full
+ * 32-bit output.  It assumes a 32-bit unsigned int.
  *
- * This program is public domain and was written by William S. England
- * (Oct 1988).  It is based on an article by:
- *
- * Stephen K. Park and Keith W. Miller. RANDOM NUMBER GENERATORS:
- * GOOD ONES ARE HARD TO FIND. Communications of the ACM,
- * New York, NY.,October 1988 p.1192
+ * There is one generator per stream (RNG_xxx in utils.h).  Combat, mob
+ * AI, scripts and zone resets each switch to their own stream with
+ * rng_use() and back again, so how many numbers one of them draws
+ * doesn't change what the others get.  circle_srandom() seeds them all
+ * from one number, which is logged at boot; starting the game again with
+ * -R <seed> deals the same numbers to each stream for a benchmark or to
+ * chase a bug.
+ */
 
- The following is a portable c program for generating random numbers.
- The modulus and multipilier have been extensively tested and should
- not be changed except by someone who is a professional Lehmer generator
- writer.  THIS GENERATOR REPRESENTS THE MINIMUM STANDARD AGAINST WHICH
- OTHER GENERATORS SHOULD BE JUDGED. ("Quote from the referenced article's
- authors. WSE" )
-*/
+#include "conf.h"
+#include "sysdep.h"
 
-#define	m  (unsigned long)2147483647
-#define	q  (unsigned long)127773
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "interpreter.h"
 
-#define	a (unsigned int)16807
-#define	r (unsigned int)2836
+extern struct config_data config_info;
 
-/*
-** F(z)	= (az)%m
-**	= az-m(az/m)
-**
-** F(z)  = G(z)+mT(z)
-** G(z)  = a(z%q)- r(z/q)
-** T(z)  = (z/q) - (az/m)
-**
-** F(z)  = a(z%q)- rz/q+ m((z/q) - a(z/m))
-** 	 = a(z%q)- rz/q+ m(z/q) - az
-*/
+static struct rng_state rng_streams[NUM_RNG_STREAMS];
+static struct rng_state *rng_cur = &rng_streams[RNG_GENERAL];
+static int rng_cur_stream = RNG_GENERAL;
+static unsigned long rng_master_seed = 0;
 
-static unsigned long seed;
+static const char *rng_stream_names[NUM_RNG_STREAMS] = {
+  "general", "combat", "ai", "scripts", "loot"
+};
 
-/* local functions */
-void circle_srandom(unsigned long initial_seed);
-unsigned long circle_random(void);
+static unsigned int rotl(unsigned int x, int k)
+{
+  return ((x << k) | (x >> (32 - k)));
+}
 
+/* spreads a seed over the state words; never leaves them all zero */
+static unsigned int next_seed_word(unsigned int *x)
+{
+  unsigned int z = (*x += 0x9E3779B9);
 
-void circle_srandom(unsigned long initial_seed)
+  z = (z ^ (z >> 16)) * 0x85EBCA6B;
+  z = (z ^ (z >> 13)) * 0xC2B2AE35;
+  return (z ^ (z >> 16));
+}
+
+void rng_seed(int stream, unsigned long seed)
 {
-    seed = initial_seed; 
+  struct rng_state *st = &rng_streams[stream];
+  unsigned int x = (unsigned int) (seed ^ ((seed >> 16) >> 16));
+  int i;
+
+  for (i = 0; i < 4; i++)
+    st->s[i] = next_seed_word(&x);
+  if (!(st->s[0] | st->s[1] | st->s[2] | st->s[3]))
+    st->s[0] = 1;
+  st->seed = seed;
+  st->draws = 0;
 }
 
+/* seed every stream, each from the one seed and its own number */
+void circle_srandom(unsigned long initial_seed)
+{
+  int i;
+
+  rng_master_seed = initial_seed;
+  for (i = 0; i < NUM_RNG_STREAMS; i++)
+    rng_seed(i, initial_seed + i * 0x632BE5ABUL);
+}
 
 unsigned long circle_random(void)
 {
-   int lo, hi, test;
+  unsigned int *s = rng_cur->s;
+  unsigned int result = rotl(s[1] * 5, 7) * 9;
+  unsigned int t = s[1] << 9;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 11);
+
+  rng_cur->draws++;
+  return (result);
+}
 
-    hi   = seed/q;
-    lo   = seed%q;
+/* draw from 'stream' from now on; returns the stream to switch back to */
+int rng_use(int stream)
+{
+  int was = rng_cur_stream;
 
-    test = a*lo - r*hi;
+  rng_cur_stream = stream;
+  rng_cur = &rng_streams[stream];
+  return (was);
+}
 
-    if (test > 0)
-	seed = test;
-    else
-	seed = test+ m;
+/* for a benchmark that reseeds a stream and then puts it back */
+void rng_save(int stream, struct rng_state *st)
+{
+  *st = rng_streams[stream];
+}
 
-    return (seed);
+void rng_restore(int stream, const struct rng_state *st)
+{
+  rng_streams[stream] = *st;
+}
+
+/* show random [seed <number>] */
+void rng_report(struct char_data *ch, char *value, char *arg)
+{
+  int i;
+
+  skip_spaces(&arg);
+  if (*value && is_abbrev(value, "seed")) {
+    if (!*arg || !is_number(arg)) {
+      send_to_char(ch, "Seed the random numbers with what?\r\n");
+      return;
+    }
+    circle_srandom(strtoul(arg, NULL, 10));
+    mudlog(BRF, LVL_GRGOD, TRUE, "(GC) %s seeded the random numbers with %lu.",
+	GET_NAME(ch), rng_master_seed);
+    send_to_char(ch, "%s", CONFIG_OK);
+    return;
+  }
+
+  send_to_char(ch, "Seeded with %lu; start with -R %lu to replay.\r\n"
+	"Stream             Seed                Draws\r\n"
+	"---------- ------------ --------------------\r\n",
+	rng_master_seed, rng_master_seed);
+  for (i = 0; i < NUM_RNG_STREAMS; i++)
+    send_to_char(ch, "%-10s %12lu %20lu\r\n", rng_stream_names[i],
+	rng_streams[i].seed, rng_streams[i].draws);
 }
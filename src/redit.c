@@ -118,7 +118,7 @@ mudlog(BRF, LVL_IMPL, TRUE, "OLC: %s tried to edit zone %d allowed zone %d",
     mudlog(CMP, MAX(LVL_BUILDER, GET_INVIS_LEV(ch)), TRUE, "OLC: %s saves room info for zone %d.", GET_NAME(ch), zone_table[OLC_ZNUM(d)].number);
     
     /* Save the rooms. */
-    save_rooms(OLC_ZNUM(d));
+    queue_olc_save(OLC_ZNUM(d), SL_WLD);
     
     /* Free the olc data from the descriptor. */
     free(d->olc);
@@ -297,7 +297,7 @@ void redit_save_internally(struct descriptor_data *d)
 
 void redit_save_to_disk(zone_vnum zone_num)
 {
-  save_rooms(zone_num);		/* :) */
+  queue_olc_save(zone_num, SL_WLD);
 }
 
 /*------------------------------------------------------------------------*/
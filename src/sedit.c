@@ -39,7 +39,7 @@ void sedit_save_internally(struct descriptor_data *d)
 
 void sedit_save_to_disk(int num)
 {
-  save_shops(num);
+  queue_olc_save(num, SL_SHP);
 }
 
 /*-------------------------------------------------------------------*\
@@ -158,7 +158,7 @@ send_to_char(ch, " You do not have permission to edit zone %d. Try zone %d.\r\n"
     /**************************************************************************/
     /** Save the shops to the shop file.                                     **/
     /**************************************************************************/
-    save_shops(OLC_ZNUM(d));
+    queue_olc_save(OLC_ZNUM(d), SL_SHP);
     
     /**************************************************************************/
     /** Free the OLC structure.                                              **/
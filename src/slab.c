@@ -0,0 +1,278 @@
+/* ************************************************************************
+*   File: slab.c                                        Part of CircleMUD *
+*  Usage: fixed-size pools for frequently allocated game structures       *
+*                                                                         *
+*  All rights reserved.  See license.doc for complete information.        *
+*                                                                         *
+*  Copyright (C) 1993, 94 by the Trustees of the Johns Hopkins University *
+*  CircleMUD is based on DikuMUD, Copyright (C) 1990, 1991.               *
+************************************************************************ */
+
+/*
+ * Characters, objects, affects, events, text blocks and trigger data are
+ * created and thrown away constantly: every zone reset, every spell and
+ * every line of input.  Instead of a calloc()/free() pair for each one,
+ * every structure type gets its own pool.  A pool carves large slabs into
+ * slots of one size and keeps the free slots on a list, so an allocation
+ * is a pointer pop and objects of the same type sit next to each other.
+ *
+ * Each slot carries a small header naming its pool and whether it is in
+ * use, which catches double frees and frees of memory that did not come
+ * from a pool.  With poisoning on, freed slots are filled with a pattern
+ * that is checked when the slot is handed out again, catching writes
+ * through stale pointers.
+ */
+
+#include "conf.h"
+#include "sysdep.h"
+
+#include "structs.h"
+#include "utils.h"
+#include "comm.h"
+#include "interpreter.h"
+
+#define SLAB_MAGIC	0x51ab
+#define SLOT_USED	1	/* handed out by slab_alloc()		*/
+#define SLOT_FREE	2	/* on the free list			*/
+#define SLOT_POISONED	3	/* on the free list, filled with poison	*/
+
+#define SLAB_POISON	0xa5	/* byte freed slots are filled with	*/
+#define SLAB_BYTES	16384	/* aim for slabs about this large	*/
+#define SLAB_MIN_SLOTS	8
+
+/* precedes every slot; the union keeps the object after it aligned */
+union slab_slot {
+  struct {
+    unsigned short magic;
+    unsigned char slab;
+    unsigned char state;
+  } hdr;
+  double align_d;
+  void *align_p;
+  long align_l;
+};
+
+#define SLOT_OBJ(slot)	((void *)((union slab_slot *)(slot) + 1))
+#define OBJ_SLOT(ptr)	((union slab_slot *)(ptr) - 1)
+
+struct slab_page {
+  struct slab_page *next;
+  char *mem;
+};
+
+struct slab_pool {
+  const char *name;
+  size_t size;			/* object size, set on first use	*/
+  size_t stride;		/* header + object, rounded up		*/
+  int per_slab;
+
+  struct slab_page *pages;
+  union slab_slot *free_list;	/* next link lives in the object area	*/
+
+  int slabs;
+  long in_use, peak;
+  unsigned long allocs, frees;
+  unsigned long poison_hits;	/* freed slots found written to		*/
+  unsigned long bad_frees;	/* double or foreign frees		*/
+};
+
+static struct slab_pool slab_pools[NUM_SLABS] = {
+  { "char_data" },
+  { "obj_data" },
+  { "affected_type" },
+  { "event" },
+  { "txt_block" },
+  { "trig_data" },
+  { "trig_var_data" },
+};
+
+#ifdef MEMORY_DEBUG
+int slab_poison = TRUE;
+#else
+int slab_poison = FALSE;
+#endif
+
+/* the link to the next free slot, stored where the object would be */
+#define NEXT_FREE(slot)	(*(union slab_slot **) SLOT_OBJ(slot))
+
+static void slab_grow(struct slab_pool *pool)
+{
+  struct slab_page *page;
+  union slab_slot *slot;
+  int i;
+
+  CREATE(page, struct slab_page, 1);
+  CREATE(page->mem, char, pool->stride * pool->per_slab);
+  page->next = pool->pages;
+  pool->pages = page;
+  pool->slabs++;
+
+  /* thread the new slots onto the free list in address order */
+  for (i = pool->per_slab - 1; i >= 0; i--) {
+    slot = (union slab_slot *) (page->mem + i * pool->stride);
+    slot->hdr.magic = SLAB_MAGIC;
+    slot->hdr.slab = pool - slab_pools;
+    slot->hdr.state = SLOT_FREE;
+    NEXT_FREE(slot) = pool->free_list;
+    pool->free_list = slot;
+  }
+}
+
+static void slab_setup(struct slab_pool *pool, size_t size)
+{
+  size_t align = sizeof(union slab_slot);
+
+  pool->size = MAX(size, sizeof(void *));
+  pool->stride = sizeof(union slab_slot) + pool->size;
+  pool->stride = (pool->stride + align - 1) / align * align;
+  pool->per_slab = MAX(SLAB_MIN_SLOTS, SLAB_BYTES / (int) pool->stride);
+}
+
+/* did anything write into a poisoned slot after it was freed? */
+static int slab_poison_intact(struct slab_pool *pool, union slab_slot *slot)
+{
+  unsigned char *p = (unsigned char *) SLOT_OBJ(slot) + sizeof(void *);
+  unsigned char *end = (unsigned char *) SLOT_OBJ(slot) + pool->size;
+
+  for (; p < end; p++)
+    if (*p != SLAB_POISON)
+      return (FALSE);
+  return (TRUE);
+}
+
+/* hand out a zeroed object of the given pool, like CREATE(x, type, 1) */
+void *slab_alloc(int slab, size_t size)
+{
+  struct slab_pool *pool;
+  union slab_slot *slot;
+
+  if (slab < 0 || slab >= NUM_SLABS) {
+    log("SYSERR: slab_alloc: invalid slab %d.", slab);
+    abort();
+  }
+  pool = &slab_pools[slab];
+
+  if (!pool->size)
+    slab_setup(pool, size);
+  else if (size > pool->size) {
+    log("SYSERR: slab_alloc: %lu bytes asked of the %s slab (%lu).",
+	(unsigned long) size, pool->name, (unsigned long) pool->size);
+    abort();
+  }
+
+  if (!pool->free_list)
+    slab_grow(pool);
+
+  slot = pool->free_list;
+  pool->free_list = NEXT_FREE(slot);
+
+  if (slot->hdr.state == SLOT_POISONED && !slab_poison_intact(pool, slot)) {
+    pool->poison_hits++;
+    log("SYSERR: slab %s: slot %p was written to after it was freed.",
+	pool->name, SLOT_OBJ(slot));
+  }
+
+  slot->hdr.state = SLOT_USED;
+  memset(SLOT_OBJ(slot), 0, pool->size);
+
+  pool->allocs++;
+  if (++pool->in_use > pool->peak)
+    pool->peak = pool->in_use;
+
+  return SLOT_OBJ(slot);
+}
+
+/* give back an object from slab_alloc() */
+void slab_free(void *ptr)
+{
+  struct slab_pool *pool;
+  union slab_slot *slot;
+
+  if (!ptr)
+    return;
+
+  slot = OBJ_SLOT(ptr);
+  if (slot->hdr.magic != SLAB_MAGIC || slot->hdr.slab >= NUM_SLABS) {
+    log("SYSERR: slab_free: %p did not come from a slab.", ptr);
+    return;
+  }
+  pool = &slab_pools[slot->hdr.slab];
+
+  if (slot->hdr.state != SLOT_USED) {
+    pool->bad_frees++;
+    log("SYSERR: slab %s: %p freed twice.", pool->name, ptr);
+    return;
+  }
+
+  if (slab_poison) {
+    memset((char *) ptr + sizeof(void *), SLAB_POISON, pool->size - sizeof(void *));
+    slot->hdr.state = SLOT_POISONED;
+  } else
+    slot->hdr.state = SLOT_FREE;
+
+  NEXT_FREE(slot) = pool->free_list;
+  pool->free_list = slot;
+
+  pool->frees++;
+  pool->in_use--;
+}
+
+/* log anything still handed out; called at shutdown after destroy_db() */
+void slab_check(void)
+{
+  int i;
+
+  for (i = 0; i < NUM_SLABS; i++)
+    if (slab_pools[i].in_use)
+      log("Slab %s: %ld objects still in use at shutdown.",
+	  slab_pools[i].name, slab_pools[i].in_use);
+}
+
+void free_slabs(void)
+{
+  struct slab_page *page;
+  int i;
+
+  for (i = 0; i < NUM_SLABS; i++) {
+    while ((page = slab_pools[i].pages) != NULL) {
+      slab_pools[i].pages = page->next;
+      free(page->mem);
+      free(page);
+    }
+    slab_pools[i].free_list = NULL;
+    slab_pools[i].slabs = 0;
+    slab_pools[i].in_use = 0;
+  }
+}
+
+/* show slabs [poison] */
+void slab_report(struct char_data *ch, char *arg)
+{
+  struct slab_pool *pool;
+  size_t len;
+  int i;
+  char buf[MAX_STRING_LENGTH];
+
+  if (*arg && is_abbrev(arg, "poison")) {
+    slab_poison = !slab_poison;
+    send_to_char(ch, "Slab poisoning is now %s.\r\n", ONOFF(slab_poison));
+    return;
+  }
+
+  len = snprintf(buf, sizeof(buf),
+	"Slab poisoning: %s\r\n"
+	"Pool           Size  Slabs  In use    Peak       Allocs        Frees  Bad\r\n"
+	"------------- ----- ------ ------- ------- ------------ ------------ ----\r\n",
+	ONOFF(slab_poison));
+
+  for (i = 0; i < NUM_SLABS && len < sizeof(buf); i++) {
+    pool = &slab_pools[i];
+    len += snprintf(buf + len, sizeof(buf) - len,
+	"%-13s %5lu %6d %7ld %7ld %12lu %12lu %4lu\r\n",
+	pool->name, (unsigned long) pool->size, pool->slabs, pool->in_use,
+	pool->peak, pool->allocs, pool->frees, pool->poison_hits + pool->bad_frees);
+  }
+
+  if (len < sizeof(buf))
+    send_to_char(ch, "%s", buf);
+}
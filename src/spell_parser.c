@@ -126,7 +126,7 @@ void say_spell(struct char_data *ch, int spellnum, struct char_data *tch,
     else
       format = "$n stares at $N and utters the words, '%s'.";
   } else if (tobj != NULL &&
-	     ((IN_ROOM(tobj) == IN_ROOM(ch)) || (tobj->carried_by == ch)))
+	     ((OBJ_IN_ROOM(tobj) == IN_ROOM(ch)) || (tobj->carried_by == ch)))
     format = "$n stares at $p and utters the words, '%s'.";
   else
     format = "$n utters the words, '%s'.";
@@ -649,6 +649,7 @@ ACMD(do_cast)
 	GET_MANA(ch) = MAX(0, MIN(GET_MAX_MANA(ch), GET_MANA(ch) - mana));
     }
   }
+  GMCP_DIRTY(ch, GMCP_VITALS);
 }
 
 
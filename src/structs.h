@@ -90,6 +90,13 @@
 #define ROOM_BFS_MARK		(1 << 15)  /* (R) breath-first srch mrk	*/
 
 
+/* Who is in a room: used in room_data.census.occupants */
+#define OCC_AGGRESSIVE		(1 << 0)   /* a mob that attacks on sight */
+#define OCC_SCRIPTED		(1 << 1)   /* a mob with triggers/memory */
+#define OCC_SWITCHED		(1 << 2)   /* a mob someone switched into */
+#define OCC_HIDDEN		(1 << 3)   /* someone hidden or invisible */
+
+
 /* Exit info: used in room_data.dir_option.exit_info */
 #define EX_ISDOOR		(1 << 0)   /* Exit is a door		*/
 #define EX_CLOSED		(1 << 1)   /* The door is closed	*/
@@ -189,6 +196,9 @@
 #define MOB_NOBLIND	 (1 << 17) /* Mob can't be blinded		*/
 #define MOB_NOTDEADYET   (1 << 18) /* (R) Mob being extracted.		*/
 
+#define MOB_AGGR_TO_ALIGN (MOB_AGGR_EVIL | MOB_AGGR_NEUTRAL | MOB_AGGR_GOOD)
+#define MOB_ATTACKS_ON_SIGHT (MOB_AGGRESSIVE | MOB_AGGR_TO_ALIGN | MOB_MEMORY)
+
 
 /* Preference flags: used by char_data.player_specials.pref */
 #define PRF_BRIEF       (1 << 0)  /* Room descs won't normally be shown	*/
@@ -650,6 +660,12 @@ struct obj_data {
 
    struct obj_data *next_content; /* For 'contains' lists             */
    struct obj_data *next;         /* For the object list              */
+   struct obj_data *next_instance; /* Same prototype, see obj_index   */
+   struct obj_data *prev_instance;
+
+   /* a running timer; see set_obj_timer() in limits.c */
+   unsigned long timer_due;	  /* timer_hours it runs out, 0 if not set */
+   struct obj_data *timer_next, **timer_pprev;
 };
 /* ======================================================================= */
 
@@ -694,6 +710,33 @@ struct rent_info {
 /* room-related structures ************************************************/
 
 
+/*
+ * Summary of the command triggers a command typed here could run into:
+ * one bit per first letter of their arguments.  Built lazily and thrown
+ * away (stamp = 0) when something with command triggers moves in or out.
+ */
+struct cmd_filter {
+   unsigned int mask;           /* CMD_FILTER_ bits, see dg_scripts.h */
+   int trigs;                   /* command triggers covered by mask   */
+   unsigned long stamp;         /* cmd_filter_stamp at build, 0=stale */
+};
+
+
+/*
+ * Who and what is in a room.  The counts are kept by char_to_room(),
+ * char_from_room(), obj_to_room() and obj_from_room(); the summary of
+ * the occupants is built by room_occupants() in handler.c.
+ */
+struct room_census {
+   int pcs;                     /* players in the room                */
+   int npcs;                    /* mobiles in the room                */
+   int objs;                    /* objects on the floor               */
+   int hidden;                  /* occupants hidden or invisible      */
+   bitvector_t occupants;       /* OCC_ bits, any of them             */
+   unsigned long stamp;         /* room_census_stamp at build, 0=stale */
+};
+
+
 struct room_direction_data {
    char	*general_description;       /* When look DIR.			*/
 
@@ -724,6 +767,10 @@ struct room_data {
 
    struct obj_data *contents;   /* List of items in room              */
    struct char_data *people;    /* List of NPC / PC in room           */
+
+   struct speech_index *speech; /* speech/act trigger matcher         */
+   struct cmd_filter cmd_filter; /* command triggers of room/occupants */
+   struct room_census census;   /* counts of who and what is here     */
 };
 /* ====================================================================== */
 
@@ -794,12 +841,10 @@ struct char_ability_data {
 };
 
 
-/* Char's points.  Used in char_file_u *DO*NOT*CHANGE* */
+/* Char's points; current hit and mana live in the hot slots (handler.c) */
 struct char_point_data {
-   sh_int mana;
-   sh_int max_mana;     /* Max mana for PC/NPC			   			*/
-   sh_int hit;
-   sh_int max_hit;      /* Max hit for PC/NPC                       */
+   sh_int max_mana;     /* Max mana for PC/NPC; mana is GET_MANA()	*/
+   sh_int max_hit;      /* Max hit for PC/NPC; hit is GET_HIT()	*/
    sh_int evasion;		/* Evasion rating of the Character 			*/
    sh_int attacks;		/* Number of attacks per round 				*/
    sh_int max_ammo;
@@ -826,20 +871,38 @@ struct char_point_data {
 struct char_special_data_saved {
    int	alignment;		/* +-1000 for alignments                */
    long	idnum;			/* player's idnum; -1 for mobiles	*/
-   long /*bitvector_t*/ act;	/* act flag for NPC's; player flag for PC's */
-
-   long /*bitvector_t*/	affected_by;
-				/* Bitvector for spells/skills affected by */
+   /* act/player flags and affected_by bits live in the hot slot */
    sh_int apply_saving_throw[5]; /* Saving throw (Bonuses)		*/
 };
 
 
+/*
+ * A reference to a character that goes invalid by itself when the
+ * character leaves the game; see ref_char() and deref_char() in handler.c.
+ * All zeroes is the null reference.
+ */
+struct char_ref {
+   int slot;			/* index into the character slot table	*/
+   unsigned int gen;		/* generation of the slot when taken	*/
+};
+
+
+/* the attacker's side of a hit, kept by combat_stats() in fight.c */
+struct combat_stats {
+   bool valid;			/* cleared by affect_total(), SET_SKILL() */
+   int thaco;			/* PCs only; a mob's depends on its victim */
+   int w_type;			/* attack type, 0 for the default	*/
+   int min_dam, max_dam;	/* damage range of a hit		*/
+   int crit_mult;		/* damage multiplier on a critical hit	*/
+   int max_crit;		/* one roll in this many is critical	*/
+   int attacks;			/* attacks a round			*/
+};
+
+
 /* Special playing constants shared by PCs and NPCs which aren't in pfile */
 struct char_special_data {
    struct char_data *fighting;	/* Opponent				*/
-   struct char_data *hunting;	/* Char hunted by this char		*/
-
-   byte position;		/* Standing, fighting, sleeping, etc.	*/
+   struct char_ref hunting;	/* Char hunted by this char		*/
 
    int	carry_weight;		/* Carried weight			*/
    byte carry_items;		/* Number of items carried		*/
@@ -936,6 +999,11 @@ struct affected_type {
    long /*bitvector_t*/	bitvector; /* Tells which bits to set (AFF_XXX) */
 
    struct affected_type *next;
+
+   /* set by affect_to_char(); see the timer wheel in magic.c */
+   unsigned long expires;	/* timer_hours it wears off, 0 if never	*/
+   struct char_data *holder;	/* whose affect this is			*/
+   struct affected_type *wheel_next, **wheel_pprev;
 };
 
 
@@ -950,9 +1018,8 @@ struct follow_type {
 struct char_data {
    int pfilepos;			 /* playerfile pos		  */
    mob_rnum nr;                          /* Mob's rnum			  */
-   room_rnum in_room;                    /* Location (real room number)	  */
+   int hot;				 /* slot of the hot fields	  */
    room_rnum was_in_room;		 /* location for linkdead people  */
-   int wait;				 /* wait for how many loops	  */
 
    struct char_player_data player;       /* Normal data                   */
    struct char_ability_data real_abils;	 /* Abilities without modifiers   */
@@ -969,6 +1036,7 @@ struct char_data {
    struct descriptor_data *desc;         /* NULL for mobiles              */
 
    long id;                            /* used by DG triggers - unique id */
+   int ref_slot;                       /* char_ref slot, 0 if none taken  */
    struct trig_proto_list *proto_script; /* list of default triggers      */
    struct script_data *script;         /* script info for the object      */
    struct script_memory *memory;       /* for mob memory triggers         */
@@ -976,12 +1044,19 @@ struct char_data {
    struct char_data *next_in_room;     /* For room->people - list         */
    struct char_data *next;             /* For either monster or ppl-list  */
    struct char_data *next_fighting;    /* For fighting list               */
+   struct combat_stats combat;         /* cached, see combat_stats()      */
+   struct char_data *next_instance;    /* Same prototype, see mob_index   */
+   struct char_data *prev_instance;
+   struct char_data *next_in_zone;     /* Mobs in the zone, see mobact.c  */
+   struct char_data *prev_in_zone;
 
    struct follow_type *followers;        /* List of chars followers       */
    struct char_data *master;             /* Who is char following?        */
 
    long pref;	                         /* unique session id */
    char *host;                           /* hostname copy     */
+
+   struct cmd_filter cmd_filter;         /* command triggers carried/worn */
 };
 /* ====================================================================== */
 
@@ -1031,6 +1106,104 @@ struct txt_q {
    struct txt_block *tail;
 };
 
+
+/*
+ * Lines a descriptor has typed and not yet run.  They are put together
+ * in place in a ring buffer from the input pool (comm.c), each ended by
+ * a NUL; head, tail and pos only ever count up and are masked to index.
+ */
+#define INPUT_RING_SIZE		8192	/* must be a power of two	*/
+
+struct input_ring {
+   struct txt_block *block;	/* buffer from the input pool		*/
+   unsigned int head;		/* start of the oldest whole line	*/
+   unsigned int tail;		/* start of the line being typed	*/
+   unsigned int pos;		/* end of the line being typed		*/
+   int lines;			/* whole lines waiting			*/
+   char newline;		/* CR or LF if that ended the last line	*/
+   byte truncated;		/* line being typed has grown too long	*/
+   byte discard;		/* line being typed is being dropped	*/
+};
+
+
+/* What to do with a line when a descriptor's input is full */
+#define INPUT_DROP_NEWEST	0	/* throw the new line away	*/
+#define INPUT_DROP_OLDEST	1	/* throw the oldest one away	*/
+#define INPUT_DISCONNECT	2	/* close the connection		*/
+#define NUM_INPUT_OVERFLOW	3
+
+/*
+ * A token bucket: it fills at a rate per second up to a few seconds'
+ * worth, and each byte or line taken costs a token.  Tokens are counted
+ * in PASSES_PER_SEC ths so a pulse's refill is a whole number.
+ */
+struct token_bucket {
+   long tokens;			/* what's in it, PASSES_PER_SEC per one	*/
+   unsigned long pulse;		/* pulse it was last filled up to	*/
+};
+
+
+/* how much a descriptor has sent us, and how fast */
+struct input_stats {
+   unsigned long bytes;		/* read from the socket			*/
+   unsigned long lines;		/* whole lines among them		*/
+   unsigned long telnet;	/* telnet commands among them		*/
+   time_t second;		/* second the counts below are for	*/
+   int sec_bytes, sec_lines;	/* read in that second			*/
+   int peak_bytes, peak_lines;	/* most read in any one second		*/
+   unsigned long dropped;	/* lines thrown away, input being full	*/
+   unsigned long throttled;	/* passes reading was put off for bytes	*/
+   byte flooding;		/* dropping lines since the queue emptied */
+};
+
+
+/* Telnet options a client has agreed to: descriptor_data.telnet.opts */
+#define TELNET_NAWS		(1 << 0)   /* tells us its window size	*/
+#define TELNET_TTYPE		(1 << 1)   /* tells us its terminal type	*/
+#define TELNET_CHARSET		(1 << 2)   /* agrees a character set	*/
+#define TELNET_GMCP		(1 << 3)   /* takes GMCP out-of-band data */
+
+#define TELNET_SB_LENGTH	256	/* longest subnegotiation kept	*/
+#define TELNET_NAME_LENGTH	40	/* terminal type, charset name	*/
+
+/* where a descriptor is in the telnet protocol; see protocol.c */
+struct telnet_data {
+   ubyte state;			/* TS_x, part of a command seen so far	*/
+   ubyte command;		/* WILL, WONT, DO or DONT being read	*/
+   ubyte option;		/* option being subnegotiated		*/
+   int sb_length;		/* bytes of it so far			*/
+   unsigned char sb[TELNET_SB_LENGTH];
+   bitvector_t opts;		/* TELNET_x the client agreed to	*/
+   bitvector_t asked;		/* TELNET_x we have asked about		*/
+   int cols, rows;		/* window size, 0 if never told		*/
+   char ttype[TELNET_NAME_LENGTH];	/* client's terminal type	*/
+   char charset[TELNET_NAME_LENGTH];	/* character set agreed on	*/
+};
+
+
+/* GMCP messages a client can be sent: descriptor_data.gmcp.dirty */
+#define GMCP_VITALS		(1 << 0)   /* Char.Vitals: hp and mana	*/
+#define GMCP_COMBAT		(1 << 1)   /* Char.Combat: who we fight	*/
+#define GMCP_ROOM		(1 << 2)   /* Room.Info: where we are	*/
+#define GMCP_ALL		(GMCP_VITALS | GMCP_COMBAT | GMCP_ROOM)
+
+#define GMCP_BUFSIZE		1024	/* GMCP waiting to be written	*/
+
+/* what a GMCP client was last told, and what has changed since; protocol.c */
+struct gmcp_data {
+   int dirty;			/* GMCP_x that may have changed		*/
+   int modules;			/* GMCP_x from its Core.Supports	*/
+   bool supports;		/* has it sent a Core.Supports yet?	*/
+   int hit, max_hit;		/* Char.Vitals as last sent		*/
+   int mana, max_mana;
+   long enemy;			/* Char.Combat: id of who we fight	*/
+   int enemy_hit;		/* and their hit points, in percent	*/
+   room_vnum room;		/* Room.Info: the room last sent	*/
+   int pending;			/* bytes in out[] ...			*/
+   int written;			/* ... and how many of them have gone	*/
+   char out[GMCP_BUFSIZE];
+};
+
 struct descriptor_data {
    socket_t	descriptor;	/* file descriptor for socket		*/
    char	host[HOST_LENGTH+1];	/* hostname				*/
@@ -1048,7 +1221,6 @@ struct descriptor_data {
    size_t max_str;	        /* maximum size of string in modify-str	*/
    long	mail_to;		/* name for mail system			*/
    int	has_prompt;		/* is the user at a prompt?             */
-   char	inbuf[MAX_RAW_INPUT_LENGTH];  /* buffer for raw input		*/
    char	last_input[MAX_INPUT_LENGTH]; /* the last input			*/
    char small_outbuf[SMALL_BUFSIZE];  /* standard output buffer		*/
    char *output;		/* ptr to the current output buffer	*/
@@ -1057,7 +1229,13 @@ struct descriptor_data {
    int  bufptr;			/* ptr to end of current output		*/
    int	bufspace;		/* space left in the output buffer	*/
    struct txt_block *large_outbuf; /* ptr to large buffer, if we need it */
-   struct txt_q input;		/* q of unprocessed input		*/
+   struct txt_q input;		/* q of expanded aliases to run first	*/
+   struct input_ring in_ring;	/* lines read and not yet run		*/
+   struct input_stats in_stats;	/* how fast input has come in		*/
+   struct token_bucket in_bytes;	/* bytes we'll read from it		*/
+   struct token_bucket in_lines;	/* lines we'll run from it		*/
+   struct telnet_data telnet;	/* telnet options and parser state	*/
+   struct gmcp_data gmcp;	/* out-of-band data for the client	*/
    struct txt_block *comms;     /* latest comms history.                */
    struct char_data *character;	/* linked to char			*/
    struct char_data *original;	/* original char if switched		*/
@@ -1188,6 +1366,9 @@ struct index_data {
 
    char *farg;         /* string argument for special function      */
    struct trig_data *proto;     /* for triggers... the trigger */
+   struct trig_prof_data *prof; /* for triggers... execution accounting */
+   struct char_data *mobs;      /* for mobs... live ones, newest first */
+   struct obj_data *objs;       /* for objects... live ones, newest first */
 };
 
 /* linked list for mob/object prototype trigger lists */
@@ -1277,6 +1458,15 @@ struct game_operation {
   int nameserver_is_slow;   /* Is the nameserver slow or fast?	  */
   int use_new_socials;      /* Use new or old socials file ?      */
   int auto_save_olc;        /* Does OLC save to disk right away ? */
+  int script_budget;        /* Usecs of scripts per pulse, 0 = none */
+  int mem_sample_rate;      /* Bytes between allocation samples   */
+  int zone_reset_budget;    /* Zone commands per pulse, 0 = all   */
+  int dormant_mob_pulses;   /* Mob passes per turn in empty zones */
+  int hibernate_minutes;    /* Empty minutes before a zone sleeps */
+  int input_byte_rate;      /* Bytes read per second, 0 = any     */
+  int input_line_rate;      /* Lines run per second, 0 = any      */
+  int input_queue_lines;    /* Lines one connection may queue     */
+  int input_overflow;       /* INPUT_x when its queue is full     */
   char *MENU;               /* The MAIN MENU.			  */
   char *WELC_MESSG;	    /* The welcome message.		  */
   char *START_MESSG;        /* The start msg for new characters.  */
@@ -1302,6 +1492,3 @@ struct config_data {
   struct autowiz_data    autowiz;	/* autowiz related stuff */
 };
 
-#ifdef MEMORY_DEBUG
-#include "zmalloc.h"
-#endif
@@ -43,17 +43,12 @@ int rand_number(int from, int to)
   }
 
   /*
-   * This should always be of the form:
-   *
-   *	((float)(to - from + 1) * rand() / (float)(RAND_MAX + from) + from);
-   *
-   * if you are using rand() due to historical non-randomness of the
-   * lower bits in older implementations.  We always use circle_random()
-   * though, which shouldn't have that problem. Mean and standard
-   * deviation of both are identical (within the realm of statistical
-   * identity) if the rand() implementation is non-broken.
+   * Scale the 32-bit draw onto the range with a multiply and a shift
+   * rather than a divide; like the old modulo it is a shade uneven for
+   * ranges that don't divide 2^32, far too little to matter here.
    */
-  return ((circle_random() % (to - from + 1)) + from);
+  return (from + (int) (((unsigned long long) circle_random() *
+	(unsigned int) (to - from + 1)) >> 32));
 }
 
 
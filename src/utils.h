@@ -14,6 +14,13 @@
 extern struct weather_data weather_info;
 extern FILE *logfile;
 
+/* a character's hot fields, indexed by ch->hot; see handler.c */
+extern room_rnum *hot_in_room;
+extern byte *hot_position;
+extern sh_int *hot_hit, *hot_mana;
+extern int *hot_wait;
+extern long *hot_act, *hot_affected_by;
+
 #define log			basic_mud_log
 
 #define READ_SIZE	256
@@ -53,8 +60,62 @@ int	strn_cmp(const char *arg1, const char *arg2, int n);
 #endif
 
 /* random functions in random.c */
+#define RNG_GENERAL	0	/* anything not listed below		*/
+#define RNG_COMBAT	1	/* perform_violence() and what it calls	*/
+#define RNG_AI		2	/* mobile_activity()			*/
+#define RNG_SCRIPT	3	/* triggers and script sweeps		*/
+#define RNG_LOOT	4	/* zone resets				*/
+#define NUM_RNG_STREAMS	5
+
+struct rng_state {
+  unsigned int s[4];		/* xoshiro128** state			*/
+  unsigned long seed;		/* what the stream was last seeded with	*/
+  unsigned long draws;		/* numbers drawn since then		*/
+};
+
 void circle_srandom(unsigned long initial_seed);
 unsigned long circle_random(void);
+int rng_use(int stream);
+void rng_seed(int stream, unsigned long seed);
+void rng_save(int stream, struct rng_state *st);
+void rng_restore(int stream, const struct rng_state *st);
+void rng_report(struct char_data *ch, char *value, char *arg);
+
+/* allocation tracker in memtrack.c */
+struct alloc_site;
+void	mem_track(void *ptr, size_t size, struct alloc_site **cache, const char *file, int line);
+void	mem_untrack(void *ptr);
+void	mem_track_free(void *ptr);
+char	*mem_track_strdup(const char *str, const char *file, int line);
+void	mem_report(struct char_data *ch, char *arg);
+void	mem_check(void);
+
+/* fixed-size pools in slab.c */
+void	*slab_alloc(int slab, size_t size);
+void	slab_free(void *ptr);
+void	slab_check(void);
+void	free_slabs(void);
+void	slab_report(struct char_data *ch, char *arg);
+
+/* pathfinding in graph.c */
+int	find_first_step(room_rnum src, room_rnum target);
+int	path_route(room_rnum src, room_rnum target, int *route, int max);
+void	path_exits_changed(void);
+void	path_doors_changed(void);
+void	path_free(void);
+void	path_report(struct char_data *ch, char *value, char *arg);
+
+/* combat in fight.c */
+void	combat_report(struct char_data *ch, char *value, char *arg);
+
+/* object timers in limits.c */
+void	set_obj_timer(struct obj_data *obj, int hours);
+int	obj_timer_left(struct obj_data *obj);
+void	obj_timer_clear(struct obj_data *obj);
+void	timer_report(struct char_data *ch, char *value, char *arg);
+
+/* the character sweep benchmark in limits.c */
+void	sweep_report(struct char_data *ch, char *value, char *arg);
 
 /* undefine MAX and MIN so that our functions are used instead */
 #ifdef MAX
@@ -152,15 +213,55 @@ void	update_pos(struct char_data *victim);
 /* memory utils **********************************************************/
 
 
+/*
+ * CREATE, RECREATE, strdup() and free() report to the allocation tracker
+ * in memtrack.c, which counts calls and bytes per file:line and samples
+ * live memory for 'show memory'.  The standalone utilities don't link it.
+ */
+#ifndef CIRCLE_UTIL
+#define MEM_TRACK(result, size)  do {\
+	static struct alloc_site *site_;	\
+	mem_track((result), (size), &site_, __FILE__, __LINE__); } while(0)
+
+#undef free
+#define free(ptr)	mem_track_free(ptr)
+#undef strdup
+#define strdup(str)	mem_track_strdup((str), __FILE__, __LINE__)
+#else
+#define MEM_TRACK(result, size)
+#define mem_untrack(ptr)
+#endif
+
 #define CREATE(result, type, number)  do {\
 	if ((number) * sizeof(type) <= 0)	\
 		log("SYSERR: Zero bytes or less requested at %s:%d.", __FILE__, __LINE__);	\
 	if (!((result) = (type *) calloc ((number), sizeof(type))))	\
-		{ perror("SYSERR: malloc failure"); abort(); } } while(0)
+		{ perror("SYSERR: malloc failure"); abort(); }	\
+	MEM_TRACK((result), (number) * sizeof(type)); } while(0)
 
 #define RECREATE(result,type,number) do {\
+  mem_untrack(result);	\
   if (!((result) = (type *) realloc ((result), sizeof(type) * (number))))\
-		{ perror("SYSERR: realloc failure"); abort(); } } while(0)
+		{ perror("SYSERR: realloc failure"); abort(); }	\
+  MEM_TRACK((result), sizeof(type) * (number)); } while(0)
+
+/*
+ * Structures the game makes and throws away all the time come from their
+ * own pools (see slab.c).  SLAB_CREATE hands back zeroed memory just like
+ * CREATE(result, type, 1); it must be released with SLAB_FREE, not free().
+ */
+#define SLAB_CHAR	0	/* struct char_data	*/
+#define SLAB_OBJ	1	/* struct obj_data	*/
+#define SLAB_AFFECT	2	/* struct affected_type	*/
+#define SLAB_EVENT	3	/* struct event		*/
+#define SLAB_TXT	4	/* struct txt_block	*/
+#define SLAB_TRIG	5	/* struct trig_data	*/
+#define SLAB_TRIG_VAR	6	/* struct trig_var_data	*/
+#define NUM_SLABS	7
+
+#define SLAB_CREATE(result, type, slab) \
+	((result) = (type *) slab_alloc((slab), sizeof(type)))
+#define SLAB_FREE(ptr)	slab_free(ptr)
 
 /*
  * the source previously used the same code in many places to remove an item
@@ -206,10 +307,10 @@ void	update_pos(struct char_data *victim);
 #define CHECK_PLAYER_SPECIAL(ch, var)	(var)
 #endif
 
-#define MOB_FLAGS(ch)	((ch)->char_specials.saved.act)
-#define PLR_FLAGS(ch)	((ch)->char_specials.saved.act)
+#define MOB_FLAGS(ch)	(hot_act[(ch)->hot])
+#define PLR_FLAGS(ch)	(hot_act[(ch)->hot])
 #define PRF_FLAGS(ch) CHECK_PLAYER_SPECIAL((ch), ((ch)->player_specials->saved.pref))
-#define AFF_FLAGS(ch)	((ch)->char_specials.saved.affected_by)
+#define AFF_FLAGS(ch)	(hot_affected_by[(ch)->hot])
 #define ROOM_FLAGS(loc)	(world[(loc)].room_flags)
 #define SPELL_ROUTINES(spl)	(spell_info[spl].routines)
 
@@ -260,7 +361,7 @@ void	update_pos(struct char_data *victim);
 /* char utils ************************************************************/
 
 
-#define IN_ROOM(ch)	((ch)->in_room)
+#define IN_ROOM(ch)	(hot_in_room[(ch)->hot])
 #define GET_WAS_IN(ch)	((ch)->was_in_room)
 #define GET_AGE(ch)     (age(ch)->year)
 
@@ -297,9 +398,9 @@ void	update_pos(struct char_data *victim);
 #define GET_EXP(ch)	      ((ch)->points.exp)
 #define GET_AC(ch)        ((ch)->points.armor)      //The armor rating
 #define GET_EVASION(ch)   ((ch)->points.evasion)    //Percent chance to evade.
-#define GET_HIT(ch)	      ((ch)->points.hit)
+#define GET_HIT(ch)	      (hot_hit[(ch)->hot])
 #define GET_MAX_HIT(ch)	  ((ch)->points.max_hit)
-#define GET_MANA(ch)	    ((ch)->points.mana)
+#define GET_MANA(ch)	    (hot_mana[(ch)->hot])
 #define GET_MAX_MANA(ch)  ((ch)->points.max_mana)
 #define GET_GOLD(ch)	    ((ch)->points.gold)
 #define GET_BANK_GOLD(ch) ((ch)->points.bank_gold)
@@ -309,13 +410,14 @@ void	update_pos(struct char_data *victim);
 #define GET_AMMO(ch)      ((ch)->points.ammo)
 #define GET_MAX_AMMO(ch)  ((ch)->points.max_ammo)
 
-#define GET_POS(ch)	  ((ch)->char_specials.position)
+#define GET_POS(ch)	  (hot_position[(ch)->hot])
 #define GET_IDNUM(ch)	  ((ch)->char_specials.saved.idnum)
 #define GET_ID(x)         ((x)->id)
 #define IS_CARRYING_W(ch) ((ch)->char_specials.carry_weight)
 #define IS_CARRYING_N(ch) ((ch)->char_specials.carry_items)
 #define FIGHTING(ch)	  ((ch)->char_specials.fighting)
-#define HUNTING(ch)	  ((ch)->char_specials.hunting)
+#define HUNTING(ch)	  (deref_char((ch)->char_specials.hunting))
+#define SET_HUNTING(ch, vict) ((ch)->char_specials.hunting = ref_char(vict))
 #define GET_SAVE(ch, i)	  ((ch)->char_specials.saved.apply_saving_throw[i])
 #define GET_ALIGNMENT(ch) ((ch)->char_specials.saved.alignment)
 
@@ -339,7 +441,8 @@ void	update_pos(struct char_data *victim);
 
 
 #define GET_SKILL(ch, i)	CHECK_PLAYER_SPECIAL((ch), ((ch)->player_specials->saved.skills[i]))
-#define SET_SKILL(ch, i, pct)	do { CHECK_PLAYER_SPECIAL((ch), (ch)->player_specials->saved.skills[i]) = pct; } while(0)
+#define SET_SKILL(ch, i, pct)	do { CHECK_PLAYER_SPECIAL((ch), (ch)->player_specials->saved.skills[i]) = pct; \
+				     (ch)->combat.valid = FALSE; } while(0)
 
 #define GET_EQ(ch, i)		((ch)->equipment[i])
 
@@ -372,10 +475,10 @@ void	update_pos(struct char_data *victim);
 
 /* These three deprecated. */
 #define WAIT_STATE(ch, cycle) do { GET_WAIT_STATE(ch) = (cycle); } while(0)
-#define CHECK_WAIT(ch)                ((ch)->wait > 0)
+#define CHECK_WAIT(ch)                (GET_WAIT_STATE(ch) > 0)
 #define GET_MOB_WAIT(ch)      GET_WAIT_STATE(ch)
 /* New, preferred macro. */
-#define GET_WAIT_STATE(ch)    ((ch)->wait)
+#define GET_WAIT_STATE(ch)    (hot_wait[(ch)->hot])
 
 
 /* descriptor-based utils ************************************************/
@@ -413,8 +516,9 @@ void	update_pos(struct char_data *victim);
 #define GET_OBJ_WEAR(obj)	((obj)->obj_flags.wear_flags)
 #define GET_OBJ_VAL(obj, val)	((obj)->obj_flags.value[(val)])
 #define GET_OBJ_WEIGHT(obj)	((obj)->obj_flags.weight)
-#define GET_OBJ_TIMER(obj)	((obj)->obj_flags.timer)
+#define GET_OBJ_TIMER(obj)	(obj_timer_left(obj))	/* set_obj_timer() */
 #define GET_OBJ_RNUM(obj)	((obj)->item_number)
+#define OBJ_IN_ROOM(obj)	((obj)->in_room)
 #define GET_OBJ_VNUM(obj)	(VALID_OBJ_RNUM(obj) ? \
 				obj_index[GET_OBJ_RNUM(obj)].vnum : NOTHING)
 #define GET_OBJ_SPEC(obj)	(VALID_OBJ_RNUM(obj) ? \
@@ -614,6 +718,15 @@ void	update_pos(struct char_data *victim);
 #define CONFIG_MAX_BAD_PWS      config_info.operation.max_bad_pws
 #define CONFIG_SITEOK_ALL       config_info.operation.siteok_everyone
 #define CONFIG_OLC_SAVE         config_info.operation.auto_save_olc
+#define CONFIG_SCRIPT_BUDGET    config_info.operation.script_budget
+#define CONFIG_MEM_SAMPLE_RATE  config_info.operation.mem_sample_rate
+#define CONFIG_ZONE_RESET_BUDGET config_info.operation.zone_reset_budget
+#define CONFIG_DORMANT_MOB_PULSES config_info.operation.dormant_mob_pulses
+#define CONFIG_HIBERNATE_MINUTES config_info.operation.hibernate_minutes
+#define CONFIG_INPUT_BYTE_RATE  config_info.operation.input_byte_rate
+#define CONFIG_INPUT_LINE_RATE  config_info.operation.input_line_rate
+#define CONFIG_INPUT_QUEUE_LINES config_info.operation.input_queue_lines
+#define CONFIG_INPUT_OVERFLOW   config_info.operation.input_overflow
 #define CONFIG_NEW_SOCIALS      config_info.operation.use_new_socials
 #define CONFIG_NS_IS_SLOW       config_info.operation.nameserver_is_slow
 #define CONFIG_DFLT_DIR         config_info.operation.DFLT_DIR
@@ -177,7 +177,7 @@ mudlog(BRF, LVL_IMPL, TRUE, "OLC: %s tried to edit zone %d allowed zone %d",
     /**************************************************************************/
     /** Save the zone information to the zone file.                          **/
     /**************************************************************************/
-    save_zone(OLC_ZNUM(d));
+    queue_olc_save(OLC_ZNUM(d), SL_ZON);
     
     /**************************************************************************/
     /** Free the descriptor's OLC structure.                                 **/
@@ -230,6 +230,7 @@ void zedit_setup(struct descriptor_data *d, int room_num)
   zone->bot = zone_table[OLC_ZNUM(d)].bot;
   zone->top = zone_table[OLC_ZNUM(d)].top;
   zone->reset_mode = zone_table[OLC_ZNUM(d)].reset_mode;
+  zone->zone_flags = zone_table[OLC_ZNUM(d)].zone_flags;
   /*
    * The remaining fields are used as a 'has been modified' flag  
    */
@@ -386,6 +387,10 @@ void zedit_save_internally(struct descriptor_data *d)
     zone_table[OLC_ZNUM(d)].top = OLC_ZONE(d)->top;
     zone_table[OLC_ZNUM(d)].reset_mode = OLC_ZONE(d)->reset_mode;
     zone_table[OLC_ZNUM(d)].lifespan = OLC_ZONE(d)->lifespan;
+    zone_table[OLC_ZNUM(d)].zone_flags = OLC_ZONE(d)->zone_flags;
+    schedule_zone_reset(OLC_ZNUM(d));
+    if (ZONE_FLAGGED(OLC_ZNUM(d), ZONE_ALWAYS_ACTIVE))
+      wake_zone(OLC_ZNUM(d));
   }
   add_to_save_list(zone_table[OLC_ZNUM(d)].number, SL_ZON);
 }
@@ -394,7 +399,7 @@ void zedit_save_internally(struct descriptor_data *d)
 
 void zedit_save_to_disk(int zone)
 {
-  save_zone(zone);
+  queue_olc_save(zone, SL_ZON);
 }
 
 /*-------------------------------------------------------------------*/
@@ -440,6 +445,7 @@ void zedit_disp_menu(struct descriptor_data *d)
 	  "%sB%s) Bottom of zone : %s%d\r\n"
 	  "%sT%s) Top of zone    : %s%d\r\n"
 	  "%sR%s) Reset Mode     : %s%s%s\r\n"
+	  "%sA%s) Always active  : %s%s%s\r\n"
 	  "[Command list]\r\n",
 
 	  cyn, OLC_NUM(d), nrm,
@@ -452,7 +458,10 @@ void zedit_disp_menu(struct descriptor_data *d)
 	  grn, nrm,
           yel,
           OLC_ZONE(d)->reset_mode ? ((OLC_ZONE(d)->reset_mode == 1) ? "Reset when no players are in zone." : "Normal reset.") : "Never reset",
-          nrm
+          nrm,
+	  grn, nrm, yel,
+	  IS_SET(OLC_ZONE(d)->zone_flags, ZONE_ALWAYS_ACTIVE) ? "Yes, mobs act with no players here." : "No",
+	  nrm
 	  );
 
   /*
@@ -871,6 +880,15 @@ void zedit_parse(struct descriptor_data *d, char *arg)
 		"Enter new zone reset type : ");
       OLC_MODE(d) = ZEDIT_ZONE_RESET;
       break;
+    case 'a':
+    case 'A':
+      /*
+       * Toggle whether mobs keep acting with no players in the zone.
+       */
+      TOGGLE_BIT(OLC_ZONE(d)->zone_flags, ZONE_ALWAYS_ACTIVE);
+      OLC_ZONE(d)->number = 1;
+      zedit_disp_menu(d);
+      break;
     default:
       zedit_disp_menu(d);
       break;